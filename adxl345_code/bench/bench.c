@@ -0,0 +1,420 @@
+/**
+ * @file bench.c
+ * @author Jose Luis Figueroa
+ * @brief The acquisition benchmark. Each acquisition strategy of the
+ * driver is run at each output data rate until a fixed number of samples
+ * reaches the sink, and the same metrics are taken for every run:
+ * - CPU cycles per sample, the cycles not spent in WFI over the samples.
+ * - Bus utilization, the SPI wire time of the frames over the run time.
+ * - Worst data ready to buffer latency, from the moment a sample was ready
+ *   to the sink receiving it. The ready time is worked back from the 
+ *   FIFO_STATUS read that sized the drain, one ODR period per FIFO 
+ *   position, so it is late by less than one period.
+ * - Samples dropped, the samples due at the ODR over the run minus the
+ *   samples received and the samples still held by the FIFO.
+ * Every time is taken from the DWT cycle counter, which the host build
+ * backs with the simulated clock, so the same code measures the board and
+ * the simulator. The results are kept in BenchResults for the debugger and
+ * printed on the host, along with the exact figures of the device model.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <adxl345.h>
+#include <clock.h>
+#include <sensors.h>
+#ifdef SIM_HOST
+#include <stdlib.h>
+#include "sim_adxl345.h"
+#endif
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Samples each run collects*/
+#define BENCH_SAMPLES       (256U)
+/** A run gives up after this many times its nominal duration*/
+#define BENCH_TIMEOUT       (4U)
+/** Bits of each SPI frame*/
+#define BENCH_FRAME_BITS    (8U)
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines the acquisition strategies under test. Polling drains the FIFO
+ * in a busy loop, interrupt sleeps until INT1 and drains it with blocking
+ * reads, DMA sleeps until INT1 and drains it from the DMA interrupts.
+ */
+typedef enum
+{
+    BENCH_POLLING,          /**< SENSORS_poll in a busy loop */
+    BENCH_INTERRUPT,        /**< SENSORS_poll on INT1 */
+    BENCH_DMA,              /**< SENSORS_start on INT1, SENSORS_collect */
+    BENCH_MAX_MODE          /**< Maximum strategy */
+}BenchMode_t;
+
+/**
+ * Defines the metrics of a run.
+ */
+typedef struct
+{
+    uint32_t odrHz;             /**< Output data rate of the run */
+    uint32_t samples;           /**< Samples received by the sink */
+    uint32_t elapsed;           /**< Run time in cycles */
+    uint32_t cyclesPerSample;   /**< CPU cycles not spent in WFI per sample */
+    uint32_t busPermille;       /**< SPI wire time over run time, in 0.1 % */
+    uint32_t latencyMax;        /**< Worst sample ready to sink, in cycles */
+    uint32_t dropped;           /**< Samples lost by the strategy */
+}BenchResult_t;
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Output data rates under test*/
+static const Adxl345Odr_t benchOdr[] =
+{
+    ADXL345_ODR_100HZ, ADXL345_ODR_400HZ, ADXL345_ODR_800HZ,
+    ADXL345_ODR_1600HZ, ADXL345_ODR_3200HZ
+};
+#define BENCH_ODRS          (sizeof(benchOdr) / sizeof(benchOdr[0]))
+
+/** Strategy names*/
+static const char * const benchName[BENCH_MAX_MODE] =
+{
+    "polling", "interrupt", "dma"
+};
+
+/** Results, read with the debugger on the board*/
+BenchResult_t BenchResults[BENCH_MAX_MODE][BENCH_ODRS];
+
+#ifdef SIM_HOST
+/** Exact figures of the device model for each run*/
+static SimAdxl345Stats_t benchModel[BENCH_MAX_MODE][BENCH_ODRS];
+#endif
+
+/** Device table of the run, the first row of the sensors table at the ODR
+ * under test*/
+static Adxl345Config_t benchConfig[1];
+
+/** INT1 edge waiting for a drain*/
+static volatile uint8_t dataReady;
+
+/** Sink counters of the run*/
+static uint32_t received;
+static uint32_t latencyMax;
+
+/** Output data rate period of the run, in cycles*/
+static uint32_t samplePeriod;
+
+/** Cycles spent asleep during the run*/
+static uint32_t slept;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void BENCH_run(BenchMode_t Mode, uint8_t odr);
+static void BENCH_sleep(void);
+static void BENCH_int1Event(DioPin_t Line, uint32_t timestamp);
+static void BENCH_sink(uint8_t Device, const Adxl345Sample_t * const Samples,
+uint8_t count);
+#ifdef SIM_HOST
+static void BENCH_print(void);
+#endif
+
+int main(void)
+{
+    /*Run the core and the buses at 80 MHz from the PLL*/
+    CLOCK_init();
+
+    /*Enable clock access to GPIOA, DMA2, SPI1 and SYSCFG*/
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN | RCC_APB2ENR_SYSCFGEN;
+    DIO_imageApply(DIO_imageGet(), DIO_imageSizeGet());
+    SPI_init(SPI_ConfigGet(), SPI_configSizeGet());
+
+#ifdef SIM_HOST
+    /*The device model takes the place of the board ADXL345*/
+    const SimAdxl345Config_t Sensor =
+    {
+        .Channel = SPI_CHANNEL1,
+        .CsPort = SIM_NSS,
+        .CsPin = 0U,
+        .Int1Port = 0U,
+        .Int1Pin = 0U,
+        .Int2Port = SIM_ADXL345_NC,
+        .Int2Pin = 0U,
+        .Waveform = NULL,
+        .context = NULL
+    };
+    SIM_adxl345Attach(0U, &Sensor);
+#endif
+
+    /*Timestamp the INT1 rising edges, this also starts CYCCNT*/
+    const DioPinConfig_t Int1Line =
+    {
+        .Port = DIO_PA,
+        .Pin = DIO_PA0
+    };
+    DIO_interruptEnable(&Int1Line, DIO_EDGE_RISING, BENCH_int1Event);
+
+    for(uint8_t mode = 0; mode < BENCH_MAX_MODE; mode++)
+    {
+        for(uint8_t odr = 0; odr < BENCH_ODRS; odr++)
+        {
+            BENCH_run((BenchMode_t)mode, odr);
+        }
+    }
+
+#ifdef SIM_HOST
+    BENCH_print();
+    return EXIT_SUCCESS;
+#else
+    while(1)
+    {
+    }
+#endif
+}
+
+/*****************************************************************************
+ * Function: BENCH_run()
+*//**
+*\b Description:
+ * This function is used to run one strategy at one output data rate. The
+ * device is set up from the first row of the sensors table, its FIFO is
+ * emptied, then the strategy runs until BENCH_SAMPLES samples reach the
+ * sink. The interrupt driven strategies wake on the watermark of the 
+ * table.
+ *
+ * @param[in]   Mode is the strategy.
+ * @param[in]   odr is the index of the output data rate in benchOdr.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void BENCH_run(BenchMode_t Mode, uint8_t odr)
+{
+    BenchResult_t * const Result = &BenchResults[Mode][odr];
+    const Adxl345Odr_t Odr = benchOdr[odr];
+    const DioPinConfig_t Int1Line =
+    {
+        .Port = DIO_PA,
+        .Pin = DIO_PA0
+    };
+    Adxl345Sample_t Samples[FIFO_MAX_ENTRIES];
+
+    benchConfig[0] = *SENSORS_configGet();
+    benchConfig[0].Odr = Odr;
+    while(SENSORS_init(benchConfig, 1U) != SPI_OK)
+    {
+    }
+
+    /*Start from an empty FIFO*/
+    while(ADXL345_readSamples(&benchConfig[0], Samples, FIFO_MAX_ENTRIES) > 0U)
+    {
+    }
+
+    const uint32_t hclk = CLOCK_hclkGet();
+    const uint32_t odrMilliHz = ADXL345_odrGet(Odr);
+    const uint64_t period = ((uint64_t)hclk * 1000U) / odrMilliHz;
+    const uint64_t timeout = period * BENCH_SAMPLES * BENCH_TIMEOUT;
+
+    dataReady = 0;
+    samplePeriod = (uint32_t)period;
+    received = 0;
+    latencyMax = 0;
+    slept = 0;
+    SENSORS_statsReset();
+#ifdef SIM_HOST
+    SIM_adxl345StatsReset(0U);
+#endif
+    const uint32_t start = DWT->CYCCNT;
+
+    while((received < BENCH_SAMPLES) &&
+    ((uint32_t)(DWT->CYCCNT - start) < timeout))
+    {
+        if(Mode == BENCH_POLLING)
+        {
+            SENSORS_poll(BENCH_sink);
+            continue;
+        }
+
+        BENCH_sleep();
+
+        if(Mode == BENCH_INTERRUPT)
+        {
+            if(dataReady || (DIO_pinRead(&Int1Line) == DIO_HIGH))
+            {
+                dataReady = 0;
+                SENSORS_poll(BENCH_sink);
+            }
+            continue;
+        }
+
+        /*Stop once collected, so no read is left in flight*/
+        SENSORS_collect(BENCH_sink);
+        if(received >= BENCH_SAMPLES)
+        {
+            break;
+        }
+        if(dataReady || (DIO_pinRead(&Int1Line) == DIO_HIGH))
+        {
+            dataReady = 0;
+            SENSORS_start();
+        }
+    }
+
+    const uint32_t elapsed = DWT->CYCCNT - start;
+#ifdef SIM_HOST
+    benchModel[Mode][odr] = SIM_adxl345StatsGet(0U);
+#endif
+
+    /*Let a read left in flight by a timeout complete*/
+    while(!SENSORS_busAcquire(benchConfig[0].Channel, 0U))
+    {
+        BENCH_sleep();
+        SENSORS_collect(BENCH_sink);
+    }
+    SENSORS_busRelease(benchConfig[0].Channel, 0U);
+
+    const uint32_t held = ADXL345_fifoEntriesGet(&benchConfig[0]);
+    const uint32_t due = (uint32_t)(elapsed / period);
+    const uint64_t wire = (uint64_t)SENSORS_statsGet()->
+    busFrames[benchConfig[0].Channel] * BENCH_FRAME_BITS * hclk /
+    SPI_bitRateGet(benchConfig[0].Channel);
+
+    Result->odrHz = odrMilliHz / 1000U;
+    Result->samples = received;
+    Result->elapsed = elapsed;
+    Result->cyclesPerSample = (received > 0U) ? ((elapsed - slept) / received) :
+    0U;
+    Result->busPermille = (elapsed > 0U) ? (uint32_t)((wire * 1000U) /
+    elapsed) : 0U;
+    Result->latencyMax = latencyMax;
+    Result->dropped = (due > (received + held)) ? (due - received - held) :
+    0U;
+}
+
+/*****************************************************************************
+ * Function: BENCH_sleep()
+*//**
+*\b Description:
+ * This function is used to sleep until INT1 fires or a DMA acquisition
+ * completes, and to account the cycles spent asleep. The check runs with
+ * interrupts masked so an event between the test and WFI still wakes the
+ * core.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void BENCH_sleep(void)
+{
+    __disable_irq();
+    if(!dataReady && (SENSORS_readyGet() == 0U))
+    {
+        const uint32_t sleepStart = DWT->CYCCNT;
+        __WFI();
+        slept += DWT->CYCCNT - sleepStart;
+    }
+    __enable_irq();
+}
+
+/*****************************************************************************
+ * Function: BENCH_int1Event()
+*//**
+*\b Description:
+ * This function is called from the EXTI interrupt on the rising edge of
+ * INT1 to wake the drain.
+ *
+ * @param[in]   Line is not used.
+ * @param[in]   timestamp is not used.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void BENCH_int1Event(DioPin_t Line, uint32_t timestamp)
+{
+    (void)Line;
+    (void)timestamp;
+
+    dataReady = 1;
+}
+
+/*****************************************************************************
+ * Function: BENCH_sink()
+*//**
+*\b Description:
+ * This function receives the samples of the run and takes the latency of
+ * the oldest sample of the block, the one that waited the longest: it was
+ * ready count - 1 periods before the newest one, which was ready by the 
+ * FIFO_STATUS read of the drain.
+ *
+ * @param[in]   Device is the device drained.
+ * @param[in]   Samples is not used.
+ * @param[in]   count is the number of samples.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void BENCH_sink(uint8_t Device, const Adxl345Sample_t * const Samples,
+uint8_t count)
+{
+    (void)Samples;
+
+    const uint32_t latency = DWT->CYCCNT - SENSORS_drainStampGet(Device) +
+    ((uint32_t)(count - 1U) * samplePeriod);
+    if(latency > latencyMax)
+    {
+        latencyMax = latency;
+    }
+
+    received += count;
+}
+
+#ifdef SIM_HOST
+/*****************************************************************************
+ * Function: BENCH_print()
+*//**
+*\b Description:
+ * This function is used to print the results on the host. The last three
+ * columns are the exact figures of the device model for the same run: the
+ * worst age of a sample when it was read, the samples it dropped and the
+ * reads started before the FIFO finished popping.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void BENCH_print(void)
+{
+    const double cyclesPerUs = (double)CLOCK_hclkGet() / 1e6;
+
+    printf("%-10s %5s %7s %9s %6s %11s %7s %11s %7s %6s\n", "mode", "ODR",
+    "samples", "cyc/smp", "bus %", "latency us", "dropped", "model age",
+    "model", "early");
+    for(uint8_t mode = 0; mode < BENCH_MAX_MODE; mode++)
+    {
+        for(uint8_t odr = 0; odr < BENCH_ODRS; odr++)
+        {
+            const BenchResult_t * const Result = &BenchResults[mode][odr];
+            const SimAdxl345Stats_t * const Model = &benchModel[mode][odr];
+
+            printf("%-10s %5lu %7lu %9lu %6.1f %11.1f %7lu %11.1f %7lu "
+            "%6lu\n",
+            benchName[mode], (unsigned long)Result->odrHz,
+            (unsigned long)Result->samples,
+            (unsigned long)Result->cyclesPerSample,
+            (double)Result->busPermille / 10.0,
+            (double)Result->latencyMax / cyclesPerUs,
+            (unsigned long)Result->dropped,
+            (double)Model->latencyMax / cyclesPerUs,
+            (unsigned long)Model->dropped,
+            (unsigned long)Model->earlyReads);
+        }
+    }
+}
+#endif
@@ -0,0 +1,238 @@
+/**
+ * @file scale_bench.c
+ * @author Jose Luis Figueroa
+ * @brief The scaling benchmark of the host. The float, Q15 and Q31 block
+ * kernels of scale.c are timed against the per-sample double conversion
+ * they replaced, on FIFO sized blocks of samples that sweep the raw range.
+ * Each kernel is run over the same blocks for a fixed number of rounds
+ * and reported in ns per sample, with the worst difference from the
+ * double conversion in g. The host has no Cortex-M4 FPU, so the figures
+ * compare the kernels with each other, not with the board.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "scale.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Axes in one sample*/
+#define AXES                (3U)
+/** Blocks of FIFO_MAX_ENTRIES samples converted each round*/
+#define BLOCKS              (64U)
+/** Rounds each kernel is timed over*/
+#define ROUNDS              (20000U)
+/** Samples of the working set*/
+#define SAMPLES             (BLOCKS * FIFO_MAX_ENTRIES)
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines the kernels under test.
+ */
+typedef enum
+{
+    KERNEL_DOUBLE,          /**< Per-sample double multiply */
+    KERNEL_FLOAT,           /**< SCALE_toFloat */
+    KERNEL_Q15,             /**< SCALE_toQ15 */
+    KERNEL_Q31,             /**< SCALE_toQ31 */
+    KERNEL_MAX
+}Kernel_t;
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Kernel names*/
+static const char * const kernelName[KERNEL_MAX] =
+{
+    "double", "float", "q15", "q31"
+};
+
+/** Raw samples and the output of each kernel*/
+static Adxl345Sample_t samples[SAMPLES];
+static double outDouble[SAMPLES * AXES];
+static float outFloat[SAMPLES * AXES];
+static int16_t outQ15[SAMPLES * AXES];
+static int32_t outQ31[SAMPLES * AXES];
+
+/** Read after each round so the conversions are not optimized out*/
+static volatile int32_t sink;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void BENCH_convert(Kernel_t Kernel, Adxl345Range_t Range,
+Adxl345Resolution_t Resolution);
+static double BENCH_error(Kernel_t Kernel);
+static double BENCH_now(void);
+
+int main(void)
+{
+    /*Full resolution at +-16 g has the widest raw range, 13 bits*/
+    const Adxl345Range_t Range = ADXL345_RANGE_16G;
+    const Adxl345Resolution_t Resolution = ADXL345_FULL_RES;
+
+    for(uint32_t i = 0; i < SAMPLES; i++)
+    {
+        samples[i].x = (int16_t)((int32_t)((i * 7U) % 8192U) - 4096);
+        samples[i].y = (int16_t)((int32_t)((i * 13U) % 8192U) - 4096);
+        samples[i].z = (int16_t)((int32_t)((i * 29U) % 8192U) - 4096);
+    }
+
+    printf("%u blocks of %u samples, %u rounds, +-16 g full resolution\n",
+    (unsigned)BLOCKS, (unsigned)FIFO_MAX_ENTRIES, (unsigned)ROUNDS);
+    printf("%-8s %12s %10s %14s\n", "kernel", "ns/sample", "speedup",
+    "max error g");
+
+    double reference = 0.0;
+    for(uint8_t kernel = 0; kernel < KERNEL_MAX; kernel++)
+    {
+        const double start = BENCH_now();
+        for(uint32_t round = 0; round < ROUNDS; round++)
+        {
+            BENCH_convert((Kernel_t)kernel, Range, Resolution);
+        }
+        const double perSample = (BENCH_now() - start) /
+        ((double)ROUNDS * SAMPLES);
+
+        if(kernel == KERNEL_DOUBLE)
+        {
+            reference = perSample;
+        }
+
+        /*Compare with the double conversion of the last round*/
+        BENCH_convert(KERNEL_DOUBLE, Range, Resolution);
+        printf("%-8s %12.3f %9.2fx %14.3g\n", kernelName[kernel], perSample,
+        reference / perSample, BENCH_error((Kernel_t)kernel));
+    }
+
+    return EXIT_SUCCESS;
+}
+
+/*****************************************************************************
+ * Function: BENCH_convert()
+*//**
+*\b Description:
+ * This function is used to convert the working set with one kernel, block
+ * by block as the sink of the acquisition receives it.
+ *
+ * @param[in]   Kernel is the kernel to run.
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void BENCH_convert(Kernel_t Kernel, Adxl345Range_t Range,
+Adxl345Resolution_t Resolution)
+{
+    for(uint32_t block = 0; block < SAMPLES; block += FIFO_MAX_ENTRIES)
+    {
+        const Adxl345Sample_t * const Block = &samples[block];
+        const size_t first = block * AXES;
+        const double factor = (double)SCALE_factorGet(Range, Resolution);
+
+        switch(Kernel)
+        {
+            case KERNEL_DOUBLE:
+                /*The conversion the main loop made before the kernels*/
+                for(uint32_t i = 0; i < FIFO_MAX_ENTRIES; i++)
+                {
+                    outDouble[first + (i * AXES)] = Block[i].x * factor;
+                    outDouble[first + (i * AXES) + 1U] = Block[i].y * factor;
+                    outDouble[first + (i * AXES) + 2U] = Block[i].z * factor;
+                }
+                sink = (int32_t)outDouble[first];
+                break;
+            case KERNEL_FLOAT:
+                SCALE_toFloat(Block, &outFloat[first], FIFO_MAX_ENTRIES,
+                Range, Resolution);
+                sink = (int32_t)outFloat[first];
+                break;
+            case KERNEL_Q15:
+                SCALE_toQ15(Block, &outQ15[first], FIFO_MAX_ENTRIES, Range,
+                Resolution);
+                sink = outQ15[first];
+                break;
+            case KERNEL_Q31:
+                SCALE_toQ31(Block, &outQ31[first], FIFO_MAX_ENTRIES, Range,
+                Resolution);
+                sink = outQ31[first];
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: BENCH_error()
+*//**
+*\b Description:
+ * This function is used to get the worst difference between the output of
+ * a kernel and the double conversion, in g.
+ *
+ * @param[in]   Kernel is the kernel checked.
+ *
+ * @return  The largest absolute difference in g.
+ *
+*****************************************************************************/
+static double BENCH_error(Kernel_t Kernel)
+{
+    const double q15G = (double)SCALE_FULL_SCALE_G / 32768.0;
+    const double q31G = (double)SCALE_FULL_SCALE_G / 2147483648.0;
+    double worst = 0.0;
+
+    for(uint32_t i = 0; i < (SAMPLES * AXES); i++)
+    {
+        double value = outDouble[i];
+
+        if(Kernel == KERNEL_FLOAT)
+        {
+            value = outFloat[i];
+        }
+        else if(Kernel == KERNEL_Q15)
+        {
+            value = outQ15[i] * q15G;
+        }
+        else if(Kernel == KERNEL_Q31)
+        {
+            value = outQ31[i] * q31G;
+        }
+
+        if(fabs(value - outDouble[i]) > worst)
+        {
+            worst = fabs(value - outDouble[i]);
+        }
+    }
+
+    return worst;
+}
+
+/*****************************************************************************
+ * Function: BENCH_now()
+*//**
+*\b Description:
+ * This function is used to read the host monotonic clock.
+ *
+ * @return  The time in ns.
+ *
+*****************************************************************************/
+static double BENCH_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((double)now.tv_sec * 1e9) + (double)now.tv_nsec;
+}
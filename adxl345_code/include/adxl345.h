@@ -22,31 +22,210 @@
 /*****************************************************************************
 * Configuration Constants
 *****************************************************************************/
+/*Number of devices the driver keeps a register shadow for*/
+#define ADXL345_DEVICES_NUMBER  (4U)
+
+/*Highest SPI clock the ADXL345 accepts, in Hz*/
+#define ADXL345_SPI_CLOCK_MAX   (5000000UL)
+
 /*adxl345 registers*/
 #define DEVID_R             (0x00)
+#define THRESH_TAP_R        (0x1D)
+#define TAP_AXES_R          (0x2A)
+#define BW_RATE_R           (0x2C)
 #define POWER_CTL_R         (0x2D)
+#define INT_ENABLE_R        (0x2E)
+#define INT_MAP_R           (0x2F)
+#define INT_SOURCE_R        (0x30)
 #define DATA_FORMAT_R       (0x31)
 #define DATA_START_R        (0x32)
+#define FIFO_CTL_R          (0x38)
+#define FIFO_STATUS_R       (0x39)
+#define REGISTER_MAP_SIZE   (0x3A)
 
 /*Constants*/
 #define RESET               (0x00)
 #define FOUR_G              (0x01)
+#define FULL_RES            (0x08)
+#define LOW_POWER           (0x10)
 #define SET_MEASURE         (0x08)
 #define MULTI_BYTE_EN       (0x40)
 #define DEVICE_ADDR         (0x53)
 #define READ_OPERATION      (0x80)
-#define FOUR_G_SCALE_FACTOR (0.0078)
+#define FOUR_G_SCALE_FACTOR (0.0078125f)
+
+/*Interrupt sources (INT_ENABLE, INT_MAP and INT_SOURCE bits)*/
+#define INT_DATA_READY      (0x80)          /**< New sample available */
+#define INT_SINGLE_TAP      (0x40)          /**< Single tap detected */
+#define INT_DOUBLE_TAP      (0x20)          /**< Double tap detected */
+#define INT_ACTIVITY        (0x10)          /**< Activity detected */
+#define INT_INACTIVITY      (0x08)          /**< Inactivity detected */
+#define INT_FREE_FALL       (0x04)          /**< Free fall detected */
+#define INT_WATERMARK       (0x02)          /**< FIFO reached watermark */
+#define INT_OVERRUN         (0x01)          /**< Sample overwritten */
+
+/*FIFO constants*/
+#define FIFO_MODE_POS       (6U)            /**< FIFO_CTL mode field */
+#define FIFO_TRIGGER_INT2   (0x20)          /**< Trigger event on INT2 */
+#define FIFO_SAMPLES_MASK   (0x1F)          /**< FIFO_CTL watermark field */
+#define FIFO_ENTRIES_MASK   (0x3F)          /**< FIFO_STATUS entries field */
+#define FIFO_TRIG_FLAG      (0x80)          /**< FIFO_STATUS trigger flag */
+#define FIFO_DEPTH          (32U)           /**< Samples held by the FIFO */
+#define FIFO_MAX_ENTRIES    (FIFO_DEPTH + 1U) /**< FIFO plus output regs */
+#define AXIS_BYTES          (6U)            /**< DATAX0 to DATAZ1 */
+
+/*Configuration burst constants*/
+#define EVENT_BLOCK_SIZE    (TAP_AXES_R - THRESH_TAP_R + 1U)
+#define RATE_BLOCK_SIZE     (INT_MAP_R - BW_RATE_R + 1U)
+
+/*Snapshot constants (INT_SOURCE to FIFO_STATUS)*/
+#define SNAPSHOT_START_R    (INT_SOURCE_R)  /**< First register read */
+#define SNAPSHOT_SIZE       (FIFO_STATUS_R - INT_SOURCE_R + 1U)
 
 /*****************************************************************************
 * Typedefs
 *****************************************************************************/
+/**
+ * Defines the FIFO operating modes. Bypass keeps the FIFO empty, FIFO mode
+ * stops collecting once it is full, stream mode keeps the newest 32 samples
+ * and trigger mode freezes the samples around a trigger event.
+ */
+typedef enum
+{
+    ADXL345_FIFO_BYPASS,    /**< FIFO is bypassed */
+    ADXL345_FIFO_FIFO,      /**< Collect up to 32 samples then stop */
+    ADXL345_FIFO_STREAM,    /**< Hold the newest 32 samples */
+    ADXL345_FIFO_TRIGGER,   /**< Hold the samples around a trigger */
+    ADXL345_FIFO_MAX_MODE   /**< Maximum FIFO mode */
+}Adxl345FifoMode_t;
+
+/**
+ * Defines the measurement ranges. The values match the DATA_FORMAT range 
+ * field.
+ */
+typedef enum
+{
+    ADXL345_RANGE_2G,       /**< +-2 g */
+    ADXL345_RANGE_4G,       /**< +-4 g */
+    ADXL345_RANGE_8G,       /**< +-8 g */
+    ADXL345_RANGE_16G,      /**< +-16 g */
+    ADXL345_MAX_RANGE       /**< Maximum range */
+}Adxl345Range_t;
+
+/**
+ * Defines the output data rates. The values match the BW_RATE rate code. 
+ * Low power operation is only available from 12.5 Hz to 400 Hz.
+ */
+typedef enum
+{
+    ADXL345_ODR_0_10HZ,     /**< 0.10 Hz */
+    ADXL345_ODR_0_20HZ,     /**< 0.20 Hz */
+    ADXL345_ODR_0_39HZ,     /**< 0.39 Hz */
+    ADXL345_ODR_0_78HZ,     /**< 0.78 Hz */
+    ADXL345_ODR_1_56HZ,     /**< 1.56 Hz */
+    ADXL345_ODR_3_13HZ,     /**< 3.13 Hz */
+    ADXL345_ODR_6_25HZ,     /**< 6.25 Hz */
+    ADXL345_ODR_12_5HZ,     /**< 12.5 Hz */
+    ADXL345_ODR_25HZ,       /**< 25 Hz */
+    ADXL345_ODR_50HZ,       /**< 50 Hz */
+    ADXL345_ODR_100HZ,      /**< 100 Hz (power-on default) */
+    ADXL345_ODR_200HZ,      /**< 200 Hz */
+    ADXL345_ODR_400HZ,      /**< 400 Hz */
+    ADXL345_ODR_800HZ,      /**< 800 Hz */
+    ADXL345_ODR_1600HZ,     /**< 1600 Hz */
+    ADXL345_ODR_3200HZ,     /**< 3200 Hz */
+    ADXL345_MAX_ODR         /**< Maximum output data rate */
+}Adxl345Odr_t;
+
+/**
+ * Defines the output resolution. 10 bits mode scales the LSB with the 
+ * range, full resolution keeps 256 LSB/g (up to 13 bits at +-16 g).
+ */
+typedef enum
+{
+    ADXL345_10BIT,          /**< 10 bits for every range */
+    ADXL345_FULL_RES,       /**< 4 mg/LSB for every range */
+    ADXL345_MAX_RESOLUTION  /**< Maximum resolution */
+}Adxl345Resolution_t;
+
+/**
+ * Defines the tap, activity, free fall and offset settings. The members 
+ * follow the register map from THRESH_TAP (0x1D) to TAP_AXES (0x2A) so the
+ * block is written in one burst. Zero is the power-on value of each one.
+ */
+typedef struct
+{
+    uint8_t ThreshTap;              /**< THRESH_TAP, 62.5 mg/LSB */
+    int8_t OffsetX;                 /**< OFSX, 15.6 mg/LSB */
+    int8_t OffsetY;                 /**< OFSY, 15.6 mg/LSB */
+    int8_t OffsetZ;                 /**< OFSZ, 15.6 mg/LSB */
+    uint8_t TapDuration;            /**< DUR, 625 us/LSB */
+    uint8_t TapLatency;             /**< Latent, 1.25 ms/LSB */
+    uint8_t TapWindow;              /**< Window, 1.25 ms/LSB */
+    uint8_t ThreshAct;              /**< THRESH_ACT, 62.5 mg/LSB */
+    uint8_t ThreshInact;            /**< THRESH_INACT, 62.5 mg/LSB */
+    uint8_t TimeInact;              /**< TIME_INACT, 1 s/LSB */
+    uint8_t ActInactCtl;            /**< ACT_INACT_CTL axes and coupling */
+    uint8_t ThreshFreeFall;         /**< THRESH_FF, 62.5 mg/LSB */
+    uint8_t TimeFreeFall;           /**< TIME_FF, 5 ms/LSB */
+    uint8_t TapAxes;                /**< TAP_AXES axes and suppress */
+}Adxl345EventConfig_t;
+
 typedef struct
 {
+    uint8_t Device;                 /**< Index below ADXL345_DEVICES_NUMBER */
     SpiChannel_t Channel;           /**< The SPI channel */
     DioPort_t Port;                 /**< The GPIO port */
     DioPin_t Pin;                   /**< The GPIO pin */
+    Adxl345Odr_t Odr;               /**< Output data rate */
+    Adxl345Range_t Range;           /**< +-2, 4, 8 or 16 g */
+    Adxl345Resolution_t Resolution; /**< 10 bits or full resolution */
+    uint8_t LowPower;               /**< Reduced power operation (0 or 1) */
+    Adxl345FifoMode_t FifoMode;     /**< Bypass, FIFO, stream or trigger */
+    uint8_t Watermark;              /**< FIFO samples to raise watermark */
+    uint8_t IntEnable;              /**< INT_* sources to enable */
+    uint8_t IntMap;                 /**< INT_* sources routed to INT2 */
+    Adxl345EventConfig_t Events;    /**< Tap, activity and offset settings */
 }Adxl345Config_t;
 
+/**
+ * Defines one acceleration sample. The record is packed as three 16 bits
+ * values, half the size of the six frames it is decoded from.
+ */
+typedef struct
+{
+    int16_t x;                      /**< X axis raw value */
+    int16_t y;                      /**< Y axis raw value */
+    int16_t z;                      /**< Z axis raw value */
+}Adxl345Sample_t;
+
+/**
+ * Defines the decoded content of INT_SOURCE, DATA_FORMAT, DATAX0 to DATAZ1,
+ * FIFO_CTL and FIFO_STATUS fetched in a single transaction.
+ */
+typedef struct
+{
+    uint8_t intSource;              /**< INT_* sources asserted */
+    uint8_t dataFormat;             /**< DATA_FORMAT register */
+    int16_t x;                      /**< X axis raw value */
+    int16_t y;                      /**< Y axis raw value */
+    int16_t z;                      /**< Z axis raw value */
+    Adxl345FifoMode_t FifoMode;     /**< FIFO mode in use */
+    uint8_t watermark;              /**< FIFO watermark in use */
+    uint8_t fifoEntries;            /**< FIFO entries, may include the sample
+                                         popped by the same burst */
+    uint8_t fifoTriggered;          /**< Trigger event occurred (0 or 1) */
+}Adxl345Snapshot_t;
+
+/**
+ * Defines the function called from interrupt context when a DMA read has 
+ * completed and the chip select has been released. Status is SPI_OK when 
+ * the data buffer holds the registers, otherwise the buffer is left 
+ * untouched and the data read is lost.
+ */
+typedef void (*Adxl345Callback_t)(const Adxl345Config_t * const Config, 
+SpiStatus_t Status);
+
 
 /*****************************************************************************
 * Function Prototypes
@@ -55,9 +234,31 @@ typedef struct
 extern "C"{
 #endif
 
-void ADXL345_init(const Adxl345Config_t * const Config);
-void ADXL345_read(const Adxl345Config_t * const Config, uint16_t address,  
-uint16_t size, uint16_t *data);
+SpiStatus_t ADXL345_init(const Adxl345Config_t * const Config);
+SpiStatus_t ADXL345_configApply(const Adxl345Config_t * const Config);
+void ADXL345_registerSet(const Adxl345Config_t * const Config, 
+uint8_t address, uint8_t value);
+void ADXL345_registerUpdate(const Adxl345Config_t * const Config, 
+uint8_t address, uint8_t mask, uint8_t value);
+uint8_t ADXL345_registerGet(const Adxl345Config_t * const Config, 
+uint8_t address);
+SpiStatus_t ADXL345_flush(const Adxl345Config_t * const Config);
+float ADXL345_scaleFactorGet(const Adxl345Config_t * const Config);
+uint32_t ADXL345_odrGet(Adxl345Odr_t Odr);
+uint32_t ADXL345_minSpiClockGet(Adxl345Odr_t Odr);
+SpiStatus_t ADXL345_read(const Adxl345Config_t * const Config, 
+uint16_t address, uint16_t size, uint16_t *data);
+SpiStatus_t ADXL345_readDma(const Adxl345Config_t * const Config, 
+uint16_t address, uint16_t size, uint16_t *data, Adxl345Callback_t Callback);
+SpiStatus_t ADXL345_readSnapshot(const Adxl345Config_t * const Config,
+Adxl345Snapshot_t * const Snapshot);
+uint8_t ADXL345_interruptSourceGet(const Adxl345Config_t * const Config);
+uint8_t ADXL345_fifoEntriesGet(const Adxl345Config_t * const Config);
+uint8_t ADXL345_readFifo(const Adxl345Config_t * const Config, 
+uint16_t *data, uint8_t maxSamples);
+uint8_t ADXL345_readSamples(const Adxl345Config_t * const Config, 
+Adxl345Sample_t * const Samples, uint8_t maxSamples);
+uint32_t ADXL345_lostSamplesGet(const Adxl345Config_t * const Config);
 
 #ifdef __cplusplus
 }   /*Extern C*/
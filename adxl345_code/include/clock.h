@@ -0,0 +1,67 @@
+/**
+ * @file clock.h
+ * @author Jose Luis Figueroa
+ * @brief The interface definition for the clock configuration. This is the
+ * header file for the bring up of the STM32F401 system clock from the PLL
+ * and for the bus clock frequencies used by the peripherals drivers.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/*****************************************************************************
+* Configuration Constants
+*****************************************************************************/
+/**
+ * Defines the frequency of the internal RC oscillator and of the external
+ * clock. The Nucleo-F401RE feeds HSE with the 8 MHz MCO of the ST-LINK.
+ */
+#define CLOCK_HSI_HZ        (16000000UL)
+#define CLOCK_HSE_HZ        (8000000UL)
+
+/**
+ * Defines the main PLL fed by HSI. VCO input = HSI / M = 2 MHz,
+ * VCO = 2 MHz * N = 320 MHz, SYSCLK = VCO / P = 80 MHz and the 48 MHz
+ * clock = VCO / Q = 45.7 MHz, USB is not used. 80 MHz rather than the
+ * 84 MHz maximum lets PCLK2 / 16 clock SPI1 at the 5 MHz ADXL345 limit,
+ * where 84 MHz falls back to PCLK2 / 32 = 2.625 MHz.
+ */
+#define CLOCK_PLLM          (8U)
+#define CLOCK_PLLN          (160U)
+#define CLOCK_PLLP          (4U)
+#define CLOCK_PLLQ          (7U)
+
+/**
+ * Defines the system clock reached by CLOCK_init.
+ */
+#define CLOCK_SYSCLK_HZ     \
+((CLOCK_HSI_HZ / CLOCK_PLLM) * CLOCK_PLLN / CLOCK_PLLP)
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+void CLOCK_init(void);
+uint32_t CLOCK_sysclkGet(void);
+uint32_t CLOCK_hclkGet(void);
+uint32_t CLOCK_pclk1Get(void);
+uint32_t CLOCK_pclk2Get(void);
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*CLOCK_H_*/
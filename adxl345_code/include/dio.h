@@ -30,6 +30,10 @@
 /*****************************************************************************
 * Configuration Constants
 *****************************************************************************/
+/**
+ * Defines the number of external interrupt lines, one per pin number.
+ */
+#define DIO_EXTI_LINES  16U
 
 /*****************************************************************************
 * Macros
@@ -44,6 +48,23 @@ typedef struct
     DioPin_t Pin;               /**< The I/O pin */
 }DioPinConfig_t;
 
+/**
+ * Defines the edges of a pin that raise an external interrupt.
+ */
+typedef enum
+{
+    DIO_EDGE_RISING,    /**< Interrupt on the rising edge*/
+    DIO_EDGE_FALLING,   /**< Interrupt on the falling edge*/
+    DIO_EDGE_BOTH,      /**< Interrupt on both edges*/
+    DIO_MAX_EDGE        /**< Defines the maximum edge*/
+}DioEdge_t;
+
+/**
+ * Defines the function called from the interrupt of an EXTI line. The 
+ * timestamp is the DWT cycle count captured on entry to the interrupt.
+ */
+typedef void (*DioExtiCallback_t)(DioPin_t Line, uint32_t timestamp);
+
 /*****************************************************************************
 * Variables
 *****************************************************************************/
@@ -56,9 +77,15 @@ extern "C"{
 #endif
 
 void DIO_init(const DioConfig_t * const Config, size_t configSize);
+void DIO_imageApply(const DioPortImage_t * const Images, size_t imageSize);
 DioPinState_t DIO_pinRead(const DioPinConfig_t * const PinConfig);
 void DIO_pinWrite(const DioPinConfig_t * const PinConfig, DioPinState_t State);
 void DIO_pinToggle(const DioPinConfig_t * const PinConfig);
+void DIO_portWrite(DioPort_t Port, uint16_t mask, uint16_t value);
+void DIO_interruptEnable(const DioPinConfig_t * const PinConfig, 
+DioEdge_t Edge, DioExtiCallback_t Callback);
+void DIO_interruptDisable(const DioPinConfig_t * const PinConfig);
+uint32_t DIO_interruptStampGet(DioPin_t Line);
 void DIO_registerWrite(uint32_t address, uint32_t value);
 uint32_t DIO_registerRead(uint32_t address);
 
@@ -16,6 +16,7 @@
 /*****************************************************************************
 * Includes
 *****************************************************************************/
+#include <stdint.h>
 #include <stdio.h>
 
 /*****************************************************************************
@@ -199,6 +200,23 @@ typedef struct
     DioFunction_t Function;     /**< Mux Function - Dio_Peri_Select */
 }DioConfig_t;
 
+/**
+ * Defines the register values of one port reduced from the configuration 
+ * table at compile time. The masks select the fields of the pins listed 
+ * in the table, so the other pins of the port keep their setting.
+ */
+typedef struct
+{
+    uint32_t Mask2;             /**< 2 bits fields of the pins listed */
+    uint32_t Mask1;             /**< 1 bit fields of the pins listed */
+    uint32_t AfrMask[2];        /**< AFRL and AFRH fields of the pins */
+    uint32_t Moder;             /**< MODER value of the pins */
+    uint32_t Otyper;            /**< OTYPER value of the pins */
+    uint32_t Ospeedr;           /**< OSPEEDR value of the pins */
+    uint32_t Pupdr;             /**< PUPDR value of the pins */
+    uint32_t Afr[2];            /**< AFRL and AFRH value of the pins */
+}DioPortImage_t;
+
 
 /*****************************************************************************
 * Function Prototypes
@@ -209,6 +227,8 @@ extern "C"{
 
 const DioConfig_t * const DIO_configGet(void);
 size_t DIO_configSizeGet(void);
+const DioPortImage_t * const DIO_imageGet(void);
+size_t DIO_imageSizeGet(void);
 
 #ifdef __cplusplus
 } //extern "C"
@@ -0,0 +1,113 @@
+/**
+ * @file probe.h
+ * @author Jose Luis Figueroa
+ * @brief The interface definition for the timing probes. This is the header
+ * file for the hot path instrumentation of the drivers. Each probe point
+ * takes the DWT cycle count and accumulates the cycles it measures into a
+ * log2 histogram with its minimum, maximum and mean, kept in static RAM
+ * where a debugger can read it. The probes are built only when PROBE_ENABLE
+ * is defined, otherwise every probe macro expands to nothing and the
+ * drivers are compiled as if they were not there.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef PROBE_H_
+#define PROBE_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/*****************************************************************************
+* Preprocessor Constants
+*****************************************************************************/
+/**
+ * Defines the buckets of a histogram. Bucket n counts the measures of 2^n
+ * to 2^(n+1) - 1 cycles, bucket 0 also counts the measures of 0 cycles.
+ */
+#define PROBE_BUCKETS       (32U)
+
+/*****************************************************************************
+* Typedefs
+*****************************************************************************/
+/**
+ * Defines the probe points of the drivers.
+ */
+typedef enum
+{
+    PROBE_SPI_TRANSACTION,  /**< SPI_transaction call, retries included */
+    PROBE_SPI_CS,           /**< Chip select assert to release */
+    PROBE_SPI_ISR,          /**< SPI interrupt of a queued transaction */
+    PROBE_DMA_ISR,          /**< SPI DMA completion interrupt */
+    PROBE_EXTI_ISR,         /**< EXTI interrupt, callbacks included */
+    PROBE_SAMPLE_READ,      /**< One sample read and merged from the FIFO */
+    PROBE_SAMPLE_SINK,      /**< One block of samples handed to the sink */
+    PROBE_MAX
+}ProbeId_t;
+
+/**
+ * Defines the statistics of a probe point. The times are CPU cycles of the
+ * DWT cycle counter, less the cost of the probe itself. The mean is sum
+ * over count.
+ */
+typedef struct
+{
+    uint32_t count;                     /**< Measures taken */
+    uint32_t min;                       /**< Shortest measure */
+    uint32_t max;                       /**< Longest measure */
+    uint64_t sum;                       /**< Sum of the measures */
+    uint32_t bucket[PROBE_BUCKETS];     /**< log2 histogram */
+}ProbeStats_t;
+
+/**
+ * Defines the character output of the probe report, an ITM stimulus port
+ * or a UART for instance.
+ */
+typedef void (*ProbeWrite_t)(char character);
+
+/*****************************************************************************
+* Preprocessor Macros
+*****************************************************************************/
+#ifdef PROBE_ENABLE
+/** Declares name and stores the cycle count a measure starts at*/
+#define PROBE_STAMP(name)           uint32_t name = DWT->CYCCNT
+/** Stores the cycle count a measure starts at in a variable of the module*/
+#define PROBE_MARK(name)            ((name) = DWT->CYCCNT)
+/** Ends the measure started at name and accumulates it into the probe*/
+#define PROBE_RECORD(Probe, name)   PROBE_record((Probe), DWT->CYCCNT - \
+                                    (name))
+/** Starts the cycle counter and clears every probe*/
+#define PROBE_INIT()                PROBE_init()
+#else
+#define PROBE_STAMP(name)
+#define PROBE_MARK(name)            ((void)0)
+#define PROBE_RECORD(Probe, name)   ((void)0)
+#define PROBE_INIT()                ((void)0)
+#endif
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+#ifdef PROBE_ENABLE
+void PROBE_init(void);
+void PROBE_record(ProbeId_t Probe, uint32_t cycles);
+const ProbeStats_t * PROBE_statsGet(ProbeId_t Probe);
+uint32_t PROBE_meanGet(ProbeId_t Probe);
+void PROBE_statsReset(void);
+void PROBE_report(ProbeWrite_t Write);
+#endif
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*PROBE_H_*/
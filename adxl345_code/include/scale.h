@@ -0,0 +1,53 @@
+/**
+ * @file scale.h
+ * @author Jose Luis Figueroa
+ * @brief The interface definition for the acceleration scaling. This is the
+ * header file for the batch conversion of ADXL345 raw samples to g in
+ * single precision float, Q15 and Q31 fixed-point.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef SCALE_H_
+#define SCALE_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include "adxl345.h"
+
+/*****************************************************************************
+* Preprocessor Constants
+*****************************************************************************/
+/**
+ * Defines the full scale of the fixed-point outputs. Q15 and Q31 values
+ * are fractions of +-SCALE_FULL_SCALE_G, so every range and resolution
+ * shares the same fixed-point format.
+ */
+#define SCALE_FULL_SCALE_G  (16U)
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+uint8_t SCALE_shiftGet(Adxl345Range_t Range, Adxl345Resolution_t Resolution);
+float SCALE_factorGet(Adxl345Range_t Range, Adxl345Resolution_t Resolution);
+void SCALE_toFloat(const Adxl345Sample_t * const Samples, float *out,
+size_t count, Adxl345Range_t Range, Adxl345Resolution_t Resolution);
+void SCALE_toQ15(const Adxl345Sample_t * const Samples, int16_t *out,
+size_t count, Adxl345Range_t Range, Adxl345Resolution_t Resolution);
+void SCALE_toQ31(const Adxl345Sample_t * const Samples, int32_t *out,
+size_t count, Adxl345Range_t Range, Adxl345Resolution_t Resolution);
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*SCALE_H_*/
@@ -0,0 +1,83 @@
+/**
+ * @file sensors.h
+ * @author Jose Luis Figueroa
+ * @brief The interface definition for the ADXL345 device table. This is the
+ * header file for the acquisition of several accelerometers spread over
+ * shared and separate SPI channels.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef SENSORS_H_
+#define SENSORS_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+#include <stdio.h>
+#include "adxl345.h"
+#include "sensors_cfg.h"
+
+/*****************************************************************************
+* Preprocessor Constants
+*****************************************************************************/
+/**
+ * Defines the owner of a bus that no device is using.
+ */
+#define SENSORS_BUS_FREE    (0xFFU)
+
+/*****************************************************************************
+* Typedefs
+*****************************************************************************/
+/**
+ * Defines the throughput counters of the device table. The counters run 
+ * from the DWT cycle windowStart, taken by SENSORS_statsReset, so 
+ * SENSORS_rateGet or the application divides them by the elapsed time to
+ * get samples/s and frames/s. A bus is saturated when its frames/s reach 
+ * the SPI clock divided by 8 bits.
+ */
+typedef struct
+{
+    uint32_t passes;                            /**< SENSORS_poll calls */
+    uint32_t samples;                           /**< Samples of all devices */
+    uint32_t deviceSamples[ADXL345_DEVICES_NUMBER]; /**< Samples per device */
+    uint32_t busFrames[SPI_PORTS_NUMBER];       /**< SPI frames per bus */
+    uint32_t busContention;                     /**< Turns lost to a busy bus */
+    uint32_t windowStart;                       /**< CYCCNT at the reset */
+}SensorsStats_t;
+
+/**
+ * Defines the function that receives the samples drained from a device.
+ */
+typedef void (*SensorsSink_t)(uint8_t Device, 
+const Adxl345Sample_t * const Samples, uint8_t count);
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+SpiStatus_t SENSORS_init(const Adxl345Config_t * const Config, 
+size_t configSize);
+uint16_t SENSORS_poll(SensorsSink_t Sink);
+uint8_t SENSORS_start(void);
+uint8_t SENSORS_readyGet(void);
+uint16_t SENSORS_collect(SensorsSink_t Sink);
+uint8_t SENSORS_busAcquire(SpiChannel_t Channel, uint8_t Device);
+void SENSORS_busRelease(SpiChannel_t Channel, uint8_t Device);
+const Adxl345Config_t * SENSORS_deviceGet(uint8_t Device);
+const SensorsStats_t * SENSORS_statsGet(void);
+void SENSORS_statsReset(void);
+uint32_t SENSORS_rateGet(void);
+uint32_t SENSORS_drainStampGet(uint8_t Device);
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*SENSORS_H_*/
@@ -0,0 +1,36 @@
+/**
+ * @file sensors_cfg.h
+ * @author Jose Luis Figueroa
+ * @brief This module contains interface definitions for the sensors 
+ * configuration. This is the header file for the definition of the
+ * interface for retrieving the ADXL345 device table.
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ * 
+ */
+#ifndef SENSORS_CFG_H_
+#define SENSORS_CFG_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdio.h>
+#include "adxl345.h"
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+const Adxl345Config_t * const SENSORS_configGet(void);
+size_t SENSORS_configSizeGet(void);
+
+#ifdef __cplusplus
+} //extern "C"
+#endif
+
+#endif /*SENSORS_CFG_H_*/
@@ -21,6 +21,8 @@
 //#define NDEBUG          /*To disable assert function*/  
 #include <assert.h>
 #include "spi_cfg.h"
+#include "clock.h"
+#include "dio.h"
 #include "stm32f4xx.h"   
 
 /*****************************************************************************
@@ -30,6 +32,22 @@
 /*****************************************************************************
 * Configuration Constants
 *****************************************************************************/
+/**
+ * Defines the number of transactions each channel queue holds.
+ */
+#define SPI_QUEUE_DEPTH 8U
+
+/**
+ * Defines the default budget, in CPU cycles, of every wait on a status 
+ * flag, 1 ms of the system clock.
+ */
+#define SPI_TIMEOUT_CYCLES (CLOCK_SYSCLK_HZ / 1000UL)
+
+/**
+ * Defines the number of times a failed repeatable SPI_transaction is 
+ * restarted.
+ */
+#define SPI_RETRY_MAX 2U
 
 /*****************************************************************************
 * Macros
@@ -38,6 +56,32 @@
 /*****************************************************************************
 * Typedefs
 *****************************************************************************/
+/**
+ * Defines the result of an SPI operation.
+ */
+typedef enum
+{
+    SPI_OK,             /**< The operation completed */
+    SPI_TIMEOUT,        /**< A flag was not reached within the budget */
+    SPI_OVERRUN,        /**< A received frame was lost (OVR) */
+    SPI_MODE_FAULT,     /**< The master was deselected (MODF) */
+    SPI_DMA_ERROR,      /**< A DMA stream stopped on a transfer error */
+    SPI_BUSY,           /**< The channel is in use by another operation */
+    SPI_MAX_STATUS      /**< Maximum status */
+}SpiStatus_t;
+
+/**
+ * Defines the fault counters of a channel.
+ */
+typedef struct
+{
+    uint32_t timeouts;      /**< Waits that ran out of budget */
+    uint32_t overruns;      /**< Overruns detected and cleared */
+    uint32_t modeFaults;    /**< Mode faults detected and cleared */
+    uint32_t retries;       /**< Transactions restarted after a fault */
+    uint32_t dmaErrors;     /**< DMA operations stopped by a stream error */
+}SpiFaultStats_t;
+
 typedef struct
 {
     SpiChannel_t Channel;           /**< The SPI channel */
@@ -45,6 +89,94 @@ typedef struct
     uint16_t *data;                 /**< The data to be sent */
 }SpiTransferConfig_t;
 
+/**
+ * Defines a full-duplex exchange. Each frame sent from txData is matched by
+ * a frame stored in rxData. A NULL txData sends dummy (zero) frames and a 
+ * NULL rxData discards the received frames. Both may point to the same 
+ * buffer for an in-place exchange.
+ */
+typedef struct
+{
+    SpiChannel_t Channel;           /**< The SPI channel */
+    uint16_t size;                  /**< The number of frames */
+    const uint16_t *txData;         /**< The data to be sent */
+    uint16_t *rxData;               /**< The data received */
+}SpiTransceiveConfig_t;
+
+/**
+ * Defines the function called from interrupt context when a DMA transfer 
+ * or reception on the channel has completed. Status is SPI_OK when every 
+ * frame was moved and SPI_DMA_ERROR when a stream error stopped the 
+ * operation, the received frames are not valid then.
+ */
+typedef void (*SpiCallback_t)(SpiChannel_t Channel, SpiStatus_t Status);
+
+typedef struct SpiTransaction SpiTransaction_t;
+
+/**
+ * Defines the function called when a transaction has completed, from 
+ * interrupt context for a queued transaction. Transaction points to the 
+ * queue copy of the descriptor and is valid until the callback returns. 
+ * Status is SPI_OK, or the fault that aborted a queued transaction, its 
+ * received frames are not valid then.
+ */
+typedef void (*SpiTransactionCallback_t)(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction, SpiStatus_t Status);
+
+/**
+ * Defines a segment of a transaction. A NULL txData sends dummy (zero) 
+ * frames and a NULL rxData discards the received frames.
+ */
+typedef struct
+{
+    const uint16_t *txData;         /**< The data to be sent */
+    uint16_t *rxData;               /**< The data received */
+    uint16_t size;                  /**< The number of frames */
+}SpiSegment_t;
+
+/**
+ * Defines a transaction. The chip select is asserted, the frames of all 
+ * the segments are clocked back to back and the chip select is released.
+ * On a hardware NSS channel the NSS output is the chip select and Port and
+ * Pin are not used.
+ * The setup and hold gaps are counted in CPU cycles between the chip 
+ * select edges and the first and last clock edges, zero adds no gap.
+ * A repeatable transaction leaves the slave in the same state when it is 
+ * run twice, a register write for instance, and is restarted by 
+ * SPI_transaction after a fault. A read with side effects, which pops a 
+ * FIFO or clears a flag, is not.
+ */
+struct SpiTransaction
+{
+    DioPort_t Port;                     /**< The chip select port */
+    DioPin_t Pin;                       /**< The chip select pin */
+    const SpiSegment_t *Segments;       /**< The segments in bus order */
+    uint8_t segmentCount;               /**< The number of segments */
+    uint16_t csSetup;                   /**< CS assert to first clock */
+    uint16_t csHold;                    /**< Last clock to CS release */
+    uint8_t repeatable;                 /**< Restart after a fault (0 or 1)*/
+    SpiTransactionCallback_t Callback;  /**< Completion callback, or NULL */
+};
+
+/**
+ * Defines the sizing metrics of a channel queue. The times are CPU cycles
+ * counted by the DWT cycle counter. The latency runs from SPI_enqueue to 
+ * the completion of the transaction, the wait from SPI_enqueue to its 
+ * first frame.
+ */
+typedef struct
+{
+    uint32_t enqueued;      /**< Transactions accepted */
+    uint32_t rejected;      /**< Transactions refused on a full queue */
+    uint32_t completed;     /**< Transactions completed */
+    uint32_t aborted;       /**< Transactions aborted by a fault */
+    uint8_t depth;          /**< Transactions in the queue now */
+    uint8_t maxDepth;       /**< Highest depth reached */
+    uint32_t waitMax;       /**< Longest wait before the first frame */
+    uint32_t latencyMax;    /**< Longest enqueue to completion time */
+    uint64_t latencySum;    /**< Sum of the latencies of completed */
+}SpiQueueStats_t;
+
 /*****************************************************************************
 * Variables
 *****************************************************************************/
@@ -57,8 +189,30 @@ extern "C"{
 #endif
 
 void SPI_init(const SpiConfig_t * const Config, size_t configSize);
-void SPI_transfer(const SpiTransferConfig_t * const TransferConfig);
-void SPI_receive(const SpiTransferConfig_t * const TransferConfig);
+SpiStatus_t SPI_transfer(const SpiTransferConfig_t * const TransferConfig);
+SpiStatus_t SPI_receive(const SpiTransferConfig_t * const TransferConfig);
+SpiStatus_t SPI_transceive(
+const SpiTransceiveConfig_t * const TransceiveConfig);
+SpiStatus_t SPI_transferDma(const SpiTransferConfig_t * const TransferConfig);
+SpiStatus_t SPI_receiveDma(const SpiTransferConfig_t * const TransferConfig);
+SpiStatus_t SPI_transceiveDma(
+const SpiTransceiveConfig_t * const TransceiveConfig);
+SpiStatus_t SPI_dmaAcquire(SpiChannel_t Channel);
+void SPI_transceiveDmaStart(
+const SpiTransceiveConfig_t * const TransceiveConfig);
+SpiStatus_t SPI_transaction(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction);
+void SPI_callbackRegister(SpiChannel_t Channel, SpiCallback_t Callback);
+uint8_t SPI_enqueue(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction);
+const SpiQueueStats_t * SPI_queueStatsGet(SpiChannel_t Channel);
+void SPI_queueStatsReset(SpiChannel_t Channel);
+uint8_t SPI_hardwareNssGet(SpiChannel_t Channel);
+void SPI_timeoutSet(SpiChannel_t Channel, uint32_t cycles);
+const SpiFaultStats_t * SPI_faultStatsGet(SpiChannel_t Channel);
+void SPI_faultStatsReset(SpiChannel_t Channel);
+SpiBaudRate_t SPI_baudRateSelect(SpiChannel_t Channel, uint32_t maxBitRate);
+uint32_t SPI_bitRateGet(SpiChannel_t Channel);
 void SPI_registerWrite(uint32_t address, uint32_t value);
 uint16_t SPI_registerRead(uint32_t address);
 
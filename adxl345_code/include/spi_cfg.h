@@ -16,7 +16,9 @@
 /*****************************************************************************
 * Includes
 *****************************************************************************/
+#include <stdint.h>
 #include <stdio.h>
+#include "stm32f4xx.h"
 
 /****************************************************************************
 * Preprocessor Constants
@@ -26,6 +28,45 @@
  */
 #define SPI_PORTS_NUMBER 4U
 
+/****************************************************************************
+* Preprocessor Macros
+*****************************************************************************/
+/**
+ * Reduces the settings of a configuration row to the CR1 value. The enums
+ * follow the register encoding: Mode is CPOL:CPHA, SPI_MASTER sets MSTR, 
+ * BaudRate is BR, and SPI_LSB, SPI_RECEIVE_MODE and SPI_16BITS set 
+ * LSBFIRST, RXONLY and DFF. Software NSS keeps SSI high so the master 
+ * never sees a mode fault.
+ */
+#define SPI_CR1_IMAGE(Mode, Hierarchy, BaudRate, SlaveSelect, FrameFormat, \
+TypeTransfer, DataSize)                                                     \
+((uint16_t)(((uint32_t)(Mode) << SPI_CR1_CPHA_Pos) |                        \
+((uint32_t)(Hierarchy) << SPI_CR1_MSTR_Pos) |                               \
+((uint32_t)(BaudRate) << SPI_CR1_BR_Pos) |                                  \
+(((SlaveSelect) == SPI_SOFTWARE_NSS) ? (SPI_CR1_SSM | SPI_CR1_SSI) : 0U) |  \
+((uint32_t)(FrameFormat) << SPI_CR1_LSBFIRST_Pos) |                         \
+((uint32_t)(TypeTransfer) << SPI_CR1_RXONLY_Pos) |                          \
+((uint32_t)(DataSize) << SPI_CR1_DFF_Pos)))
+
+/**
+ * Reduces the slave select of a configuration row to the CR2 value.
+ */
+#define SPI_CR2_IMAGE(SlaveSelect)                                          \
+((uint16_t)(((SlaveSelect) == SPI_HARDWARE_NSS_ENABLED) ? SPI_CR2_SSOE : 0U))
+
+/**
+ * Checks the settings of a configuration row. A master with hardware NSS 
+ * drives the pin, a slave cannot.
+ */
+#define SPI_CONFIG_VALID(Channel, Mode, Hierarchy, BaudRate, SlaveSelect,   \
+FrameFormat, TypeTransfer, DataSize)                                        \
+(((Channel) < SPI_MAX_CHANNEL) && ((Mode) < SPI_MAX_MODE) &&                \
+((Hierarchy) < SPI_MAX_HIERARCHY) && ((BaudRate) < SPI_MAX_FPCLK) &&        \
+((SlaveSelect) < SPI_MAX_NSS) && ((FrameFormat) < SPI_MAX_FF) &&            \
+((TypeTransfer) < SPI_MAX_DF) && ((DataSize) < SPI_MAX_BITS) &&             \
+(((SlaveSelect) != SPI_HARDWARE_NSS_ENABLED) ||                             \
+((Hierarchy) == SPI_MASTER)))
+
 /****************************************************************************
 * Typedefs
 *****************************************************************************/
@@ -141,6 +182,9 @@ typedef struct
     SpiFrameFormat_t FrameFormat;   /**< MSB and LSB */
     SpiTypeTransfer_t TypeTransfer; /**< Full duplex and Receive mode*/
     SpiDataSize_t DataSize;         /**< 8 bits and 16 bits*/
+    uint32_t MaxBitRate;            /**< Slave limit in Hz, 0 uses BaudRate*/
+    uint16_t Cr1Image;              /**< CR1 reduced from the settings*/
+    uint16_t Cr2Image;              /**< CR2 reduced from the settings*/
 }SpiConfig_t;
 
 
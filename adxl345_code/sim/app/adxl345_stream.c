@@ -0,0 +1,227 @@
+/**
+ * @file adxl345_stream.c
+ * @author Jose Luis Figueroa
+ * @brief The host program of the ADXL345 model. The acquisition loop of
+ * main.c runs unmodified against the device model wired as on the board:
+ * SPI1 with hardware NSS on PA4 and INT1 on PA0. The X axis of the model
+ * counts the samples, so the sink sees each sample lost on the way. The
+ * program reports the samples produced, read and dropped with their
+ * latency, and fails when the host and the model disagree, a sample is
+ * lost or a read starts before the FIFO finished popping.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "clock.h"
+#include "sensors.h"
+#include "sim.h"
+#include "sim_adxl345.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Simulated acquisition time*/
+#define RUN_MS              (100U)
+/** Period of the X axis counter, 10 bits values*/
+#define COUNTER_PERIOD      (512)
+/** LSB/g of the +-4 g range in 10 bits mode*/
+#define COUNTER_LSB_PER_G   (128)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Set by the INT1 (PA0) interrupt*/
+static volatile uint8_t dataReady;
+
+/** Samples received by the sink and gaps in the X counter*/
+static uint32_t received;
+static uint32_t gaps;
+static int16_t lastX;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static int32_t CounterWaveform(void *context, uint8_t axis, uint32_t sample);
+static void Int1Event(DioPin_t Line, uint32_t timestamp);
+static void SampleSink(uint8_t Device, const Adxl345Sample_t * const Samples,
+uint8_t count);
+
+int main(void)
+{
+    /*Bring the simulated MCU up as the firmware does*/
+    CLOCK_init();
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN | RCC_APB2ENR_SYSCFGEN;
+    DIO_imageApply(DIO_imageGet(), DIO_imageSizeGet());
+    SPI_init(SPI_ConfigGet(), SPI_configSizeGet());
+
+    /*ADXL345 on SPI1 behind the hardware NSS, INT1 on PA0*/
+    const SimAdxl345Config_t Sensor =
+    {
+        .Channel = SPI_CHANNEL1,
+        .CsPort = SIM_NSS,
+        .CsPin = 0U,
+        .Int1Port = 0U,
+        .Int1Pin = 0U,
+        .Int2Port = SIM_ADXL345_NC,
+        .Int2Pin = 0U,
+        .Waveform = CounterWaveform,
+        .context = NULL
+    };
+    SIM_adxl345Attach(0U, &Sensor);
+
+    const DioPinConfig_t Int1Line =
+    {
+        .Port = DIO_PA,
+        .Pin = DIO_PA0
+    };
+    DIO_interruptEnable(&Int1Line, DIO_EDGE_RISING, Int1Event);
+
+    const SpiStatus_t initStatus = SENSORS_init(SENSORS_configGet(), 
+    SENSORS_configSizeGet());
+    const Adxl345Config_t * const Config = SENSORS_deviceGet(0U);
+
+    uint16_t deviceId = 0;
+    ADXL345_read(Config, DEVID_R, 1U, &deviceId);
+
+    /*Start from the first sample the loop can see*/
+    lastX = (int16_t)(-COUNTER_PERIOD / 2 - 1);
+    SIM_adxl345StatsReset(0U);
+    const uint64_t start = SIM_cyclesGet();
+    const uint64_t end = start + ((uint64_t)SIM_hclkGet() / 1000U) * RUN_MS;
+
+    /*The acquisition loop of main.c*/
+    while(SIM_cyclesGet() < end)
+    {
+        __disable_irq();
+        if(!dataReady && (SENSORS_readyGet() == 0U))
+        {
+            __WFI();
+        }
+        __enable_irq();
+
+        SENSORS_collect(SampleSink);
+
+        if(dataReady || (DIO_pinRead(&Int1Line) == DIO_HIGH))
+        {
+            dataReady = 0;
+            SENSORS_start();
+        }
+    }
+
+    /*Let the drain in flight complete without starting another one*/
+    SIM_clockAdvance(SIM_hclkGet() / 1000U);
+    SENSORS_collect(SampleSink);
+
+    const SimAdxl345Stats_t Stats = SIM_adxl345StatsGet(0U);
+    const double cyclesPerUs = (double)SIM_hclkGet() / 1e6;
+    printf("DEVID 0x%02X, ODR %lu Hz, %u ms, init %s\n", (unsigned)deviceId,
+    (unsigned long)(ADXL345_odrGet(Config->Odr) / 1000U), RUN_MS,
+    (initStatus == SPI_OK) ? "ok" : "failed");
+    printf("samples %lu read %lu dropped %lu received %lu gaps %lu "
+    "early %lu\n", (unsigned long)Stats.samples, (unsigned long)Stats.read,
+    (unsigned long)Stats.dropped, (unsigned long)received,
+    (unsigned long)gaps, (unsigned long)Stats.earlyReads);
+    printf("latency mean %.1f us max %.1f us, rate %lu samples/s\n",
+    (Stats.read > 0U) ? ((double)Stats.latencySum / Stats.read / cyclesPerUs) :
+    0.0, (double)Stats.latencyMax / cyclesPerUs,
+    (unsigned long)SENSORS_rateGet());
+
+    const uint8_t failed = (initStatus != SPI_OK) || (deviceId != 0xE5U) || 
+    (Stats.read != received) ||
+    (Stats.dropped != 0U) || (gaps != 0U) || (received == 0U) ||
+    (Stats.earlyReads != 0U);
+
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+/*****************************************************************************
+ * Function: CounterWaveform()
+*//**
+*\b Description:
+ * This function is the waveform source of the model. X counts the samples
+ * over the 10 bits range of +-4 g, Y is at rest and Z holds 1 g.
+ *
+ * @param[in]   context is not used.
+ * @param[in]   axis is 0 = X, 1 = Y or 2 = Z.
+ * @param[in]   sample is the sample number.
+ *
+ * @return  The acceleration in mg.
+ *
+*****************************************************************************/
+static int32_t CounterWaveform(void *context, uint8_t axis, uint32_t sample)
+{
+    (void)context;
+
+    if(axis == 0U)
+    {
+        const int32_t count = (int32_t)(sample % COUNTER_PERIOD) -
+        (COUNTER_PERIOD / 2);
+        return (count * 1000) / COUNTER_LSB_PER_G;
+    }
+
+    return (axis == 2U) ? 1000 : 0;
+}
+
+/*****************************************************************************
+ * Function: Int1Event()
+*//**
+*\b Description:
+ * This function is called from the EXTI interrupt on the rising edge of
+ * INT1.
+ *
+ * @param[in]   Line is not used.
+ * @param[in]   timestamp is not used.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void Int1Event(DioPin_t Line, uint32_t timestamp)
+{
+    (void)Line;
+    (void)timestamp;
+    dataReady = 1;
+}
+
+/*****************************************************************************
+ * Function: SampleSink()
+*//**
+*\b Description:
+ * This function receives the samples drained from the device and checks
+ * the X counter for samples lost on the way.
+ *
+ * @param[in]   Device is not used.
+ * @param[in]   Samples is the block of raw samples.
+ * @param[in]   count is the number of samples.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SampleSink(uint8_t Device, const Adxl345Sample_t * const Samples,
+uint8_t count)
+{
+    (void)Device;
+
+    for(uint8_t i = 0; i < count; i++)
+    {
+        int16_t expected = (int16_t)(lastX + 1);
+        if(expected >= (COUNTER_PERIOD / 2))
+        {
+            expected = (int16_t)(-COUNTER_PERIOD / 2);
+        }
+        if(Samples[i].x != expected)
+        {
+            gaps++;
+        }
+        lastX = Samples[i].x;
+    }
+
+    received += count;
+}
@@ -0,0 +1,275 @@
+/**
+ * @file spi_loopback.c
+ * @author Jose Luis Figueroa
+ * @brief The host program of the native build. SPI1 is brought up as on the
+ * Nucleo-F401RE with MOSI wired to MISO on the simulated bus. The polled,
+ * queued and DMA transfers of the SPI driver are checked frame by frame
+ * and their cost on the simulated clock is reported. A stalled queue is 
+ * checked to give the channel back to the next blocking call. The program
+ * fails when a frame comes back wrong, so it can gate a CI run.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "clock.h"
+#include "dio.h"
+#include "spi.h"
+#include "sim.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Frames of each transfer*/
+#define FRAMES              (64U)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Frames sent and received, static as the DMA requires*/
+static uint16_t txFrames[FRAMES];
+static uint16_t rxFrames[FRAMES];
+
+/** Set by the completion callbacks, the polled transfer has none*/
+static volatile uint8_t done;
+
+/** Status given to the completion callback*/
+static volatile SpiStatus_t completion;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static uint16_t LoopbackExchange(void *context, uint16_t mosi,
+uint64_t cycle);
+static void DmaComplete(SpiChannel_t Channel, SpiStatus_t Status);
+static void QueueComplete(SpiChannel_t Channel,
+const SpiTransaction_t * const Transaction, SpiStatus_t Status);
+static void WaitDone(void);
+static uint8_t Report(const char *name, uint64_t start,
+SpiStatus_t status);
+
+/** Device wiring MOSI to MISO, selected by the NSS output of SPI1*/
+static const SimSpiDevice_t Loopback =
+{
+    NULL, LoopbackExchange, NULL
+};
+
+int main(void)
+{
+    uint8_t failures = 0;
+
+    /*Bring the simulated MCU up as the firmware does*/
+    CLOCK_init();
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN | RCC_APB2ENR_SYSCFGEN;
+    DIO_imageApply(DIO_imageGet(), DIO_imageSizeGet());
+    SPI_init(SPI_ConfigGet(), SPI_configSizeGet());
+    SIM_spiAttach(SPI_CHANNEL1, &Loopback, SIM_NSS, 0U);
+
+    printf("SPI1 at %lu bit/s, core at %lu Hz\n",
+    (unsigned long)SPI_bitRateGet(SPI_CHANNEL1),
+    (unsigned long)CLOCK_hclkGet());
+
+    for(uint16_t i = 0; i < FRAMES; i++)
+    {
+        txFrames[i] = (uint16_t)((i * 37U + 11U) & 0xFFU);
+    }
+
+    /*Polled full duplex transfer*/
+    const SpiTransceiveConfig_t Transceive =
+    {
+        .Channel = SPI_CHANNEL1,
+        .size = FRAMES,
+        .txData = txFrames,
+        .rxData = rxFrames
+    };
+    memset(rxFrames, 0, sizeof(rxFrames));
+    done = 1;
+    uint64_t start = SIM_cyclesGet();
+    failures += Report("polled", start, SPI_transceive(&Transceive));
+
+    /*Interrupt driven transaction through the queue*/
+    const SpiSegment_t Segment = {txFrames, rxFrames, FRAMES};
+    const SpiTransaction_t Transaction =
+    {
+        .Port = DIO_PA,
+        .Pin = DIO_PA4,
+        .Segments = &Segment,
+        .segmentCount = 1U,
+        .csSetup = 0U,
+        .csHold = 0U,
+        .Callback = QueueComplete
+    };
+    memset(rxFrames, 0, sizeof(rxFrames));
+    done = 0;
+    start = SIM_cyclesGet();
+    SpiStatus_t status = SPI_enqueue(SPI_CHANNEL1, &Transaction) ? SPI_OK :
+    SPI_BUSY;
+
+    /*The queue owns the channel until it is empty*/
+    const uint8_t refused = (SPI_transceive(&Transceive) == SPI_BUSY) ? 1U :
+    0U;
+    WaitDone();
+    status = (status == SPI_OK) ? completion : status;
+    failures += Report("queued", start, status);
+    printf("%-8s blocking call while queued %s\n", "owner",
+    refused ? "refused  ok" : "accepted  FAIL");
+    failures += refused ? 0U : 1U;
+
+    /*DMA transfer*/
+    SPI_callbackRegister(SPI_CHANNEL1, DmaComplete);
+    memset(rxFrames, 0, sizeof(rxFrames));
+    done = 0;
+    start = SIM_cyclesGet();
+    status = SPI_transceiveDma(&Transceive);
+    WaitDone();
+    status = (status == SPI_OK) ? completion : status;
+    failures += Report("dma", start, status);
+
+    /*A queued transaction that moves no frame keeps the channel until the
+    next call that needs it aborts the transaction*/
+    __disable_irq();
+    done = 0;
+    completion = SPI_OK;
+    status = SPI_enqueue(SPI_CHANNEL1, &Transaction) ? SPI_OK : SPI_BUSY;
+    SIM_clockAdvance(2U * SPI_TIMEOUT_CYCLES);
+    const SpiStatus_t reclaim = SPI_transceive(&Transceive);
+    __enable_irq();
+    const uint8_t reclaimed = ((status == SPI_OK) && (reclaim == SPI_OK) && 
+    done && (completion == SPI_TIMEOUT)) ? 1U : 0U;
+    printf("%-8s stalled queue aborted by blocking call %s\n", "stall",
+    reclaimed ? "reclaimed  ok" : "held  FAIL");
+    failures += reclaimed ? 0U : 1U;
+
+    return (failures == 0U) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*****************************************************************************
+ * Function: LoopbackExchange()
+*//**
+*\b Description:
+ * This function returns on MISO the frame shifted out on MOSI.
+ *
+ * @param[in]   context is not used.
+ * @param[in]   mosi is the frame driven by the master.
+ * @param[in]   cycle is not used.
+ *
+ * @return  The frame driven on MISO.
+ *
+*****************************************************************************/
+static uint16_t LoopbackExchange(void *context, uint16_t mosi,
+uint64_t cycle)
+{
+    (void)context;
+    (void)cycle;
+
+    return mosi;
+}
+
+/*****************************************************************************
+ * Function: DmaComplete()
+*//**
+*\b Description:
+ * This function is called from the DMA interrupt when the transfer ends.
+ *
+ * @param[in]   Channel is not used.
+ * @param[in]   Status is the result of the transfer.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void DmaComplete(SpiChannel_t Channel, SpiStatus_t Status)
+{
+    (void)Channel;
+    completion = Status;
+    done = 1;
+}
+
+/*****************************************************************************
+ * Function: QueueComplete()
+*//**
+*\b Description:
+ * This function is called from the SPI interrupt when the queued
+ * transaction ends.
+ *
+ * @param[in]   Channel is not used.
+ * @param[in]   Transaction is not used.
+ * @param[in]   Status is the result of the transaction.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void QueueComplete(SpiChannel_t Channel,
+const SpiTransaction_t * const Transaction, SpiStatus_t Status)
+{
+    (void)Channel;
+    (void)Transaction;
+    completion = Status;
+    done = 1;
+}
+
+/*****************************************************************************
+ * Function: WaitDone()
+*//**
+*\b Description:
+ * This function sleeps until a completion callback runs, or until nothing
+ * is left on the simulated clock to wake the core.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void WaitDone(void)
+{
+    uint64_t last = SIM_NEVER;
+
+    while(!done && (SIM_cyclesGet() != last))
+    {
+        last = SIM_cyclesGet();
+        __disable_irq();
+        if(!done)
+        {
+            __WFI();
+        }
+        __enable_irq();
+    }
+}
+
+/*****************************************************************************
+ * Function: Report()
+*//**
+*\b Description:
+ * This function checks the frames received against the frames sent and
+ * prints the cost of the transfer.
+ *
+ * @param[in]   name is the transfer mode.
+ * @param[in]   start is the cycle the transfer started.
+ * @param[in]   status is the status returned by the driver.
+ *
+ * @return  1 when the transfer failed, 0 otherwise.
+ *
+*****************************************************************************/
+static uint8_t Report(const char *name, uint64_t start,
+SpiStatus_t status)
+{
+    const uint64_t elapsed = SIM_cyclesGet() - start;
+    const SimSpiStats_t Stats = SIM_spiStatsGet(SPI_CHANNEL1);
+    const uint8_t match = (memcmp(txFrames, rxFrames, sizeof(txFrames)) ==
+    0) ? 1U : 0U;
+    const uint8_t failed = ((status != SPI_OK) || !match || !done) ? 1U : 0U;
+
+    printf("%-8s %3u frames %9.1f cycles/frame %5.1f %% bus %3u ovr  %s\n",
+    name, FRAMES, (double)elapsed / FRAMES,
+    (elapsed > 0U) ? (100.0 * (double)Stats.busyCycles / (double)elapsed) :
+    0.0, (unsigned)Stats.overruns, failed ? "FAIL" : "ok");
+
+    SIM_spiStatsReset(SPI_CHANNEL1);
+
+    return failed;
+}
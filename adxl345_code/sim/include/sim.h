@@ -0,0 +1,126 @@
+/**
+ * @file sim.h
+ * @author Jose Luis Figueroa
+ * @brief The interface definition for the STM32F401 peripheral simulator.
+ * This is the header file for the host (native) build. The register file
+ * of the SPI, DMA, GPIO, EXTI, RCC and DWT peripherals is mapped at the
+ * device addresses and each access of the drivers is trapped and served by
+ * a behavioral model that runs on a simulated CPU clock.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef SIM_H_
+#define SIM_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/*****************************************************************************
+* Configuration Constants
+*****************************************************************************/
+/**
+ * Defines the simulated peripherals. GPIO ports are numbered by their
+ * address slot, GPIOA = 0 to GPIOE = 4 and GPIOH = 7.
+ */
+#define SIM_SPI_CHANNELS    (4U)
+#define SIM_GPIO_PORTS      (8U)
+#define SIM_GPIO_PINS       (16U)
+#define SIM_DMA_STREAMS     (16U)
+
+/**
+ * Defines the devices that can be attached to each SPI channel and the
+ * clients that can be attached to the clock.
+ */
+#define SIM_SPI_DEVICES     (4U)
+#define SIM_CLIENTS         (8U)
+
+/**
+ * Defines the port of a device selected by the hardware NSS output of its
+ * channel instead of a GPIO pin.
+ */
+#define SIM_NSS             (0xFFU)
+
+/**
+ * Defines an event that never happens.
+ */
+#define SIM_NEVER           (UINT64_MAX)
+
+/**
+ * Defines the CPU cycles charged to each register access, load or store
+ * through the bus matrix and the APB bridge with the loop around it.
+ */
+#define SIM_ACCESS_CYCLES   (4U)
+
+/**
+ * Defines the CPU cycles of the exception entry (stacking and vector
+ * fetch) and of the exception return.
+ */
+#define SIM_IRQ_ENTRY_CYCLES (12U)
+#define SIM_IRQ_EXIT_CYCLES (10U)
+
+/*****************************************************************************
+* Typedefs
+*****************************************************************************/
+/**
+ * Defines a device on a simulated SPI bus. select is called on each edge
+ * of its chip select, exchange once per frame while it is selected with
+ * the frame driven on MOSI, it returns the frame driven on MISO.
+ */
+typedef struct
+{
+    void (*select)(void *context, uint8_t selected, uint64_t cycle);
+    uint16_t (*exchange)(void *context, uint16_t mosi, uint64_t cycle);
+    void *context;
+}SimSpiDevice_t;
+
+/**
+ * Defines a model run by the simulated clock. nextEvent returns the cycle
+ * of its next event or SIM_NEVER, advance runs its events up to cycle.
+ */
+typedef struct
+{
+    uint64_t (*nextEvent)(void *context);
+    void (*advance)(void *context, uint64_t cycle);
+    void *context;
+}SimClient_t;
+
+/**
+ * Defines the bus metrics of a simulated SPI channel.
+ */
+typedef struct
+{
+    uint32_t frames;        /**< Frames shifted */
+    uint32_t overruns;      /**< Frames lost on a full receive buffer */
+    uint32_t selects;       /**< Chip select assertions */
+    uint64_t busyCycles;    /**< CPU cycles the bus was shifting */
+}SimSpiStats_t;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+uint64_t SIM_cyclesGet(void);
+uint32_t SIM_hclkGet(void);
+void SIM_clockAdvance(uint64_t cycles);
+void SIM_clientAttach(const SimClient_t * const Client);
+void SIM_spiAttach(uint8_t Channel, const SimSpiDevice_t * const Device,
+uint8_t Port, uint8_t Pin);
+SimSpiStats_t SIM_spiStatsGet(uint8_t Channel);
+void SIM_spiStatsReset(uint8_t Channel);
+void SIM_pinDrive(uint8_t Port, uint8_t Pin, uint8_t level);
+uint8_t SIM_pinGet(uint8_t Port, uint8_t Pin);
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*SIM_H_*/
@@ -0,0 +1,107 @@
+/**
+ * @file sim_adxl345.h
+ * @author Jose Luis Figueroa
+ * @brief The interface definition for the ADXL345 device model. This is the
+ * header file for the behavioral accelerometer of the host (native) build.
+ * The model sits on a simulated SPI bus behind its chip select, answers the
+ * 4-wire framing of the ADXL345 and produces samples at the programmed
+ * output data rate from a waveform source. Its INT1 and INT2 outputs drive
+ * simulated GPIO pins, and it keeps the sample metrics a bench needs:
+ * produced, read and dropped samples, the latency of each read and the
+ * reads started before the FIFO finished popping.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef SIM_ADXL345_H_
+#define SIM_ADXL345_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+#include "sim.h"
+
+/*****************************************************************************
+* Configuration Constants
+*****************************************************************************/
+/**
+ * Defines the number of device models that can be attached.
+ */
+#define SIM_ADXL345_DEVICES (4U)
+
+/**
+ * Defines the entries held by the device, the 32 FIFO levels plus the
+ * output data registers.
+ */
+#define SIM_ADXL345_ENTRIES (33U)
+
+/**
+ * Defines an interrupt output left unconnected.
+ */
+#define SIM_ADXL345_NC      (0xFFU)
+
+/*****************************************************************************
+* Typedefs
+*****************************************************************************/
+/**
+ * Defines the waveform source of a device. It returns the acceleration of
+ * an axis (0 = X, 1 = Y, 2 = Z) in mg for the sample number given, counted
+ * from power up at the output data rate in use.
+ */
+typedef int32_t (*SimAdxl345Waveform_t)(void *context, uint8_t axis,
+uint32_t sample);
+
+/**
+ * Defines the wiring of a device model.
+ */
+typedef struct
+{
+    uint8_t Channel;                /**< SPI channel, 0 = SPI1 */
+    uint8_t CsPort;                 /**< Chip select port slot, or SIM_NSS */
+    uint8_t CsPin;                  /**< Chip select pin */
+    uint8_t Int1Port;               /**< INT1 port slot, or SIM_ADXL345_NC */
+    uint8_t Int1Pin;                /**< INT1 pin */
+    uint8_t Int2Port;               /**< INT2 port slot, or SIM_ADXL345_NC */
+    uint8_t Int2Pin;                /**< INT2 pin */
+    SimAdxl345Waveform_t Waveform;  /**< Source, NULL holds 1 g on Z */
+    void *context;                  /**< Passed to the waveform */
+}SimAdxl345Config_t;
+
+/**
+ * Defines the sample metrics of a device. The latency of a sample runs
+ * from the cycle it is produced to the chip select release that pops it.
+ * An early read is a window that starts reading the data registers or
+ * FIFO_STATUS less than 5 us after the release of a window that popped a
+ * sample; the part may still return the old sample or entries count.
+ */
+typedef struct
+{
+    uint32_t samples;       /**< Samples produced at the output data rate */
+    uint32_t read;          /**< Samples popped by a data registers read */
+    uint32_t dropped;       /**< Samples lost to a full FIFO or overwritten */
+    uint64_t latencySum;    /**< Sum of the read latencies, in cycles */
+    uint64_t latencyMax;    /**< Worst read latency, in cycles */
+    uint32_t earlyReads;    /**< Reads started before the pop completed */
+}SimAdxl345Stats_t;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+void SIM_adxl345Attach(uint8_t Device, const SimAdxl345Config_t * const Config);
+void SIM_adxl345EventRaise(uint8_t Device, uint8_t sources);
+uint8_t SIM_adxl345RegisterGet(uint8_t Device, uint8_t address);
+SimAdxl345Stats_t SIM_adxl345StatsGet(uint8_t Device);
+void SIM_adxl345StatsReset(uint8_t Device);
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*SIM_ADXL345_H_*/
@@ -0,0 +1,448 @@
+/**
+ * @file stm32f4xx.h
+ * @author Jose Luis Figueroa
+ * @brief The host (native) replacement of the STM32F401 device header. The
+ * peripheral structs, base addresses and bit definitions follow the CMSIS
+ * device header, so the drivers build unchanged. The addresses are mapped
+ * onto the register file of the simulator and the core functions are
+ * served by its NVIC and clock model.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef STM32F4XX_H_
+#define STM32F4XX_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdint.h>
+
+/*****************************************************************************
+* Configuration Constants
+*****************************************************************************/
+#define __I                 volatile const
+#define __O                 volatile
+#define __IO                volatile
+
+/**
+ * Defines the bus base addresses. They are the device addresses, the
+ * simulator maps its register file on them.
+ */
+#define PERIPH_BASE         (0x40000000UL)
+#define APB1PERIPH_BASE     (PERIPH_BASE)
+#define APB2PERIPH_BASE     (PERIPH_BASE + 0x00010000UL)
+#define AHB1PERIPH_BASE     (PERIPH_BASE + 0x00020000UL)
+
+#define SPI2_BASE           (APB1PERIPH_BASE + 0x3800UL)
+#define SPI3_BASE           (APB1PERIPH_BASE + 0x3C00UL)
+#define PWR_BASE            (APB1PERIPH_BASE + 0x7000UL)
+#define SPI1_BASE           (APB2PERIPH_BASE + 0x3000UL)
+#define SPI4_BASE           (APB2PERIPH_BASE + 0x3400UL)
+#define SYSCFG_BASE         (APB2PERIPH_BASE + 0x3800UL)
+#define EXTI_BASE           (APB2PERIPH_BASE + 0x3C00UL)
+#define GPIOA_BASE          (AHB1PERIPH_BASE + 0x0000UL)
+#define GPIOB_BASE          (AHB1PERIPH_BASE + 0x0400UL)
+#define GPIOC_BASE          (AHB1PERIPH_BASE + 0x0800UL)
+#define GPIOD_BASE          (AHB1PERIPH_BASE + 0x0C00UL)
+#define GPIOE_BASE          (AHB1PERIPH_BASE + 0x1000UL)
+#define GPIOH_BASE          (AHB1PERIPH_BASE + 0x1C00UL)
+#define RCC_BASE            (AHB1PERIPH_BASE + 0x3800UL)
+#define FLASH_R_BASE        (AHB1PERIPH_BASE + 0x3C00UL)
+#define DMA1_BASE           (AHB1PERIPH_BASE + 0x6000UL)
+#define DMA2_BASE           (AHB1PERIPH_BASE + 0x6400UL)
+#define DMA_STREAM_OFFSET   (0x10UL)
+#define DMA_STREAM_SIZE     (0x18UL)
+
+#define DWT_BASE            (0xE0001000UL)
+#define CoreDebug_BASE      (0xE000EDF0UL)
+
+/*****************************************************************************
+* Typedefs
+*****************************************************************************/
+typedef enum
+{
+    EXTI0_IRQn          = 6,
+    EXTI1_IRQn          = 7,
+    EXTI2_IRQn          = 8,
+    EXTI3_IRQn          = 9,
+    EXTI4_IRQn          = 10,
+    DMA1_Stream0_IRQn   = 11,
+    DMA1_Stream1_IRQn   = 12,
+    DMA1_Stream2_IRQn   = 13,
+    DMA1_Stream3_IRQn   = 14,
+    DMA1_Stream4_IRQn   = 15,
+    DMA1_Stream5_IRQn   = 16,
+    DMA1_Stream6_IRQn   = 17,
+    EXTI9_5_IRQn        = 23,
+    SPI1_IRQn           = 35,
+    SPI2_IRQn           = 36,
+    EXTI15_10_IRQn      = 40,
+    DMA1_Stream7_IRQn   = 47,
+    SPI3_IRQn           = 51,
+    DMA2_Stream0_IRQn   = 56,
+    DMA2_Stream1_IRQn   = 57,
+    DMA2_Stream2_IRQn   = 58,
+    DMA2_Stream3_IRQn   = 59,
+    DMA2_Stream4_IRQn   = 60,
+    DMA2_Stream5_IRQn   = 68,
+    DMA2_Stream6_IRQn   = 69,
+    DMA2_Stream7_IRQn   = 70,
+    SPI4_IRQn           = 84
+}IRQn_Type;
+
+typedef struct
+{
+    __IO uint32_t CR1;
+    __IO uint32_t CR2;
+    __IO uint32_t SR;
+    __IO uint32_t DR;
+    __IO uint32_t CRCPR;
+    __IO uint32_t RXCRCR;
+    __IO uint32_t TXCRCR;
+    __IO uint32_t I2SCFGR;
+    __IO uint32_t I2SPR;
+}SPI_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t MODER;
+    __IO uint32_t OTYPER;
+    __IO uint32_t OSPEEDR;
+    __IO uint32_t PUPDR;
+    __IO uint32_t IDR;
+    __IO uint32_t ODR;
+    __IO uint32_t BSRR;
+    __IO uint32_t LCKR;
+    __IO uint32_t AFR[2];
+}GPIO_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR;
+    __IO uint32_t PLLCFGR;
+    __IO uint32_t CFGR;
+    __IO uint32_t CIR;
+    __IO uint32_t AHB1RSTR;
+    __IO uint32_t AHB2RSTR;
+    __IO uint32_t AHB3RSTR;
+    uint32_t      RESERVED0;
+    __IO uint32_t APB1RSTR;
+    __IO uint32_t APB2RSTR;
+    uint32_t      RESERVED1[2];
+    __IO uint32_t AHB1ENR;
+    __IO uint32_t AHB2ENR;
+    __IO uint32_t AHB3ENR;
+    uint32_t      RESERVED2;
+    __IO uint32_t APB1ENR;
+    __IO uint32_t APB2ENR;
+    uint32_t      RESERVED3[2];
+    __IO uint32_t AHB1LPENR;
+    __IO uint32_t AHB2LPENR;
+    __IO uint32_t AHB3LPENR;
+    uint32_t      RESERVED4;
+    __IO uint32_t APB1LPENR;
+    __IO uint32_t APB2LPENR;
+    uint32_t      RESERVED5[2];
+    __IO uint32_t BDCR;
+    __IO uint32_t CSR;
+    uint32_t      RESERVED6[2];
+    __IO uint32_t SSCGR;
+    __IO uint32_t PLLI2SCFGR;
+    uint32_t      RESERVED7;
+    __IO uint32_t DCKCFGR;
+}RCC_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR;
+    __IO uint32_t NDTR;
+    __IO uint32_t PAR;
+    __IO uint32_t M0AR;
+    __IO uint32_t M1AR;
+    __IO uint32_t FCR;
+}DMA_Stream_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t LISR;
+    __IO uint32_t HISR;
+    __IO uint32_t LIFCR;
+    __IO uint32_t HIFCR;
+}DMA_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t IMR;
+    __IO uint32_t EMR;
+    __IO uint32_t RTSR;
+    __IO uint32_t FTSR;
+    __IO uint32_t SWIER;
+    __IO uint32_t PR;
+}EXTI_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t MEMRMP;
+    __IO uint32_t PMC;
+    __IO uint32_t EXTICR[4];
+    uint32_t      RESERVED[2];
+    __IO uint32_t CMPCR;
+}SYSCFG_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t ACR;
+    __IO uint32_t KEYR;
+    __IO uint32_t OPTKEYR;
+    __IO uint32_t SR;
+    __IO uint32_t CR;
+    __IO uint32_t OPTCR;
+}FLASH_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CR;
+    __IO uint32_t CSR;
+}PWR_TypeDef;
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+    __IO uint32_t CPICNT;
+    __IO uint32_t EXCCNT;
+    __IO uint32_t SLEEPCNT;
+    __IO uint32_t LSUCNT;
+    __IO uint32_t FOLDCNT;
+    __I  uint32_t PCSR;
+}DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DHCSR;
+    __O  uint32_t DCRSR;
+    __IO uint32_t DCRDR;
+    __IO uint32_t DEMCR;
+}CoreDebug_Type;
+
+/*****************************************************************************
+* Peripheral Declarations
+*****************************************************************************/
+#define SPI1                ((SPI_TypeDef *) SPI1_BASE)
+#define SPI2                ((SPI_TypeDef *) SPI2_BASE)
+#define SPI3                ((SPI_TypeDef *) SPI3_BASE)
+#define SPI4                ((SPI_TypeDef *) SPI4_BASE)
+#define GPIOA               ((GPIO_TypeDef *) GPIOA_BASE)
+#define GPIOB               ((GPIO_TypeDef *) GPIOB_BASE)
+#define GPIOC               ((GPIO_TypeDef *) GPIOC_BASE)
+#define GPIOD               ((GPIO_TypeDef *) GPIOD_BASE)
+#define GPIOE               ((GPIO_TypeDef *) GPIOE_BASE)
+#define GPIOH               ((GPIO_TypeDef *) GPIOH_BASE)
+#define RCC                 ((RCC_TypeDef *) RCC_BASE)
+#define FLASH               ((FLASH_TypeDef *) FLASH_R_BASE)
+#define PWR                 ((PWR_TypeDef *) PWR_BASE)
+#define SYSCFG              ((SYSCFG_TypeDef *) SYSCFG_BASE)
+#define EXTI                ((EXTI_TypeDef *) EXTI_BASE)
+#define DMA1                ((DMA_TypeDef *) DMA1_BASE)
+#define DMA2                ((DMA_TypeDef *) DMA2_BASE)
+#define DWT                 ((DWT_Type *) DWT_BASE)
+#define CoreDebug           ((CoreDebug_Type *) CoreDebug_BASE)
+
+#define DMA_STREAM(base, n) \
+((DMA_Stream_TypeDef *)((base) + DMA_STREAM_OFFSET + ((n) * DMA_STREAM_SIZE)))
+#define DMA1_Stream0        DMA_STREAM(DMA1_BASE, 0UL)
+#define DMA1_Stream1        DMA_STREAM(DMA1_BASE, 1UL)
+#define DMA1_Stream2        DMA_STREAM(DMA1_BASE, 2UL)
+#define DMA1_Stream3        DMA_STREAM(DMA1_BASE, 3UL)
+#define DMA1_Stream4        DMA_STREAM(DMA1_BASE, 4UL)
+#define DMA1_Stream5        DMA_STREAM(DMA1_BASE, 5UL)
+#define DMA1_Stream6        DMA_STREAM(DMA1_BASE, 6UL)
+#define DMA1_Stream7        DMA_STREAM(DMA1_BASE, 7UL)
+#define DMA2_Stream0        DMA_STREAM(DMA2_BASE, 0UL)
+#define DMA2_Stream1        DMA_STREAM(DMA2_BASE, 1UL)
+#define DMA2_Stream2        DMA_STREAM(DMA2_BASE, 2UL)
+#define DMA2_Stream3        DMA_STREAM(DMA2_BASE, 3UL)
+#define DMA2_Stream4        DMA_STREAM(DMA2_BASE, 4UL)
+#define DMA2_Stream5        DMA_STREAM(DMA2_BASE, 5UL)
+#define DMA2_Stream6        DMA_STREAM(DMA2_BASE, 6UL)
+#define DMA2_Stream7        DMA_STREAM(DMA2_BASE, 7UL)
+
+/*****************************************************************************
+* Bit Definitions
+*****************************************************************************/
+/* RCC */
+#define RCC_CR_HSION                (0x1UL << 0)
+#define RCC_CR_HSIRDY               (0x1UL << 1)
+#define RCC_CR_HSEON                (0x1UL << 16)
+#define RCC_CR_HSERDY               (0x1UL << 17)
+#define RCC_CR_PLLON                (0x1UL << 24)
+#define RCC_CR_PLLRDY               (0x1UL << 25)
+
+#define RCC_PLLCFGR_PLLM_Pos        (0U)
+#define RCC_PLLCFGR_PLLM            (0x3FUL << RCC_PLLCFGR_PLLM_Pos)
+#define RCC_PLLCFGR_PLLN_Pos        (6U)
+#define RCC_PLLCFGR_PLLN            (0x1FFUL << RCC_PLLCFGR_PLLN_Pos)
+#define RCC_PLLCFGR_PLLP_Pos        (16U)
+#define RCC_PLLCFGR_PLLP            (0x3UL << RCC_PLLCFGR_PLLP_Pos)
+#define RCC_PLLCFGR_PLLSRC_Pos      (22U)
+#define RCC_PLLCFGR_PLLSRC          (0x1UL << RCC_PLLCFGR_PLLSRC_Pos)
+#define RCC_PLLCFGR_PLLSRC_HSE      (0x1UL << RCC_PLLCFGR_PLLSRC_Pos)
+#define RCC_PLLCFGR_PLLSRC_HSI      (0x0UL)
+#define RCC_PLLCFGR_PLLQ_Pos        (24U)
+#define RCC_PLLCFGR_PLLQ            (0xFUL << RCC_PLLCFGR_PLLQ_Pos)
+
+#define RCC_CFGR_SW_Pos             (0U)
+#define RCC_CFGR_SW                 (0x3UL << RCC_CFGR_SW_Pos)
+#define RCC_CFGR_SW_HSI             (0x0UL)
+#define RCC_CFGR_SW_HSE             (0x1UL)
+#define RCC_CFGR_SW_PLL             (0x2UL)
+#define RCC_CFGR_SWS_Pos            (2U)
+#define RCC_CFGR_SWS                (0x3UL << RCC_CFGR_SWS_Pos)
+#define RCC_CFGR_SWS_HSI            (0x0UL)
+#define RCC_CFGR_SWS_HSE            (0x4UL)
+#define RCC_CFGR_SWS_PLL            (0x8UL)
+#define RCC_CFGR_HPRE_Pos           (4U)
+#define RCC_CFGR_HPRE               (0xFUL << RCC_CFGR_HPRE_Pos)
+#define RCC_CFGR_HPRE_DIV1          (0x0UL)
+#define RCC_CFGR_PPRE1_Pos          (10U)
+#define RCC_CFGR_PPRE1              (0x7UL << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE1_DIV1         (0x0UL)
+#define RCC_CFGR_PPRE1_DIV2         (0x4UL << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE1_DIV4         (0x5UL << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE2_Pos          (13U)
+#define RCC_CFGR_PPRE2              (0x7UL << RCC_CFGR_PPRE2_Pos)
+#define RCC_CFGR_PPRE2_DIV1         (0x0UL)
+#define RCC_CFGR_PPRE2_DIV2         (0x4UL << RCC_CFGR_PPRE2_Pos)
+
+#define RCC_AHB1ENR_GPIOAEN         (0x1UL << 0)
+#define RCC_AHB1ENR_GPIOBEN         (0x1UL << 1)
+#define RCC_AHB1ENR_GPIOCEN         (0x1UL << 2)
+#define RCC_AHB1ENR_GPIODEN         (0x1UL << 3)
+#define RCC_AHB1ENR_GPIOEEN         (0x1UL << 4)
+#define RCC_AHB1ENR_GPIOHEN         (0x1UL << 7)
+#define RCC_AHB1ENR_DMA1EN          (0x1UL << 21)
+#define RCC_AHB1ENR_DMA2EN          (0x1UL << 22)
+#define RCC_APB1ENR_SPI2EN          (0x1UL << 14)
+#define RCC_APB1ENR_SPI3EN          (0x1UL << 15)
+#define RCC_APB1ENR_PWREN           (0x1UL << 28)
+#define RCC_APB2ENR_SPI1EN          (0x1UL << 12)
+#define RCC_APB2ENR_SPI4EN          (0x1UL << 13)
+#define RCC_APB2ENR_SYSCFGEN        (0x1UL << 14)
+
+/* FLASH and PWR */
+#define FLASH_ACR_LATENCY           (0xFUL << 0)
+#define FLASH_ACR_LATENCY_0WS       (0x0UL)
+#define FLASH_ACR_LATENCY_1WS       (0x1UL)
+#define FLASH_ACR_LATENCY_2WS       (0x2UL)
+#define FLASH_ACR_PRFTEN            (0x1UL << 8)
+#define FLASH_ACR_ICEN              (0x1UL << 9)
+#define FLASH_ACR_DCEN              (0x1UL << 10)
+#define PWR_CR_VOS                  (0x3UL << 14)
+#define PWR_CR_VOS_0                (0x1UL << 14)
+#define PWR_CR_VOS_1                (0x2UL << 14)
+#define PWR_CSR_VOSRDY              (0x1UL << 14)
+
+/* SPI */
+#define SPI_CR1_CPHA_Pos            (0U)
+#define SPI_CR1_CPHA                (0x1UL << SPI_CR1_CPHA_Pos)
+#define SPI_CR1_CPOL_Pos            (1U)
+#define SPI_CR1_CPOL                (0x1UL << SPI_CR1_CPOL_Pos)
+#define SPI_CR1_MSTR_Pos            (2U)
+#define SPI_CR1_MSTR                (0x1UL << SPI_CR1_MSTR_Pos)
+#define SPI_CR1_BR_Pos              (3U)
+#define SPI_CR1_BR                  (0x7UL << SPI_CR1_BR_Pos)
+#define SPI_CR1_BR_0                (0x1UL << SPI_CR1_BR_Pos)
+#define SPI_CR1_BR_1                (0x2UL << SPI_CR1_BR_Pos)
+#define SPI_CR1_BR_2                (0x4UL << SPI_CR1_BR_Pos)
+#define SPI_CR1_SPE_Pos             (6U)
+#define SPI_CR1_SPE                 (0x1UL << SPI_CR1_SPE_Pos)
+#define SPI_CR1_LSBFIRST_Pos        (7U)
+#define SPI_CR1_LSBFIRST            (0x1UL << SPI_CR1_LSBFIRST_Pos)
+#define SPI_CR1_SSI                 (0x1UL << 8)
+#define SPI_CR1_SSM                 (0x1UL << 9)
+#define SPI_CR1_RXONLY_Pos          (10U)
+#define SPI_CR1_RXONLY              (0x1UL << SPI_CR1_RXONLY_Pos)
+#define SPI_CR1_DFF_Pos             (11U)
+#define SPI_CR1_DFF                 (0x1UL << SPI_CR1_DFF_Pos)
+#define SPI_CR1_BIDIOE              (0x1UL << 14)
+#define SPI_CR1_BIDIMODE            (0x1UL << 15)
+
+#define SPI_CR2_RXDMAEN             (0x1UL << 0)
+#define SPI_CR2_TXDMAEN             (0x1UL << 1)
+#define SPI_CR2_SSOE                (0x1UL << 2)
+#define SPI_CR2_FRF                 (0x1UL << 4)
+#define SPI_CR2_ERRIE               (0x1UL << 5)
+#define SPI_CR2_RXNEIE              (0x1UL << 6)
+#define SPI_CR2_TXEIE               (0x1UL << 7)
+
+#define SPI_SR_RXNE                 (0x1UL << 0)
+#define SPI_SR_TXE                  (0x1UL << 1)
+#define SPI_SR_MODF                 (0x1UL << 5)
+#define SPI_SR_OVR                  (0x1UL << 6)
+#define SPI_SR_BSY                  (0x1UL << 7)
+
+/* DMA */
+#define DMA_SxCR_EN                 (0x1UL << 0)
+#define DMA_SxCR_TEIE               (0x1UL << 2)
+#define DMA_SxCR_TCIE               (0x1UL << 4)
+#define DMA_SxCR_DIR_Pos            (6U)
+#define DMA_SxCR_DIR                (0x3UL << DMA_SxCR_DIR_Pos)
+#define DMA_SxCR_DIR_0              (0x1UL << DMA_SxCR_DIR_Pos)
+#define DMA_SxCR_DIR_1              (0x2UL << DMA_SxCR_DIR_Pos)
+#define DMA_SxCR_CIRC               (0x1UL << 8)
+#define DMA_SxCR_PINC               (0x1UL << 9)
+#define DMA_SxCR_MINC               (0x1UL << 10)
+#define DMA_SxCR_PSIZE_Pos          (11U)
+#define DMA_SxCR_PSIZE              (0x3UL << DMA_SxCR_PSIZE_Pos)
+#define DMA_SxCR_PSIZE_0            (0x1UL << DMA_SxCR_PSIZE_Pos)
+#define DMA_SxCR_PSIZE_1            (0x2UL << DMA_SxCR_PSIZE_Pos)
+#define DMA_SxCR_MSIZE_Pos          (13U)
+#define DMA_SxCR_MSIZE              (0x3UL << DMA_SxCR_MSIZE_Pos)
+#define DMA_SxCR_MSIZE_0            (0x1UL << DMA_SxCR_MSIZE_Pos)
+#define DMA_SxCR_MSIZE_1            (0x2UL << DMA_SxCR_MSIZE_Pos)
+#define DMA_SxCR_PL_0               (0x1UL << 16)
+#define DMA_SxCR_PL_1               (0x2UL << 16)
+#define DMA_SxCR_CHSEL_Pos          (25U)
+#define DMA_SxCR_CHSEL              (0x7UL << DMA_SxCR_CHSEL_Pos)
+
+/* EXTI and SYSCFG */
+#define EXTI_IMR_MR0                (0x1UL << 0)
+#define EXTI_RTSR_TR0               (0x1UL << 0)
+#define EXTI_FTSR_TR0               (0x1UL << 0)
+#define EXTI_PR_PR0                 (0x1UL << 0)
+#define SYSCFG_EXTICR1_EXTI0        (0xFUL << 0)
+
+/* Core debug */
+#define DWT_CTRL_CYCCNTENA_Pos      (0U)
+#define DWT_CTRL_CYCCNTENA_Msk      (0x1UL << DWT_CTRL_CYCCNTENA_Pos)
+#define CoreDebug_DEMCR_TRCENA_Pos  (24U)
+#define CoreDebug_DEMCR_TRCENA_Msk  (0x1UL << CoreDebug_DEMCR_TRCENA_Pos)
+
+/* Core intrinsics, as cmsis_gcc.h defines them */
+#define __CLZ                       (uint8_t)__builtin_clz
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+#ifdef __cplusplus
+extern "C"{
+#endif
+
+/* Core functions, served by the simulated NVIC and clock */
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t priMask);
+void __WFI(void);
+
+#ifdef __cplusplus
+} // extern C
+#endif
+
+#endif /*STM32F4XX_H_*/
@@ -0,0 +1,1020 @@
+/**
+ * @file sim.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation of the simulator core. The peripheral address
+ * space is mapped at the device addresses, so the register pointers of the
+ * drivers and the 32 bits addresses of SPI_registerWrite and
+ * DIO_registerWrite stay valid on the host. The pages of the modelled
+ * peripherals are kept inaccessible: each load or store faults, the model
+ * brings the register up to date, the access is single stepped and the
+ * model sees the result. The core also holds the simulated clock, the RCC
+ * and DWT models and the NVIC.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#define _GNU_SOURCE
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include "sim_bus.h"
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "The simulator traps the register accesses on x86-64 Linux"
+#endif
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Page granularity of the access traps*/
+#define PAGE_SIZE           (0x1000UL)
+/** Page fault error code bit of a store*/
+#define FAULT_WRITE         (0x2UL)
+/** EFLAGS trap flag, single steps the faulting access*/
+#define TRAP_FLAG           (0x100UL)
+/** Interrupt lines of the NVIC*/
+#define NVIC_LINES          (96U)
+/** Longest skip of a polling loop, bounds the error of a driver timeout*/
+#define SPIN_CYCLES         (256U)
+/** Oscillators, HSE is the 8 MHz MCO of the Nucleo ST-LINK*/
+#define HSI_HZ              (16000000UL)
+#define HSE_HZ              (8000000UL)
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE (0x100000)
+#endif
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines a window of the device address space backed by the register
+ * file.
+ */
+typedef struct
+{
+    uint32_t base;      /**< Device address of the window */
+    uint32_t size;      /**< Size of the window */
+    size_t offset;      /**< Offset of the window in the register file */
+}SimWindow_t;
+
+/**
+ * Defines an interrupt vector with the model line that raises it.
+ */
+typedef struct
+{
+    IRQn_Type Irq;                      /**< NVIC line */
+    void (*handler)(void);              /**< Interrupt handler */
+    uint8_t (*pending)(uint32_t arg);   /**< Line level of the model */
+    uint32_t arg;                       /**< Channel, stream or lines */
+}SimVector_t;
+
+/**
+ * Defines the access being single stepped.
+ */
+typedef struct
+{
+    uint8_t pending;                    /**< Access between fault and step */
+    uint8_t write;                      /**< The access is a store */
+    uint32_t address;                   /**< Register address */
+    uint32_t previous;                  /**< Register value before it */
+    const SimRegion_t *Region;          /**< Model of the register */
+}SimAccess_t;
+
+/**
+ * Defines the last load, to find a polling loop.
+ */
+typedef struct
+{
+    uint32_t address;                   /**< Register loaded */
+    uint32_t value;                     /**< Value loaded */
+    uint32_t epoch;                     /**< State changes before the load */
+}SimSpin_t;
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Device address windows, the peripherals buses and the private bus*/
+static const SimWindow_t window[] =
+{
+    {PERIPH_BASE, 0x00030000UL, 0x00000000UL},
+    {0xE0000000UL, 0x00010000UL, 0x00030000UL}
+};
+
+/** Size of the register file*/
+#define REGISTER_FILE_SIZE  (0x00040000UL)
+
+/** Interrupt handlers of the drivers, NULL when a driver does not serve it*/
+extern void EXTI0_IRQHandler(void) __attribute__((weak));
+extern void EXTI1_IRQHandler(void) __attribute__((weak));
+extern void EXTI2_IRQHandler(void) __attribute__((weak));
+extern void EXTI3_IRQHandler(void) __attribute__((weak));
+extern void EXTI4_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream0_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream1_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream2_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream3_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream4_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream5_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream6_IRQHandler(void) __attribute__((weak));
+extern void EXTI9_5_IRQHandler(void) __attribute__((weak));
+extern void SPI1_IRQHandler(void) __attribute__((weak));
+extern void SPI2_IRQHandler(void) __attribute__((weak));
+extern void EXTI15_10_IRQHandler(void) __attribute__((weak));
+extern void DMA1_Stream7_IRQHandler(void) __attribute__((weak));
+extern void SPI3_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream0_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream1_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream2_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream3_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream4_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream5_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream6_IRQHandler(void) __attribute__((weak));
+extern void DMA2_Stream7_IRQHandler(void) __attribute__((weak));
+extern void SPI4_IRQHandler(void) __attribute__((weak));
+
+/** Vector table in priority order, the lowest line is served first*/
+static const SimVector_t vector[] =
+{
+    {EXTI0_IRQn, EXTI0_IRQHandler, SIM_extiIrqPending, 1UL << 0},
+    {EXTI1_IRQn, EXTI1_IRQHandler, SIM_extiIrqPending, 1UL << 1},
+    {EXTI2_IRQn, EXTI2_IRQHandler, SIM_extiIrqPending, 1UL << 2},
+    {EXTI3_IRQn, EXTI3_IRQHandler, SIM_extiIrqPending, 1UL << 3},
+    {EXTI4_IRQn, EXTI4_IRQHandler, SIM_extiIrqPending, 1UL << 4},
+    {DMA1_Stream0_IRQn, DMA1_Stream0_IRQHandler, SIM_dmaIrqPending, 0U},
+    {DMA1_Stream1_IRQn, DMA1_Stream1_IRQHandler, SIM_dmaIrqPending, 1U},
+    {DMA1_Stream2_IRQn, DMA1_Stream2_IRQHandler, SIM_dmaIrqPending, 2U},
+    {DMA1_Stream3_IRQn, DMA1_Stream3_IRQHandler, SIM_dmaIrqPending, 3U},
+    {DMA1_Stream4_IRQn, DMA1_Stream4_IRQHandler, SIM_dmaIrqPending, 4U},
+    {DMA1_Stream5_IRQn, DMA1_Stream5_IRQHandler, SIM_dmaIrqPending, 5U},
+    {DMA1_Stream6_IRQn, DMA1_Stream6_IRQHandler, SIM_dmaIrqPending, 6U},
+    {EXTI9_5_IRQn, EXTI9_5_IRQHandler, SIM_extiIrqPending, 0x03E0UL},
+    {SPI1_IRQn, SPI1_IRQHandler, SIM_spiIrqPending, 0U},
+    {SPI2_IRQn, SPI2_IRQHandler, SIM_spiIrqPending, 1U},
+    {EXTI15_10_IRQn, EXTI15_10_IRQHandler, SIM_extiIrqPending, 0xFC00UL},
+    {DMA1_Stream7_IRQn, DMA1_Stream7_IRQHandler, SIM_dmaIrqPending, 7U},
+    {SPI3_IRQn, SPI3_IRQHandler, SIM_spiIrqPending, 2U},
+    {DMA2_Stream0_IRQn, DMA2_Stream0_IRQHandler, SIM_dmaIrqPending, 8U},
+    {DMA2_Stream1_IRQn, DMA2_Stream1_IRQHandler, SIM_dmaIrqPending, 9U},
+    {DMA2_Stream2_IRQn, DMA2_Stream2_IRQHandler, SIM_dmaIrqPending, 10U},
+    {DMA2_Stream3_IRQn, DMA2_Stream3_IRQHandler, SIM_dmaIrqPending, 11U},
+    {DMA2_Stream4_IRQn, DMA2_Stream4_IRQHandler, SIM_dmaIrqPending, 12U},
+    {DMA2_Stream5_IRQn, DMA2_Stream5_IRQHandler, SIM_dmaIrqPending, 13U},
+    {DMA2_Stream6_IRQn, DMA2_Stream6_IRQHandler, SIM_dmaIrqPending, 14U},
+    {DMA2_Stream7_IRQn, DMA2_Stream7_IRQHandler, SIM_dmaIrqPending, 15U},
+    {SPI4_IRQn, SPI4_IRQHandler, SIM_spiIrqPending, 3U}
+};
+
+/** Host view of the register file, never trapped*/
+static uint8_t *registerFile;
+
+/** Register regions attached by the models*/
+static const SimRegion_t *region[SIM_REGIONS];
+static uint8_t regionCount;
+
+/** Models run by the clock*/
+static SimClient_t client[SIM_CLIENTS];
+static uint8_t clientCount;
+
+/** Simulated CPU clock, in HCLK cycles*/
+static uint64_t cycles;
+
+/** Clock value at which CYCCNT read zero*/
+static uint64_t cyccntBase;
+
+/** Access between its fault and its single step*/
+static SimAccess_t trap;
+
+/** Stores, events and interrupts so far, and the last load*/
+static uint32_t epoch;
+static SimSpin_t spin;
+
+/** NVIC state*/
+static uint32_t nvicEnabled[NVIC_LINES / 32U];
+static uint32_t primask;
+static uint8_t handlerActive;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void SIM_boot(void) __attribute__((constructor));
+static void SIM_fatal(const char *message, uint32_t address);
+static uint8_t SIM_trapped(uintptr_t address);
+static const SimRegion_t * SIM_regionFind(uint32_t address);
+static void SIM_pageProtect(uint32_t address, int protection);
+static void SIM_faultHandler(int signal, siginfo_t *Info, void *context);
+static void SIM_stepHandler(int signal, siginfo_t *Info, void *context);
+static void SIM_spinCheck(uint32_t address, uint32_t value);
+static uint64_t SIM_eventNext(void);
+static const SimVector_t * SIM_irqNext(void);
+static void SIM_irqService(void);
+static void SIM_rccWrite(uint32_t address, uint32_t previous);
+static void SIM_dwtRead(uint32_t address);
+static void SIM_dwtWrite(uint32_t address, uint32_t previous);
+
+/** RCC model, the oscillators and the PLL are ready as soon as enabled*/
+static const SimRegion_t RccRegion =
+{
+    RCC_BASE, sizeof(RCC_TypeDef), NULL, NULL, SIM_rccWrite
+};
+
+/** DWT model, CYCCNT follows the simulated clock*/
+static const SimRegion_t DwtRegion =
+{
+    DWT_BASE, sizeof(DWT_Type), SIM_dwtRead, NULL, SIM_dwtWrite
+};
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SIM_cyclesGet()
+*//**
+*\b Description:
+ * This function is used to get the simulated CPU clock. It is the value
+ * DWT->CYCCNT counts on, widened to 64 bits.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The number of HCLK cycles since start up is returned.
+ * <br>
+ *
+ * @return  The simulated CPU cycles.
+ *
+ * \b Example:
+ * @code
+ * const uint64_t start = SIM_cyclesGet();
+ * SPI_transceive(&TransceiveConfig);
+ * const uint64_t elapsed = SIM_cyclesGet() - start;
+ * @endcode
+ *
+ * @see SIM_cyclesGet
+ * @see SIM_clockAdvance
+ *
+*****************************************************************************/
+uint64_t SIM_cyclesGet(void)
+{
+    return cycles;
+}
+
+/*****************************************************************************
+ * Function: SIM_hclkGet()
+*//**
+*\b Description:
+ * This function is used to get the frequency of the simulated clock from
+ * the RCC registers, so the models can pace real time events such as an
+ * output data rate in CPU cycles.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The HCLK frequency selected by the RCC is returned. <br>
+ *
+ * @return  The HCLK frequency in Hz.
+ *
+ * \b Example:
+ * @code
+ * const uint64_t period = SIM_hclkGet() / 3200U;   // 3200 Hz in cycles
+ * @endcode
+ *
+ * @see SIM_cyclesGet
+ * @see SIM_hclkGet
+ *
+*****************************************************************************/
+uint32_t SIM_hclkGet(void)
+{
+    const uint32_t cfgr = SIM_REG(SIM_ADDRESS(RCC_BASE, RCC_TypeDef, CFGR));
+    const uint32_t pllcfgr =
+    SIM_REG(SIM_ADDRESS(RCC_BASE, RCC_TypeDef, PLLCFGR));
+    uint32_t sysclk = HSI_HZ;
+
+    if((cfgr & RCC_CFGR_SWS) == RCC_CFGR_SWS_HSE)
+    {
+        sysclk = HSE_HZ;
+    }
+    else if((cfgr & RCC_CFGR_SWS) == RCC_CFGR_SWS_PLL)
+    {
+        const uint32_t input = (pllcfgr & RCC_PLLCFGR_PLLSRC) ? HSE_HZ :
+        HSI_HZ;
+        const uint32_t m = (pllcfgr & RCC_PLLCFGR_PLLM) >>
+        RCC_PLLCFGR_PLLM_Pos;
+        const uint32_t n = (pllcfgr & RCC_PLLCFGR_PLLN) >>
+        RCC_PLLCFGR_PLLN_Pos;
+        const uint32_t p = (((pllcfgr & RCC_PLLCFGR_PLLP) >>
+        RCC_PLLCFGR_PLLP_Pos) + 1U) * 2U;
+
+        if(m == 0U)
+        {
+            SIM_fatal("PLLM out of range", pllcfgr);
+        }
+        sysclk = (uint32_t)(((uint64_t)input / m * n) / p);
+    }
+
+    /* HPRE 8 to 15 divides by 2 to 512, 32 is skipped*/
+    const uint32_t hpre = (cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos;
+    if(hpre >= 8U)
+    {
+        const uint32_t shift = (hpre - 7U) + ((hpre >= 12U) ? 1U : 0U);
+        sysclk >>= shift;
+    }
+
+    return sysclk;
+}
+
+/*****************************************************************************
+ * Function: SIM_clockAdvance()
+*//**
+*\b Description:
+ * This function is used to let time pass outside of the drivers, as the
+ * CPU running application code would. The models run their events and the
+ * interrupts they raise are served as they come.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The clock is advanced by the number of cycles. <br>
+ *
+ * @param[in]   delta is the number of CPU cycles.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SIM_clockAdvance(80000U);     // 1 ms at 80 MHz
+ * @endcode
+ *
+ * @see SIM_cyclesGet
+ * @see SIM_clockAdvance
+ *
+*****************************************************************************/
+void SIM_clockAdvance(uint64_t delta)
+{
+    const uint64_t target = cycles + delta;
+    uint64_t next;
+
+    while((next = SIM_eventNext()) <= target)
+    {
+        SIM_clockRun(next);
+        SIM_irqService();
+    }
+
+    SIM_clockRun(target);
+    SIM_irqService();
+}
+
+/*****************************************************************************
+ * Function: SIM_clientAttach()
+*//**
+*\b Description:
+ * This function is used to attach a model to the simulated clock. Its
+ * events are run in time order with the events of the peripherals.
+ *
+ * PRE-CONDITION: Less than SIM_CLIENTS clients are attached. <br>
+ *
+ * POST-CONDITION: The model is run by the clock. <br>
+ *
+ * @param[in]   Client is the model, copied by the simulator.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * const SimClient_t Stimulus = {stimulusNext, stimulusAdvance, &state};
+ * SIM_clientAttach(&Stimulus);
+ * @endcode
+ *
+ * @see SIM_clientAttach
+ * @see SIM_spiAttach
+ *
+*****************************************************************************/
+void SIM_clientAttach(const SimClient_t * const Client)
+{
+    /* Prevent to write out of the client table*/
+    if(clientCount >= SIM_CLIENTS)
+    {
+        SIM_fatal("too many clock clients", 0U);
+    }
+
+    client[clientCount++] = *Client;
+}
+
+/*****************************************************************************
+ * Function: SIM_registerGet()
+*//**
+*\b Description:
+ * This function is used to get the backdoor of a register, the host view
+ * of the register file that is never trapped.
+ *
+ * @param[in]   address is the device address of the register.
+ *
+ * @return  A pointer to the register.
+ *
+*****************************************************************************/
+volatile uint32_t * SIM_registerGet(uint32_t address)
+{
+    for(size_t i = 0; i < (sizeof(window) / sizeof(window[0])); i++)
+    {
+        if((address - window[i].base) < window[i].size)
+        {
+            return (volatile uint32_t *)(registerFile + window[i].offset +
+            (address - window[i].base));
+        }
+    }
+
+    SIM_fatal("register out of the peripheral windows", address);
+    return NULL;
+}
+
+/*****************************************************************************
+ * Function: SIM_regionAttach()
+*//**
+*\b Description:
+ * This function is used to attach the register region of a model to the
+ * bus. The pages holding the region are trapped from now on.
+ *
+ * @param[in]   Region is the region, it must outlive the simulation.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+void SIM_regionAttach(const SimRegion_t * const Region)
+{
+    if(regionCount >= SIM_REGIONS)
+    {
+        SIM_fatal("too many register regions", Region->base);
+    }
+
+    region[regionCount++] = Region;
+    for(uint32_t page = Region->base & ~(PAGE_SIZE - 1UL);
+    page < (Region->base + Region->size); page += PAGE_SIZE)
+    {
+        SIM_pageProtect(page, PROT_NONE);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_clockRun()
+*//**
+*\b Description:
+ * This function is used to run the events of the models up to a cycle, in
+ * time order. Interrupts are not served, the caller decides when.
+ *
+ * @param[in]   cycle is the clock value to reach.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+void SIM_clockRun(uint64_t cycle)
+{
+    uint64_t next;
+
+    while((next = SIM_eventNext()) <= cycle)
+    {
+        if(next > cycles)
+        {
+            cycles = next;
+        }
+
+        for(uint8_t i = 0; i < clientCount; i++)
+        {
+            client[i].advance(client[i].context, next);
+        }
+        epoch++;
+    }
+
+    if(cycle > cycles)
+    {
+        cycles = cycle;
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_boot()
+*//**
+*\b Description:
+ * This function is used to bring up the simulator before main. The
+ * register file is mapped twice: at the device addresses for the drivers
+ * and anywhere for the models. The registers are set to their reset
+ * values and the models attach their regions.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_boot(void)
+{
+    const int file = memfd_create("stm32f401", 0);
+
+    if((file < 0) || (ftruncate(file, REGISTER_FILE_SIZE) != 0))
+    {
+        SIM_fatal("register file not created", 0U);
+    }
+
+    registerFile = mmap(NULL, REGISTER_FILE_SIZE, PROT_READ | PROT_WRITE,
+    MAP_SHARED, file, 0);
+    if(registerFile == MAP_FAILED)
+    {
+        SIM_fatal("register file not mapped", 0U);
+    }
+
+    for(size_t i = 0; i < (sizeof(window) / sizeof(window[0])); i++)
+    {
+        void * const device = (void *)(uintptr_t)window[i].base;
+        if(mmap(device, window[i].size, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_FIXED_NOREPLACE, file, (off_t)window[i].offset) !=
+        device)
+        {
+            SIM_fatal("peripheral window not mapped", window[i].base);
+        }
+    }
+    close(file);
+
+    /* Reset values of the registers read before they are written*/
+    SIM_REG(SIM_ADDRESS(RCC_BASE, RCC_TypeDef, CR)) = 0x00000083UL;
+    SIM_REG(SIM_ADDRESS(RCC_BASE, RCC_TypeDef, PLLCFGR)) = 0x24003010UL;
+    SIM_REG(SIM_ADDRESS(PWR_BASE, PWR_TypeDef, CR)) = 0x00004000UL;
+
+    struct sigaction Action;
+    memset(&Action, 0, sizeof(Action));
+    Action.sa_flags = SA_SIGINFO | SA_NODEFER;
+    Action.sa_sigaction = SIM_faultHandler;
+    sigaction(SIGSEGV, &Action, NULL);
+    Action.sa_sigaction = SIM_stepHandler;
+    sigaction(SIGTRAP, &Action, NULL);
+
+    SIM_regionAttach(&RccRegion);
+    SIM_regionAttach(&DwtRegion);
+    SIM_gpioInit();
+    SIM_spiInit();
+}
+
+/*****************************************************************************
+ * Function: SIM_fatal()
+*//**
+*\b Description:
+ * This function is used to stop the simulation on a misuse of the
+ * simulated hardware.
+ *
+ * @param[in]   message describes the misuse.
+ * @param[in]   address is the register involved, or 0.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_fatal(const char *message, uint32_t address)
+{
+    fprintf(stderr, "sim: %s (0x%08lx)\n", message, (unsigned long)address);
+    abort();
+}
+
+/*****************************************************************************
+ * Function: SIM_trapped()
+*//**
+*\b Description:
+ * This function is used to know if a faulting address is a register of a
+ * trapped page, any other fault is a real one.
+ *
+ * @param[in]   address is the faulting address.
+ *
+ * @return  1 when the address is trapped, 0 otherwise.
+ *
+*****************************************************************************/
+static uint8_t SIM_trapped(uintptr_t address)
+{
+    for(uint8_t i = 0; i < regionCount; i++)
+    {
+        const uintptr_t first = region[i]->base & ~(PAGE_SIZE - 1UL);
+        const uintptr_t last = (region[i]->base + region[i]->size +
+        PAGE_SIZE - 1UL) & ~(PAGE_SIZE - 1UL);
+
+        if((address >= first) && (address < last))
+        {
+            return 1U;
+        }
+    }
+
+    return 0U;
+}
+
+/*****************************************************************************
+ * Function: SIM_regionFind()
+*//**
+*\b Description:
+ * This function is used to get the model of a register.
+ *
+ * @param[in]   address is the register address.
+ *
+ * @return  The region, or NULL for a register without a model.
+ *
+*****************************************************************************/
+static const SimRegion_t * SIM_regionFind(uint32_t address)
+{
+    for(uint8_t i = 0; i < regionCount; i++)
+    {
+        if((address - region[i]->base) < region[i]->size)
+        {
+            return region[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************
+ * Function: SIM_pageProtect()
+*//**
+*\b Description:
+ * This function is used to change the access of the device view of a
+ * page.
+ *
+ * @param[in]   address is an address in the page.
+ * @param[in]   protection is PROT_NONE or PROT_READ | PROT_WRITE.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_pageProtect(uint32_t address, int protection)
+{
+    void * const page = (void *)(uintptr_t)(address & ~(PAGE_SIZE - 1UL));
+
+    if(mprotect(page, PAGE_SIZE, protection) != 0)
+    {
+        SIM_fatal("page protection not changed", address);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_faultHandler()
+*//**
+*\b Description:
+ * This function is used to take a register access. The clock is charged
+ * for the access, the models run up to it and the register is refreshed.
+ * The page is opened and the access single stepped.
+ *
+ * @param[in]   signal is SIGSEGV.
+ * @param[in]   Info holds the faulting address.
+ * @param[in]   context is the interrupted context.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_faultHandler(int signal, siginfo_t *Info, void *context)
+{
+    ucontext_t * const Context = context;
+    const uintptr_t fault = (uintptr_t)Info->si_addr;
+
+    /* A fault out of the trapped pages is a bug of the program*/
+    if(trap.pending || !SIM_trapped(fault))
+    {
+        struct sigaction Default;
+        memset(&Default, 0, sizeof(Default));
+        Default.sa_handler = SIG_DFL;
+        sigaction(signal, &Default, NULL);
+        return;
+    }
+
+    trap.pending = 1U;
+    trap.address = (uint32_t)fault & ~3UL;
+    trap.write = (Context->uc_mcontext.gregs[REG_ERR] & FAULT_WRITE) ?
+    1U : 0U;
+    trap.Region = SIM_regionFind(trap.address);
+
+    cycles += SIM_ACCESS_CYCLES;
+    SIM_clockRun(cycles);
+
+    /* Read-modify-write stores read the register first as well*/
+    if((trap.Region != NULL) && (trap.Region->read != NULL))
+    {
+        trap.Region->read(trap.address);
+    }
+    trap.previous = SIM_REG(trap.address);
+
+    SIM_pageProtect(trap.address, PROT_READ | PROT_WRITE);
+    Context->uc_mcontext.gregs[REG_EFL] |= TRAP_FLAG;
+}
+
+/*****************************************************************************
+ * Function: SIM_stepHandler()
+*//**
+*\b Description:
+ * This function is used to complete a register access once it is single
+ * stepped. The page is closed again, the model sees the store or the load
+ * and the interrupts raised are served.
+ *
+ * @param[in]   signal is SIGTRAP.
+ * @param[in]   Info is not used.
+ * @param[in]   context is the interrupted context.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_stepHandler(int signal, siginfo_t *Info, void *context)
+{
+    ucontext_t * const Context = context;
+    (void)signal;
+    (void)Info;
+
+    if(!trap.pending)
+    {
+        return;
+    }
+
+    Context->uc_mcontext.gregs[REG_EFL] &= ~TRAP_FLAG;
+    SIM_pageProtect(trap.address, PROT_NONE);
+    trap.pending = 0U;
+
+    const SimRegion_t * const Region = trap.Region;
+    const uint32_t value = SIM_REG(trap.address);
+    const uint8_t stored = trap.write || (value != trap.previous);
+    if(Region != NULL)
+    {
+        if(stored)
+        {
+            if(Region->write != NULL)
+            {
+                Region->write(trap.address, trap.previous);
+            }
+        }
+        else if(Region->readDone != NULL)
+        {
+            Region->readDone(trap.address);
+        }
+    }
+
+    if(stored)
+    {
+        epoch++;
+    }
+    else if(Region != &DwtRegion)
+    {
+        SIM_spinCheck(trap.address, value);
+    }
+
+    SIM_irqService();
+}
+
+/*****************************************************************************
+ * Function: SIM_spinCheck()
+*//**
+*\b Description:
+ * This function is used to let the time of a polling loop pass at once. A
+ * load that repeats the last one, same register and same value with no
+ * store, event or interrupt in between, can only change at the next event,
+ * so the clock moves there, by SPIN_CYCLES at most. The loop takes the
+ * same simulated time with far fewer traps. CYCCNT is not a candidate, it
+ * changes with the time itself.
+ *
+ * @param[in]   address is the register loaded.
+ * @param[in]   value is the value loaded.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spinCheck(uint32_t address, uint32_t value)
+{
+    if((address == spin.address) && (value == spin.value) &&
+    (epoch == spin.epoch))
+    {
+        const uint64_t next = SIM_eventNext();
+        const uint64_t limit = cycles + SPIN_CYCLES;
+
+        SIM_clockRun((next < limit) ? next : limit);
+    }
+
+    spin.address = address;
+    spin.value = value;
+    spin.epoch = epoch;
+}
+
+/*****************************************************************************
+ * Function: SIM_eventNext()
+*//**
+*\b Description:
+ * This function is used to get the cycle of the next event of the models.
+ *
+ * @return  The cycle, or SIM_NEVER.
+ *
+*****************************************************************************/
+static uint64_t SIM_eventNext(void)
+{
+    uint64_t next = SIM_NEVER;
+
+    for(uint8_t i = 0; i < clientCount; i++)
+    {
+        const uint64_t event = client[i].nextEvent(client[i].context);
+        if(event < next)
+        {
+            next = event;
+        }
+    }
+
+    return next;
+}
+
+/*****************************************************************************
+ * Function: SIM_irqNext()
+*//**
+*\b Description:
+ * This function is used to get the enabled interrupt with the highest
+ * priority whose line is raised.
+ *
+ * @return  The vector, or NULL when none is pending.
+ *
+*****************************************************************************/
+static const SimVector_t * SIM_irqNext(void)
+{
+    for(size_t i = 0; i < (sizeof(vector) / sizeof(vector[0])); i++)
+    {
+        const uint32_t line = (uint32_t)vector[i].Irq;
+
+        if((nvicEnabled[line / 32U] & (1UL << (line % 32U))) &&
+        vector[i].pending(vector[i].arg))
+        {
+            return &vector[i];
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************
+ * Function: SIM_irqService()
+*//**
+*\b Description:
+ * This function is used to take the pending interrupts. Handlers run to
+ * completion, one priority level as the drivers use, and are tail chained
+ * while a line stays raised.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_irqService(void)
+{
+    const SimVector_t *Vector;
+
+    if(primask || handlerActive || trap.pending)
+    {
+        return;
+    }
+
+    handlerActive = 1U;
+    while((Vector = SIM_irqNext()) != NULL)
+    {
+        if(Vector->handler == NULL)
+        {
+            SIM_fatal("interrupt without a handler", (uint32_t)Vector->Irq);
+        }
+
+        cycles += SIM_IRQ_ENTRY_CYCLES;
+        SIM_clockRun(cycles);
+        epoch++;
+        Vector->handler();
+        cycles += SIM_IRQ_EXIT_CYCLES;
+        SIM_clockRun(cycles);
+    }
+    handlerActive = 0U;
+}
+
+/*****************************************************************************
+ * Function: SIM_rccWrite()
+*//**
+*\b Description:
+ * This function is used to model the RCC. The ready flags follow the
+ * enable bits and the clock switch status follows the switch. The
+ * regulator scale of PWR is ready while the PLL is on.
+ *
+ * @param[in]   address is the register written.
+ * @param[in]   previous is not used.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_rccWrite(uint32_t address, uint32_t previous)
+{
+    volatile uint32_t * const Register = SIM_registerGet(address);
+    (void)previous;
+
+    if(address == SIM_ADDRESS(RCC_BASE, RCC_TypeDef, CR))
+    {
+        const uint32_t enable = RCC_CR_HSION | RCC_CR_HSEON | RCC_CR_PLLON;
+        *Register = (*Register & enable) | ((*Register & enable) << 1);
+
+        volatile uint32_t * const Csr =
+        SIM_registerGet(SIM_ADDRESS(PWR_BASE, PWR_TypeDef, CSR));
+        *Csr = (*Register & RCC_CR_PLLON) ? (*Csr | PWR_CSR_VOSRDY) :
+        (*Csr & ~PWR_CSR_VOSRDY);
+    }
+    else if(address == SIM_ADDRESS(RCC_BASE, RCC_TypeDef, CFGR))
+    {
+        *Register = (*Register & ~RCC_CFGR_SWS) |
+        ((*Register & RCC_CFGR_SW) << RCC_CFGR_SWS_Pos);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_dwtRead()
+*//**
+*\b Description:
+ * This function is used to present the simulated clock on CYCCNT.
+ *
+ * @param[in]   address is the register read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_dwtRead(uint32_t address)
+{
+    if(address == SIM_ADDRESS(DWT_BASE, DWT_Type, CYCCNT))
+    {
+        SIM_REG(address) = (uint32_t)(cycles - cyccntBase);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_dwtWrite()
+*//**
+*\b Description:
+ * This function is used to restart CYCCNT from the value written.
+ *
+ * @param[in]   address is the register written.
+ * @param[in]   previous is not used.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_dwtWrite(uint32_t address, uint32_t previous)
+{
+    (void)previous;
+
+    if(address == SIM_ADDRESS(DWT_BASE, DWT_Type, CYCCNT))
+    {
+        cyccntBase = cycles - SIM_REG(address);
+    }
+}
+
+/*****************************************************************************
+* Core Functions
+*****************************************************************************/
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    nvicEnabled[(uint32_t)IRQn / 32U] |= (1UL << ((uint32_t)IRQn % 32U));
+    SIM_irqService();
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    nvicEnabled[(uint32_t)IRQn / 32U] &= ~(1UL << ((uint32_t)IRQn % 32U));
+}
+
+uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn)
+{
+    return (nvicEnabled[(uint32_t)IRQn / 32U] >> ((uint32_t)IRQn % 32U)) &
+    1UL;
+}
+
+void __disable_irq(void)
+{
+    primask = 1U;
+}
+
+void __enable_irq(void)
+{
+    primask = 0U;
+    SIM_irqService();
+}
+
+uint32_t __get_PRIMASK(void)
+{
+    return primask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    primask = priMask & 1UL;
+    SIM_irqService();
+}
+
+/** The core sleeps until the next event raises an enabled interrupt. It
+ * wakes with PRIMASK set as well, the interrupt is then taken on
+ * __enable_irq. With no event left nothing can wake it and it returns.
+*/
+void __WFI(void)
+{
+    while(SIM_irqNext() == NULL)
+    {
+        const uint64_t next = SIM_eventNext();
+        if(next == SIM_NEVER)
+        {
+            break;
+        }
+        SIM_clockRun(next);
+    }
+
+    SIM_irqService();
+}
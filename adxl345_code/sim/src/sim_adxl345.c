@@ -0,0 +1,887 @@
+/**
+ * @file sim_adxl345.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation of the ADXL345 device model. The first frame
+ * of each chip select window is the command: R/W on bit 7, MB on bit 6 and
+ * the register address on bits 5 to 0. Each following frame reads or
+ * writes one register, on the next address when MB is set. While the part
+ * measures, a sample is taken from the waveform source at each output data
+ * rate period, converted to the DATA_FORMAT in use and pushed to the FIFO
+ * as the FIFO_CTL mode dictates. A window that read the data registers
+ * pops one sample when the chip select is released, and the next window
+ * reading the data registers or FIFO_STATUS must start 5 us later or it is
+ * counted as an early read. INT_SOURCE, the INT1
+ * and INT2 levels and FIFO_STATUS are derived from that state. Every
+ * sample produced is read, dropped or still held, so the metrics add up.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_adxl345.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Register map, addressed by the 6 bits of the command*/
+#define REGISTER_SPACE      (0x40U)
+#define REG_DEVID           (0x00U)
+#define REG_THRESH_TAP      (0x1DU)
+#define REG_OFSX            (0x1EU)
+#define REG_TAP_AXES        (0x2AU)
+#define REG_BW_RATE         (0x2CU)
+#define REG_POWER_CTL       (0x2DU)
+#define REG_INT_ENABLE      (0x2EU)
+#define REG_INT_MAP         (0x2FU)
+#define REG_INT_SOURCE      (0x30U)
+#define REG_DATA_FORMAT     (0x31U)
+#define REG_DATAX0          (0x32U)
+#define REG_DATAZ1          (0x37U)
+#define REG_FIFO_CTL        (0x38U)
+#define REG_FIFO_STATUS     (0x39U)
+
+/** Power on values*/
+#define DEVID_VALUE         (0xE5U)
+#define BW_RATE_RESET       (0x0AU)
+
+/** Command frame fields*/
+#define COMMAND_READ        (0x80U)
+#define COMMAND_MB          (0x40U)
+#define COMMAND_ADDRESS     (0x3FU)
+
+/** Register fields*/
+#define BW_RATE_CODE        (0x0FU)
+#define POWER_CTL_MEASURE   (0x08U)
+#define FORMAT_INT_INVERT   (0x20U)
+#define FORMAT_FULL_RES     (0x08U)
+#define FORMAT_JUSTIFY      (0x04U)
+#define FORMAT_RANGE        (0x03U)
+#define FIFO_CTL_MODE_POS   (6U)
+#define FIFO_CTL_TRIGGER    (0x20U)
+#define FIFO_CTL_SAMPLES    (0x1FU)
+#define FIFO_STATUS_TRIG    (0x80U)
+
+/** INT_SOURCE bits*/
+#define SOURCE_DATA_READY   (0x80U)
+#define SOURCE_WATERMARK    (0x02U)
+#define SOURCE_OVERRUN      (0x01U)
+/** Sources the FIFO state derives, the others are latched events*/
+#define SOURCE_FIFO         (SOURCE_DATA_READY | SOURCE_WATERMARK | \
+SOURCE_OVERRUN)
+
+/** FIFO modes*/
+#define MODE_BYPASS         (0U)
+#define MODE_FIFO           (1U)
+#define MODE_STREAM         (2U)
+#define MODE_TRIGGER        (3U)
+
+/** Output data rate of rate code 15, every step below halves it*/
+#define ODR_MAX_HZ          (3200U)
+#define ODR_MAX_CODE        (15U)
+
+/** Axes of a sample and resting acceleration of the default source*/
+#define AXES                (3U)
+#define REST_MG             (1000)
+
+/** The FIFO pops in 5 us: HCLK over this divider gives its cycles*/
+#define POP_DIVIDER         (200000U)
+
+/** Frame answered while the command is shifted in, SDO is not driven*/
+#define MISO_IDLE           (0xFFU)
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines a sample held by the device.
+ */
+typedef struct
+{
+    int16_t axis[AXES];     /**< Raw X, Y and Z in the DATA_FORMAT in use */
+    uint64_t cycle;         /**< Cycle the sample was produced */
+}SimAdxl345Entry_t;
+
+/**
+ * Defines the state of a device model.
+ */
+typedef struct
+{
+    uint8_t attached;                       /**< The slot is in use */
+    SimAdxl345Config_t Config;              /**< Wiring and source */
+    uint8_t reg[REGISTER_SPACE];            /**< Stored registers */
+    SimAdxl345Entry_t entry[SIM_ADXL345_ENTRIES]; /**< FIFO and outputs */
+    uint8_t head;                           /**< Oldest entry */
+    uint8_t count;                          /**< Entries held */
+    SimAdxl345Entry_t output;               /**< Last sample popped */
+    uint8_t overrun;                        /**< OVERRUN is latched */
+    uint8_t events;                         /**< Latched event sources */
+    uint8_t triggered;                      /**< Trigger mode has fired */
+    uint32_t sampleNumber;                  /**< Samples taken */
+    uint64_t nextSample;                    /**< Next sample, or SIM_NEVER */
+    uint8_t frame;                          /**< Frames of the window */
+    uint8_t address;                        /**< Register of the next frame */
+    uint8_t readCommand;                    /**< The window reads */
+    uint8_t multiByte;                      /**< The address increments */
+    uint8_t dataRead;                       /**< Data registers were read */
+    uint8_t popChecked;                     /**< The window start is checked */
+    uint8_t popped;                         /**< A window popped a sample */
+    uint64_t popCycle;                      /**< Release of that window */
+    uint64_t selectCycle;                   /**< Start of the window */
+    uint8_t int1;                           /**< INT1 level driven */
+    uint8_t int2;                           /**< INT2 level driven */
+    SimAdxl345Stats_t Stats;                /**< Sample metrics */
+}SimAdxl345_t;
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Devices state*/
+static SimAdxl345_t device[SIM_ADXL345_DEVICES];
+
+/** The clock client serving every device is attached*/
+static uint8_t clientAttached;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void SIM_adxl345Select(void *context, uint8_t selected,
+uint64_t cycle);
+static uint16_t SIM_adxl345Exchange(void *context, uint16_t mosi,
+uint64_t cycle);
+static uint64_t SIM_adxl345Next(void *context);
+static void SIM_adxl345Advance(void *context, uint64_t cycle);
+static uint8_t SIM_adxl345Value(const SimAdxl345_t * const Dev,
+uint8_t address);
+static void SIM_adxl345Write(SimAdxl345_t * const Dev, uint8_t address,
+uint8_t value);
+static uint64_t SIM_adxl345Period(const SimAdxl345_t * const Dev);
+static int16_t SIM_adxl345Convert(const SimAdxl345_t * const Dev,
+uint8_t axis, int32_t mg);
+static void SIM_adxl345Sample(SimAdxl345_t * const Dev, uint64_t cycle);
+static void SIM_adxl345Pop(SimAdxl345_t * const Dev, uint64_t cycle);
+static void SIM_adxl345Trim(SimAdxl345_t * const Dev, uint8_t keep);
+static void SIM_adxl345Pins(SimAdxl345_t * const Dev);
+
+/** Clock client of the output data rate of every device*/
+static const SimClient_t Adxl345Client =
+{
+    SIM_adxl345Next, SIM_adxl345Advance, NULL
+};
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SIM_adxl345Attach()
+*//**
+*\b Description:
+ * This function is used to power up a device model and wire it to a
+ * simulated SPI channel and to its interrupt pins. The registers hold
+ * their power on values, so the part is in standby until POWER_CTL starts
+ * the measurement.
+ *
+ * PRE-CONDITION: The Device is below SIM_ADXL345_DEVICES. <br>
+ * PRE-CONDITION: The device is not attached yet. <br>
+ * PRE-CONDITION: The Channel has room for a device. <br>
+ *
+ * POST-CONDITION: The device answers on the bus while it is selected. <br>
+ *
+ * @param[in]   Device is the device model, 0 to SIM_ADXL345_DEVICES - 1.
+ * @param[in]   Config is the wiring and waveform source, copied.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * const SimAdxl345Config_t Sensor =
+ * {
+ *     .Channel = 0U,                       // SPI1
+ *     .CsPort = 0U, .CsPin = 4U,           // PA4
+ *     .Int1Port = 0U, .Int1Pin = 0U,       // PA0
+ *     .Int2Port = SIM_ADXL345_NC,
+ *     .Waveform = vibration, .context = NULL
+ * };
+ * SIM_adxl345Attach(0U, &Sensor);
+ * @endcode
+ *
+ * @see SIM_adxl345Attach
+ * @see SIM_adxl345StatsGet
+ * @see SIM_spiAttach
+ *
+*****************************************************************************/
+void SIM_adxl345Attach(uint8_t Device, const SimAdxl345Config_t * const Config)
+{
+    /* Prevent to write out of the device table*/
+    if((Device >= SIM_ADXL345_DEVICES) || device[Device].attached)
+    {
+        fprintf(stderr, "sim: ADXL345 model %u not available\n",
+        (unsigned)Device);
+        abort();
+    }
+
+    SimAdxl345_t * const Dev = &device[Device];
+    memset(Dev, 0, sizeof(*Dev));
+    Dev->attached = 1U;
+    Dev->Config = *Config;
+    Dev->reg[REG_DEVID] = DEVID_VALUE;
+    Dev->reg[REG_BW_RATE] = BW_RATE_RESET;
+    Dev->nextSample = SIM_NEVER;
+
+    /* Interrupts are active high after power on, start from low*/
+    Dev->int1 = 1U;
+    Dev->int2 = 1U;
+    SIM_adxl345Pins(Dev);
+
+    if(!clientAttached)
+    {
+        SIM_clientAttach(&Adxl345Client);
+        clientAttached = 1U;
+    }
+
+    const SimSpiDevice_t Bus =
+    {
+        SIM_adxl345Select, SIM_adxl345Exchange, Dev
+    };
+    SIM_spiAttach(Config->Channel, &Bus, Config->CsPort, Config->CsPin);
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345EventRaise()
+*//**
+*\b Description:
+ * This function is used to raise the motion events the model does not
+ * detect itself: tap, activity, inactivity and free fall. They latch in
+ * INT_SOURCE until it is read, drive the interrupt pins they are mapped to
+ * and fire trigger mode when they reach its trigger pin.
+ *
+ * PRE-CONDITION: The device is attached. <br>
+ *
+ * POST-CONDITION: The events are latched in INT_SOURCE. <br>
+ *
+ * @param[in]   Device is the device model.
+ * @param[in]   sources are INT_SOURCE bits, the FIFO bits are ignored.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SIM_adxl345EventRaise(0U, 0x40U);     // SINGLE_TAP
+ * @endcode
+ *
+ * @see SIM_adxl345EventRaise
+ * @see SIM_adxl345RegisterGet
+ *
+*****************************************************************************/
+void SIM_adxl345EventRaise(uint8_t Device, uint8_t sources)
+{
+    SimAdxl345_t * const Dev = &device[Device];
+    const uint8_t fifoCtl = Dev->reg[REG_FIFO_CTL];
+
+    Dev->events |= (uint8_t)(sources & ~SOURCE_FIFO);
+
+    /* The trigger event is an enabled source mapped to the trigger pin*/
+    const uint8_t routed = (fifoCtl & FIFO_CTL_TRIGGER) ?
+    Dev->reg[REG_INT_MAP] : (uint8_t)~Dev->reg[REG_INT_MAP];
+    if(((fifoCtl >> FIFO_CTL_MODE_POS) == MODE_TRIGGER) && !Dev->triggered &&
+    (Dev->events & Dev->reg[REG_INT_ENABLE] & routed))
+    {
+        /* Keep the samples before the event, then fill as FIFO mode*/
+        SIM_adxl345Trim(Dev, fifoCtl & FIFO_CTL_SAMPLES);
+        Dev->triggered = 1U;
+    }
+
+    SIM_adxl345Pins(Dev);
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345RegisterGet()
+*//**
+*\b Description:
+ * This function is used to inspect a register as the part would return
+ * it, without the side effects of a read over the bus.
+ *
+ * PRE-CONDITION: The device is attached. <br>
+ *
+ * POST-CONDITION: The register value is returned. <br>
+ *
+ * @param[in]   Device is the device model.
+ * @param[in]   address is the register address.
+ *
+ * @return  The register value.
+ *
+ * \b Example:
+ * @code
+ * uint8_t entries = SIM_adxl345RegisterGet(0U, 0x39U) & 0x3FU;
+ * @endcode
+ *
+ * @see SIM_adxl345RegisterGet
+ *
+*****************************************************************************/
+uint8_t SIM_adxl345RegisterGet(uint8_t Device, uint8_t address)
+{
+    return SIM_adxl345Value(&device[Device], address & COMMAND_ADDRESS);
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345StatsGet()
+*//**
+*\b Description:
+ * This function is used to get the sample metrics of a device. The
+ * samples produced are the samples read plus the samples dropped plus the
+ * entries still held.
+ *
+ * PRE-CONDITION: The device is attached. <br>
+ *
+ * POST-CONDITION: A copy of the metrics is returned. <br>
+ *
+ * @param[in]   Device is the device model.
+ *
+ * @return  The metrics of the device.
+ *
+ * \b Example:
+ * @code
+ * const SimAdxl345Stats_t Stats = SIM_adxl345StatsGet(0U);
+ * double meanLatency = (double)Stats.latencySum / Stats.read;
+ * @endcode
+ *
+ * @see SIM_adxl345StatsGet
+ * @see SIM_adxl345StatsReset
+ *
+*****************************************************************************/
+SimAdxl345Stats_t SIM_adxl345StatsGet(uint8_t Device)
+{
+    return device[Device].Stats;
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345StatsReset()
+*//**
+*\b Description:
+ * This function is used to clear the sample metrics of a device.
+ *
+ * PRE-CONDITION: The device is attached. <br>
+ *
+ * POST-CONDITION: The metrics of the device are zero. <br>
+ *
+ * @param[in]   Device is the device model.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SIM_adxl345StatsReset(0U);
+ * @endcode
+ *
+ * @see SIM_adxl345StatsGet
+ * @see SIM_adxl345StatsReset
+ *
+*****************************************************************************/
+void SIM_adxl345StatsReset(uint8_t Device)
+{
+    memset(&device[Device].Stats, 0, sizeof(device[Device].Stats));
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Select()
+*//**
+*\b Description:
+ * This function is used to open and close a chip select window. The
+ * sample read by the window is popped when it closes, the cycle is kept
+ * to check the start of the next windows.
+ *
+ * @param[in]   context is the device.
+ * @param[in]   selected is 1 when the chip select goes low.
+ * @param[in]   cycle is the cycle of the edge.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Select(void *context, uint8_t selected,
+uint64_t cycle)
+{
+    SimAdxl345_t * const Dev = context;
+
+    if(selected)
+    {
+        Dev->frame = 0U;
+        Dev->dataRead = 0U;
+        Dev->popChecked = 0U;
+        Dev->selectCycle = cycle;
+    }
+    else if(Dev->dataRead)
+    {
+        SIM_adxl345Pop(Dev, cycle);
+        Dev->dataRead = 0U;
+        Dev->popped = 1U;
+        Dev->popCycle = cycle;
+        SIM_adxl345Pins(Dev);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Exchange()
+*//**
+*\b Description:
+ * This function is used to answer a frame of the window. The first frame
+ * is the command, the next ones read or write the registers.
+ *
+ * @param[in]   context is the device.
+ * @param[in]   mosi is the frame driven by the master.
+ * @param[in]   cycle is not used.
+ *
+ * @return  The frame driven on SDO.
+ *
+*****************************************************************************/
+static uint16_t SIM_adxl345Exchange(void *context, uint16_t mosi,
+uint64_t cycle)
+{
+    SimAdxl345_t * const Dev = context;
+    const uint8_t value = (uint8_t)mosi;
+    uint16_t miso = MISO_IDLE;
+    (void)cycle;
+
+    if(Dev->frame == 0U)
+    {
+        Dev->readCommand = (value & COMMAND_READ) ? 1U : 0U;
+        Dev->multiByte = (value & COMMAND_MB) ? 1U : 0U;
+        Dev->address = value & COMMAND_ADDRESS;
+        Dev->frame = 1U;
+        return miso;
+    }
+
+    if(Dev->readCommand)
+    {
+        /* The first FIFO read of the window must wait for the last pop,
+        the registers read after it in the same burst are not checked*/
+        if(!Dev->popChecked && (((Dev->address >= REG_DATAX0) &&
+        (Dev->address <= REG_DATAZ1)) || (Dev->address == REG_FIFO_STATUS)))
+        {
+            Dev->popChecked = 1U;
+            if(Dev->popped && ((Dev->selectCycle - Dev->popCycle) <
+            (SIM_hclkGet() / POP_DIVIDER)))
+            {
+                Dev->Stats.earlyReads++;
+            }
+        }
+
+        miso = SIM_adxl345Value(Dev, Dev->address);
+        if((Dev->address >= REG_DATAX0) && (Dev->address <= REG_DATAZ1))
+        {
+            Dev->dataRead = 1U;
+        }
+        else if(Dev->address == REG_INT_SOURCE)
+        {
+            /* Reading INT_SOURCE clears the latched events*/
+            Dev->events = 0U;
+            SIM_adxl345Pins(Dev);
+        }
+    }
+    else
+    {
+        SIM_adxl345Write(Dev, Dev->address, value);
+    }
+
+    if(Dev->multiByte)
+    {
+        Dev->address = (Dev->address + 1U) & COMMAND_ADDRESS;
+    }
+
+    return miso;
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Next()
+*//**
+*\b Description:
+ * This function is used to get the next sample of the devices.
+ *
+ * @param[in]   context is not used.
+ *
+ * @return  The cycle, or SIM_NEVER.
+ *
+*****************************************************************************/
+static uint64_t SIM_adxl345Next(void *context)
+{
+    uint64_t next = SIM_NEVER;
+    (void)context;
+
+    for(uint8_t i = 0; i < SIM_ADXL345_DEVICES; i++)
+    {
+        if(device[i].attached && (device[i].nextSample < next))
+        {
+            next = device[i].nextSample;
+        }
+    }
+
+    return next;
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Advance()
+*//**
+*\b Description:
+ * This function is used to take the samples due up to a cycle.
+ *
+ * @param[in]   context is not used.
+ * @param[in]   cycle is the clock value reached.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Advance(void *context, uint64_t cycle)
+{
+    (void)context;
+
+    for(uint8_t i = 0; i < SIM_ADXL345_DEVICES; i++)
+    {
+        SimAdxl345_t * const Dev = &device[i];
+
+        while(Dev->attached && (Dev->nextSample <= cycle))
+        {
+            SIM_adxl345Sample(Dev, Dev->nextSample);
+            Dev->nextSample += SIM_adxl345Period(Dev);
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Value()
+*//**
+*\b Description:
+ * This function is used to get the value the part returns for a register.
+ * The data registers show the oldest entry, or the last sample popped
+ * when the FIFO is empty.
+ *
+ * @param[in]   Dev is the device.
+ * @param[in]   address is the register address.
+ *
+ * @return  The register value.
+ *
+*****************************************************************************/
+static uint8_t SIM_adxl345Value(const SimAdxl345_t * const Dev,
+uint8_t address)
+{
+    if((address >= REG_DATAX0) && (address <= REG_DATAZ1))
+    {
+        const SimAdxl345Entry_t * const Entry = (Dev->count > 0U) ?
+        &Dev->entry[Dev->head] : &Dev->output;
+        const uint16_t raw = (uint16_t)Entry->axis[(address - REG_DATAX0) / 2U];
+
+        return (uint8_t)(((address - REG_DATAX0) & 1U) ? (raw >> 8) : raw);
+    }
+
+    if(address == REG_INT_SOURCE)
+    {
+        uint8_t source = Dev->events;
+
+        if(Dev->count > 0U)
+        {
+            source |= SOURCE_DATA_READY;
+        }
+        if(Dev->count >= (Dev->reg[REG_FIFO_CTL] & FIFO_CTL_SAMPLES))
+        {
+            source |= SOURCE_WATERMARK;
+        }
+        if(Dev->overrun)
+        {
+            source |= SOURCE_OVERRUN;
+        }
+
+        return source;
+    }
+
+    if(address == REG_FIFO_STATUS)
+    {
+        return (uint8_t)(Dev->count | (Dev->triggered ? FIFO_STATUS_TRIG : 0U));
+    }
+
+    return Dev->reg[address];
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Write()
+*//**
+*\b Description:
+ * This function is used to write a register. Read only and reserved
+ * registers ignore the write. Starting the measurement, changing the
+ * rate or leaving a FIFO mode takes effect at once.
+ *
+ * @param[in]   Dev is the device.
+ * @param[in]   address is the register address.
+ * @param[in]   value is the value written.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Write(SimAdxl345_t * const Dev, uint8_t address,
+uint8_t value)
+{
+    const uint8_t writable = ((address >= REG_THRESH_TAP) &&
+    (address <= REG_TAP_AXES)) || ((address >= REG_BW_RATE) &&
+    (address <= REG_INT_MAP)) || (address == REG_DATA_FORMAT) ||
+    (address == REG_FIFO_CTL);
+
+    if(!writable)
+    {
+        return;
+    }
+
+    const uint8_t previous = Dev->reg[address];
+    Dev->reg[address] = value;
+
+    const uint8_t measuring = (Dev->reg[REG_POWER_CTL] & POWER_CTL_MEASURE) ?
+    1U : 0U;
+
+    if(address == REG_POWER_CTL)
+    {
+        /* The first sample comes one period after the measurement starts,
+        a measurement already running keeps its pace*/
+        if(!measuring)
+        {
+            Dev->nextSample = SIM_NEVER;
+        }
+        else if(!(previous & POWER_CTL_MEASURE))
+        {
+            Dev->nextSample = SIM_cyclesGet() + SIM_adxl345Period(Dev);
+        }
+    }
+    else if((address == REG_BW_RATE) && measuring)
+    {
+        Dev->nextSample = SIM_cyclesGet() + SIM_adxl345Period(Dev);
+    }
+    else if(address == REG_FIFO_CTL)
+    {
+        const uint8_t mode = value >> FIFO_CTL_MODE_POS;
+
+        /* Bypass clears the FIFO, leaving trigger mode rearms it*/
+        if(mode == MODE_BYPASS)
+        {
+            SIM_adxl345Trim(Dev, 0U);
+        }
+        if(mode != MODE_TRIGGER)
+        {
+            Dev->triggered = 0U;
+        }
+    }
+
+    SIM_adxl345Pins(Dev);
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Period()
+*//**
+*\b Description:
+ * This function is used to get the output data rate period in cycles of
+ * the simulated clock. The rate halves with each code below 3200 Hz.
+ *
+ * @param[in]   Dev is the device.
+ *
+ * @return  The sample period in cycles.
+ *
+*****************************************************************************/
+static uint64_t SIM_adxl345Period(const SimAdxl345_t * const Dev)
+{
+    const uint8_t code = Dev->reg[REG_BW_RATE] & BW_RATE_CODE;
+
+    return ((uint64_t)SIM_hclkGet() << (ODR_MAX_CODE - code)) / ODR_MAX_HZ;
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Convert()
+*//**
+*\b Description:
+ * This function is used to convert an acceleration to the raw value of
+ * the DATA_FORMAT in use: the offset register is added, the value is
+ * scaled to 256 LSB/g (full resolution) or to 10 bits over the range,
+ * clipped and right or left justified.
+ *
+ * @param[in]   Dev is the device.
+ * @param[in]   axis is 0 = X, 1 = Y or 2 = Z.
+ * @param[in]   mg is the acceleration in mg.
+ *
+ * @return  The raw axis value.
+ *
+*****************************************************************************/
+static int16_t SIM_adxl345Convert(const SimAdxl345_t * const Dev,
+uint8_t axis, int32_t mg)
+{
+    const uint8_t format = Dev->reg[REG_DATA_FORMAT];
+    const uint8_t range = format & FORMAT_RANGE;
+    const uint8_t fullRes = (format & FORMAT_FULL_RES) ? 1U : 0U;
+    const int32_t lsbPerG = fullRes ? 256 : (256 >> range);
+    const uint8_t bits = (uint8_t)(fullRes ? (10U + range) : 10U);
+    const int32_t limit = 1L << (bits - 1U);
+
+    /* The offset registers are 15.6 mg/LSB*/
+    mg += ((int32_t)(int8_t)Dev->reg[REG_OFSX + axis] * 156) / 10;
+
+    const int64_t scaled = (int64_t)mg * lsbPerG;
+    int32_t value = (int32_t)((scaled + ((scaled < 0) ? -500 : 500)) / 1000);
+    if(value >= limit)
+    {
+        value = limit - 1;
+    }
+    else if(value < -limit)
+    {
+        value = -limit;
+    }
+
+    if(format & FORMAT_JUSTIFY)
+    {
+        return (int16_t)(uint16_t)((uint32_t)value << (16U - bits));
+    }
+
+    return (int16_t)value;
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Sample()
+*//**
+*\b Description:
+ * This function is used to take a sample and push it. Bypass holds one
+ * entry and replaces it. FIFO mode, and trigger mode once fired, keep the
+ * entries held and lose the new sample when full. Stream mode, and
+ * trigger mode before it fires, lose the oldest. A lost sample latches
+ * OVERRUN.
+ *
+ * @param[in]   Dev is the device.
+ * @param[in]   cycle is the cycle of the sample.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Sample(SimAdxl345_t * const Dev, uint64_t cycle)
+{
+    const uint8_t mode = Dev->reg[REG_FIFO_CTL] >> FIFO_CTL_MODE_POS;
+    const uint8_t capacity = (mode == MODE_BYPASS) ? 1U : SIM_ADXL345_ENTRIES;
+    const uint8_t holds = (mode == MODE_FIFO) ||
+    ((mode == MODE_TRIGGER) && Dev->triggered);
+    SimAdxl345Entry_t Entry;
+
+    for(uint8_t axis = 0; axis < AXES; axis++)
+    {
+        const int32_t mg = (Dev->Config.Waveform != NULL) ?
+        Dev->Config.Waveform(Dev->Config.context, axis, Dev->sampleNumber) :
+        ((axis == 2U) ? REST_MG : 0);
+        Entry.axis[axis] = SIM_adxl345Convert(Dev, axis, mg);
+    }
+    Entry.cycle = cycle;
+    Dev->sampleNumber++;
+    Dev->Stats.samples++;
+
+    if(Dev->count >= capacity)
+    {
+        Dev->overrun = 1U;
+        Dev->Stats.dropped++;
+        if(holds)
+        {
+            SIM_adxl345Pins(Dev);
+            return;
+        }
+        Dev->head = (uint8_t)((Dev->head + 1U) % SIM_ADXL345_ENTRIES);
+        Dev->count--;
+    }
+
+    Dev->entry[(Dev->head + Dev->count) % SIM_ADXL345_ENTRIES] = Entry;
+    Dev->count++;
+    SIM_adxl345Pins(Dev);
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Pop()
+*//**
+*\b Description:
+ * This function is used to pop the oldest entry once the data registers
+ * were read, and to account its latency. OVERRUN is cleared.
+ *
+ * @param[in]   Dev is the device.
+ * @param[in]   cycle is the cycle of the chip select release.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Pop(SimAdxl345_t * const Dev, uint64_t cycle)
+{
+    Dev->overrun = 0U;
+
+    if(Dev->count == 0U)
+    {
+        return;
+    }
+
+    Dev->output = Dev->entry[Dev->head];
+    Dev->head = (uint8_t)((Dev->head + 1U) % SIM_ADXL345_ENTRIES);
+    Dev->count--;
+
+    const uint64_t latency = cycle - Dev->output.cycle;
+    Dev->Stats.read++;
+    Dev->Stats.latencySum += latency;
+    if(latency > Dev->Stats.latencyMax)
+    {
+        Dev->Stats.latencyMax = latency;
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Trim()
+*//**
+*\b Description:
+ * This function is used to drop the oldest entries down to a count.
+ *
+ * @param[in]   Dev is the device.
+ * @param[in]   keep is the number of newest entries kept.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Trim(SimAdxl345_t * const Dev, uint8_t keep)
+{
+    while(Dev->count > keep)
+    {
+        Dev->head = (uint8_t)((Dev->head + 1U) % SIM_ADXL345_ENTRIES);
+        Dev->count--;
+        Dev->Stats.dropped++;
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_adxl345Pins()
+*//**
+*\b Description:
+ * This function is used to drive INT1 and INT2 from the enabled sources,
+ * INT_MAP routes a source to INT2. INT_INVERT makes them active low.
+ *
+ * @param[in]   Dev is the device.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_adxl345Pins(SimAdxl345_t * const Dev)
+{
+    const uint8_t active = SIM_adxl345Value(Dev, REG_INT_SOURCE) &
+    Dev->reg[REG_INT_ENABLE];
+    const uint8_t invert = (Dev->reg[REG_DATA_FORMAT] & FORMAT_INT_INVERT) ?
+    1U : 0U;
+    const uint8_t int1 = (uint8_t)(((active & ~Dev->reg[REG_INT_MAP]) ? 1U :
+    0U) ^ invert);
+    const uint8_t int2 = (uint8_t)(((active & Dev->reg[REG_INT_MAP]) ? 1U :
+    0U) ^ invert);
+
+    if((int1 != Dev->int1) && (Dev->Config.Int1Port != SIM_ADXL345_NC))
+    {
+        SIM_pinDrive(Dev->Config.Int1Port, Dev->Config.Int1Pin, int1);
+    }
+    if((int2 != Dev->int2) && (Dev->Config.Int2Port != SIM_ADXL345_NC))
+    {
+        SIM_pinDrive(Dev->Config.Int2Port, Dev->Config.Int2Pin, int2);
+    }
+    Dev->int1 = int1;
+    Dev->int2 = int2;
+}
@@ -0,0 +1,77 @@
+/**
+ * @file sim_bus.h
+ * @author Jose Luis Figueroa
+ * @brief The internal interface of the simulator register bus. The models
+ * attach their register regions to the bus, reach the register file
+ * through its backdoor and report their interrupt lines to the NVIC.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+#ifndef SIM_BUS_H_
+#define SIM_BUS_H_
+
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+#include "sim.h"
+
+/*****************************************************************************
+* Configuration Constants
+*****************************************************************************/
+/**
+ * Defines the regions that can be attached to the bus.
+ */
+#define SIM_REGIONS         (24U)
+
+/*****************************************************************************
+* Macros
+*****************************************************************************/
+/**
+ * Defines the device address of a register from its peripheral base.
+ */
+#define SIM_ADDRESS(base, type, member) \
+((uint32_t)((base) + offsetof(type, member)))
+
+/**
+ * Defines the backdoor access of a register. The models use it to read and
+ * update the register file without being trapped.
+ */
+#define SIM_REG(address)    (*SIM_registerGet(address))
+
+/*****************************************************************************
+* Typedefs
+*****************************************************************************/
+/**
+ * Defines a register region served by a model. read is called before the
+ * access so the register holds its current value, readDone after a load
+ * and write after a store with the value the register held before it.
+ */
+typedef struct
+{
+    uint32_t base;
+    uint32_t size;
+    void (*read)(uint32_t address);
+    void (*readDone)(uint32_t address);
+    void (*write)(uint32_t address, uint32_t previous);
+}SimRegion_t;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+volatile uint32_t * SIM_registerGet(uint32_t address);
+void SIM_regionAttach(const SimRegion_t * const Region);
+void SIM_clockRun(uint64_t cycle);
+
+void SIM_gpioInit(void);
+void SIM_spiInit(void);
+void SIM_spiPinEdge(uint8_t Port, uint16_t changed, uint16_t level);
+uint8_t SIM_spiIrqPending(uint32_t Channel);
+uint8_t SIM_dmaIrqPending(uint32_t Stream);
+uint8_t SIM_extiIrqPending(uint32_t lines);
+
+#endif /*SIM_BUS_H_*/
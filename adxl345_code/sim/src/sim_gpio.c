@@ -0,0 +1,404 @@
+/**
+ * @file sim_gpio.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation of the GPIO and EXTI models. The level of each
+ * pin follows ODR on outputs and the external drive or the pull resistor on
+ * the other modes. Every level change is an edge: it latches the EXTI lines
+ * routed to the pin and selects or deselects the SPI devices whose chip
+ * select it is.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include "sim_bus.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Address step between two GPIO ports*/
+#define PORT_STEP           (0x400UL)
+/** MODER and PUPDR field values*/
+#define MODE_OUTPUT         (0x1UL)
+#define PULL_UP             (0x1UL)
+/** EXTI lines routed by each EXTICR register*/
+#define LINES_PER_EXTICR    (4U)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Ports of the STM32F401, GPIOF and GPIOG are not implemented*/
+static const uint8_t portPresent[SIM_GPIO_PORTS] =
+{
+    1U, 1U, 1U, 1U, 1U, 0U, 0U, 1U
+};
+
+/** External level driven on each pin and the pins that are driven*/
+static uint16_t drive[SIM_GPIO_PORTS];
+static uint16_t driven[SIM_GPIO_PORTS];
+
+/** Pin levels after the last change*/
+static uint16_t level[SIM_GPIO_PORTS];
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static uint32_t SIM_portBase(uint8_t Port);
+static uint16_t SIM_gpioLevel(uint8_t Port);
+static void SIM_gpioUpdate(uint8_t Port);
+static void SIM_gpioRead(uint32_t address);
+static void SIM_gpioWrite(uint32_t address, uint32_t previous);
+static void SIM_extiEdge(uint8_t Port, uint16_t changed, uint16_t pins);
+static void SIM_extiWrite(uint32_t address, uint32_t previous);
+
+/** GPIO models, one region per port*/
+static const SimRegion_t GpioRegion[SIM_GPIO_PORTS] =
+{
+    {GPIOA_BASE, sizeof(GPIO_TypeDef), SIM_gpioRead, NULL, SIM_gpioWrite},
+    {GPIOB_BASE, sizeof(GPIO_TypeDef), SIM_gpioRead, NULL, SIM_gpioWrite},
+    {GPIOC_BASE, sizeof(GPIO_TypeDef), SIM_gpioRead, NULL, SIM_gpioWrite},
+    {GPIOD_BASE, sizeof(GPIO_TypeDef), SIM_gpioRead, NULL, SIM_gpioWrite},
+    {GPIOE_BASE, sizeof(GPIO_TypeDef), SIM_gpioRead, NULL, SIM_gpioWrite},
+    {0U, 0U, NULL, NULL, NULL},
+    {0U, 0U, NULL, NULL, NULL},
+    {GPIOH_BASE, sizeof(GPIO_TypeDef), SIM_gpioRead, NULL, SIM_gpioWrite}
+};
+
+/** EXTI model, the pending register is cleared by writing one*/
+static const SimRegion_t ExtiRegion =
+{
+    EXTI_BASE, sizeof(EXTI_TypeDef), NULL, NULL, SIM_extiWrite
+};
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SIM_pinDrive()
+*//**
+*\b Description:
+ * This function is used to drive a pin from outside of the MCU, as a
+ * device output wired to it. An edge on an input raises its EXTI line.
+ *
+ * PRE-CONDITION: The Port is an implemented port. <br>
+ * PRE-CONDITION: The Pin is below SIM_GPIO_PINS. <br>
+ *
+ * POST-CONDITION: The pin reads level unless it is an output. <br>
+ *
+ * @param[in]   Port is the port slot, GPIOA = 0 to GPIOH = 7.
+ * @param[in]   Pin is the pin number.
+ * @param[in]   level is 0 or 1.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SIM_pinDrive(0U, 0U, 1U);     // INT1 high on PA0
+ * @endcode
+ *
+ * @see SIM_pinDrive
+ * @see SIM_pinGet
+ *
+*****************************************************************************/
+void SIM_pinDrive(uint8_t Port, uint8_t Pin, uint8_t level)
+{
+    const uint16_t mask = (uint16_t)(1U << Pin);
+
+    if(level)
+    {
+        drive[Port] |= mask;
+    }
+    else
+    {
+        drive[Port] &= (uint16_t)~mask;
+    }
+    driven[Port] |= mask;
+
+    SIM_gpioUpdate(Port);
+}
+
+/*****************************************************************************
+ * Function: SIM_pinGet()
+*//**
+*\b Description:
+ * This function is used to get the level of a pin, as a device input
+ * wired to it sees it.
+ *
+ * PRE-CONDITION: The Port is an implemented port. <br>
+ * PRE-CONDITION: The Pin is below SIM_GPIO_PINS. <br>
+ *
+ * POST-CONDITION: The pin level is returned. <br>
+ *
+ * @param[in]   Port is the port slot, GPIOA = 0 to GPIOH = 7.
+ * @param[in]   Pin is the pin number.
+ *
+ * @return  0 or 1.
+ *
+ * \b Example:
+ * @code
+ * uint8_t cs = SIM_pinGet(0U, 4U);      // PA4
+ * @endcode
+ *
+ * @see SIM_pinDrive
+ * @see SIM_pinGet
+ *
+*****************************************************************************/
+uint8_t SIM_pinGet(uint8_t Port, uint8_t Pin)
+{
+    return (uint8_t)((SIM_gpioLevel(Port) >> Pin) & 1U);
+}
+
+/*****************************************************************************
+ * Function: SIM_gpioInit()
+*//**
+*\b Description:
+ * This function is used to set the ports to their reset values and to
+ * attach the GPIO and EXTI regions.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+void SIM_gpioInit(void)
+{
+    /* Debug port pins of GPIOA and GPIOB*/
+    SIM_REG(SIM_ADDRESS(GPIOA_BASE, GPIO_TypeDef, MODER)) = 0xA8000000UL;
+    SIM_REG(SIM_ADDRESS(GPIOA_BASE, GPIO_TypeDef, PUPDR)) = 0x64000000UL;
+    SIM_REG(SIM_ADDRESS(GPIOB_BASE, GPIO_TypeDef, MODER)) = 0x00000280UL;
+    SIM_REG(SIM_ADDRESS(GPIOB_BASE, GPIO_TypeDef, PUPDR)) = 0x00000100UL;
+
+    for(uint8_t Port = 0; Port < SIM_GPIO_PORTS; Port++)
+    {
+        if(portPresent[Port])
+        {
+            level[Port] = SIM_gpioLevel(Port);
+            SIM_regionAttach(&GpioRegion[Port]);
+        }
+    }
+
+    SIM_regionAttach(&ExtiRegion);
+}
+
+/*****************************************************************************
+ * Function: SIM_extiIrqPending()
+*//**
+*\b Description:
+ * This function is used to get the level of an EXTI interrupt.
+ *
+ * @param[in]   lines are the EXTI lines of the interrupt.
+ *
+ * @return  1 when a line is pending and unmasked, 0 otherwise.
+ *
+*****************************************************************************/
+uint8_t SIM_extiIrqPending(uint32_t lines)
+{
+    return (SIM_REG(SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, PR)) &
+    SIM_REG(SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, IMR)) & lines) ? 1U : 0U;
+}
+
+/*****************************************************************************
+ * Function: SIM_portBase()
+*//**
+*\b Description:
+ * This function is used to get the base address of a port.
+ *
+ * @param[in]   Port is the port slot.
+ *
+ * @return  The base address.
+ *
+*****************************************************************************/
+static uint32_t SIM_portBase(uint8_t Port)
+{
+    return GPIOA_BASE + ((uint32_t)Port * PORT_STEP);
+}
+
+/*****************************************************************************
+ * Function: SIM_gpioLevel()
+*//**
+*\b Description:
+ * This function is used to get the pin levels of a port. Outputs drive
+ * ODR, the other pins read the external drive or their pull resistor.
+ *
+ * @param[in]   Port is the port slot.
+ *
+ * @return  The level of the 16 pins.
+ *
+*****************************************************************************/
+static uint16_t SIM_gpioLevel(uint8_t Port)
+{
+    const uint32_t base = SIM_portBase(Port);
+    const uint32_t moder = SIM_REG(SIM_ADDRESS(base, GPIO_TypeDef, MODER));
+    const uint32_t pupdr = SIM_REG(SIM_ADDRESS(base, GPIO_TypeDef, PUPDR));
+    const uint32_t odr = SIM_REG(SIM_ADDRESS(base, GPIO_TypeDef, ODR));
+    uint16_t output = 0;
+    uint16_t pullUp = 0;
+
+    for(uint8_t pin = 0; pin < SIM_GPIO_PINS; pin++)
+    {
+        if(((moder >> (pin * 2U)) & 0x3UL) == MODE_OUTPUT)
+        {
+            output |= (uint16_t)(1U << pin);
+        }
+        if(((pupdr >> (pin * 2U)) & 0x3UL) == PULL_UP)
+        {
+            pullUp |= (uint16_t)(1U << pin);
+        }
+    }
+
+    const uint16_t input = (uint16_t)((drive[Port] & driven[Port]) |
+    (pullUp & ~driven[Port]));
+
+    return (uint16_t)((odr & output) | (input & ~output));
+}
+
+/*****************************************************************************
+ * Function: SIM_gpioUpdate()
+*//**
+*\b Description:
+ * This function is used to propagate the edges of a port after a change
+ * of its registers or of its external drive.
+ *
+ * @param[in]   Port is the port slot.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_gpioUpdate(uint8_t Port)
+{
+    const uint16_t pins = SIM_gpioLevel(Port);
+    const uint16_t changed = pins ^ level[Port];
+
+    level[Port] = pins;
+    if(changed)
+    {
+        SIM_extiEdge(Port, changed, pins);
+        SIM_spiPinEdge(Port, changed, pins);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_gpioRead()
+*//**
+*\b Description:
+ * This function is used to present the pin levels on IDR.
+ *
+ * @param[in]   address is the register read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_gpioRead(uint32_t address)
+{
+    const uint8_t Port = (uint8_t)((address - GPIOA_BASE) / PORT_STEP);
+
+    if(address == SIM_ADDRESS(SIM_portBase(Port), GPIO_TypeDef, IDR))
+    {
+        SIM_REG(address) = SIM_gpioLevel(Port);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_gpioWrite()
+*//**
+*\b Description:
+ * This function is used to apply a store on a port. BSRR sets and resets
+ * ODR bits atomically and reads zero, IDR is read only.
+ *
+ * @param[in]   address is the register written.
+ * @param[in]   previous is the value before the store.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_gpioWrite(uint32_t address, uint32_t previous)
+{
+    const uint8_t Port = (uint8_t)((address - GPIOA_BASE) / PORT_STEP);
+    const uint32_t base = SIM_portBase(Port);
+
+    if(address == SIM_ADDRESS(base, GPIO_TypeDef, BSRR))
+    {
+        const uint32_t bsrr = SIM_REG(address);
+        volatile uint32_t * const Odr =
+        SIM_registerGet(SIM_ADDRESS(base, GPIO_TypeDef, ODR));
+
+        /* Set has priority over reset*/
+        *Odr = ((*Odr & ~(bsrr >> 16)) | bsrr) & 0xFFFFUL;
+        SIM_REG(address) = 0U;
+    }
+    else if(address == SIM_ADDRESS(base, GPIO_TypeDef, IDR))
+    {
+        SIM_REG(address) = previous;
+    }
+
+    SIM_gpioUpdate(Port);
+}
+
+/*****************************************************************************
+ * Function: SIM_extiEdge()
+*//**
+*\b Description:
+ * This function is used to latch the EXTI lines of the changed pins of a
+ * port. A line latches when it is routed to the port and its edge is
+ * selected.
+ *
+ * @param[in]   Port is the port slot.
+ * @param[in]   changed are the pins that changed.
+ * @param[in]   pins are the new levels.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_extiEdge(uint8_t Port, uint16_t changed, uint16_t pins)
+{
+    const uint32_t rtsr = SIM_REG(SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, RTSR));
+    const uint32_t ftsr = SIM_REG(SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, FTSR));
+    volatile uint32_t * const Pr =
+    SIM_registerGet(SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, PR));
+
+    for(uint8_t line = 0; line < SIM_GPIO_PINS; line++)
+    {
+        const uint32_t mask = (1UL << line);
+        const uint32_t exticr = SIM_REG(SIM_ADDRESS(SYSCFG_BASE,
+        SYSCFG_TypeDef, EXTICR) + ((line / LINES_PER_EXTICR) * 4UL));
+        const uint8_t route = (uint8_t)((exticr >>
+        ((line % LINES_PER_EXTICR) * 4U)) & 0xFUL);
+
+        if((changed & mask) && (route == Port))
+        {
+            const uint32_t edges = (pins & mask) ? rtsr : ftsr;
+            *Pr |= (edges & mask);
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_extiWrite()
+*//**
+*\b Description:
+ * This function is used to apply a store on the EXTI. Writing one to PR
+ * clears the line, writing one to SWIER latches it.
+ *
+ * @param[in]   address is the register written.
+ * @param[in]   previous is the value before the store.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_extiWrite(uint32_t address, uint32_t previous)
+{
+    volatile uint32_t * const Pr =
+    SIM_registerGet(SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, PR));
+
+    if(address == SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, PR))
+    {
+        *Pr = previous & ~SIM_REG(address);
+    }
+    else if(address == SIM_ADDRESS(EXTI_BASE, EXTI_TypeDef, SWIER))
+    {
+        *Pr |= SIM_REG(address);
+        SIM_REG(address) = 0U;
+    }
+}
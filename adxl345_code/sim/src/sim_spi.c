@@ -0,0 +1,1013 @@
+/**
+ * @file sim_spi.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation of the SPI and DMA models. Each master channel
+ * has a transmit buffer, a shift register and a receive buffer. A frame
+ * moves from the transmit buffer to the shift register as soon as it is
+ * idle, shifts for 8 or 16 bit times of the prescaled APB clock and lands
+ * in the receive buffer, or raises OVR when it is still full. TXE, RXNE,
+ * BSY and OVR are derived from that state on each read of SR, and the DMA
+ * streams pointed at DR move frames in and out of the buffers. The devices
+ * on the bus exchange a frame each time one completes while their chip
+ * select, a GPIO pin or the hardware NSS output, is low.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_bus.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Streams of each DMA controller*/
+#define STREAMS_PER_DMA     (8U)
+/** Size of the DMA controller registers*/
+#define DMA_REGION_SIZE     (DMA_STREAM_OFFSET + (STREAMS_PER_DMA * \
+DMA_STREAM_SIZE))
+/** DMA stream transfer complete flag*/
+#define DMA_STREAM_TCIF     (0x20UL)
+/** DMA stream transfer error flag*/
+#define DMA_STREAM_TEIF     (0x08UL)
+/** DMA stream directions*/
+#define DMA_PERIPH_TO_MEMORY (0x0UL)
+#define DMA_MEMORY_TO_PERIPH (DMA_SxCR_DIR_0)
+/** No DMA stream serves the request*/
+#define NO_STREAM           (0xFFU)
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines the state of a simulated SPI channel.
+ */
+typedef struct
+{
+    uint16_t txBuffer;      /**< Frame waiting to be shifted */
+    uint8_t txFull;         /**< TXE is clear */
+    uint16_t shift;         /**< Frame being shifted */
+    uint8_t shifting;       /**< The shift register is busy */
+    uint64_t shiftEnd;      /**< Cycle the frame being shifted completes */
+    uint64_t frameCycles;   /**< Length of the frame being shifted */
+    uint16_t rxBuffer;      /**< Last frame received */
+    uint8_t rxFull;         /**< RXNE is set */
+    uint8_t overrun;        /**< OVR is set */
+    uint8_t overrunRead;    /**< DR was read while OVR was set */
+    uint8_t nssLow;         /**< Level of the hardware NSS output */
+    SimSpiStats_t Stats;    /**< Bus metrics */
+}SimSpi_t;
+
+/**
+ * Defines a device attached to a channel.
+ */
+typedef struct
+{
+    SimSpiDevice_t Device;  /**< Device callbacks */
+    uint8_t Port;           /**< Chip select port, or SIM_NSS */
+    uint8_t Pin;            /**< Chip select pin */
+    uint8_t selected;       /**< The chip select is low */
+}SimSpiSlot_t;
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Base address of each channel*/
+static const uint32_t spiBase[SIM_SPI_CHANNELS] =
+{
+    SPI1_BASE, SPI2_BASE, SPI3_BASE, SPI4_BASE
+};
+
+/** Channels on APB1, the others are on APB2*/
+static const uint8_t spiApb1[SIM_SPI_CHANNELS] = {0U, 1U, 1U, 0U};
+
+/** Position of the stream flags on LISR/HISR and LIFCR/HIFCR*/
+static const uint8_t streamFlagShift[4] = {0U, 6U, 16U, 22U};
+
+/** Channels state*/
+static SimSpi_t spi[SIM_SPI_CHANNELS];
+
+/** Devices attached to each channel*/
+static SimSpiSlot_t slot[SIM_SPI_CHANNELS][SIM_SPI_DEVICES];
+static uint8_t slotCount[SIM_SPI_CHANNELS];
+
+/** Items moved by each stream since it was enabled*/
+static uint32_t streamIndex[SIM_DMA_STREAMS];
+
+/** Bounds of the program image, where DMA memory is expected*/
+extern char __executable_start[];
+extern char _end[];
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static uint8_t SIM_spiChannelGet(uint32_t address);
+static uint16_t SIM_spiMask(uint8_t Channel);
+static uint64_t SIM_spiFrameCycles(uint8_t Channel);
+static uint32_t SIM_spiStatus(uint8_t Channel);
+static void SIM_spiSelect(uint8_t Channel, SimSpiSlot_t * const Slot,
+uint8_t selected);
+static void SIM_spiNss(uint8_t Channel);
+static void SIM_spiService(uint8_t Channel, uint64_t cycle);
+static void SIM_spiFrameEnd(uint8_t Channel);
+static uint64_t SIM_spiNext(void *context);
+static void SIM_spiAdvance(void *context, uint64_t cycle);
+static void SIM_spiRead(uint32_t address);
+static void SIM_spiReadDone(uint32_t address);
+static void SIM_spiWrite(uint32_t address, uint32_t previous);
+static uint32_t SIM_streamBase(uint8_t Stream);
+static volatile uint32_t * SIM_streamFlags(uint8_t Stream);
+static uint8_t SIM_streamFind(uint32_t peripheral, uint32_t direction);
+static void * SIM_dmaMemory(uint32_t address);
+static void SIM_dmaTransfer(uint8_t Stream, uint16_t * const frame,
+uint32_t direction);
+static void SIM_dmaWrite(uint32_t address, uint32_t previous);
+
+/** SPI models, one region per channel*/
+static const SimRegion_t SpiRegion[SIM_SPI_CHANNELS] =
+{
+    {SPI1_BASE, sizeof(SPI_TypeDef), SIM_spiRead, SIM_spiReadDone,
+    SIM_spiWrite},
+    {SPI2_BASE, sizeof(SPI_TypeDef), SIM_spiRead, SIM_spiReadDone,
+    SIM_spiWrite},
+    {SPI3_BASE, sizeof(SPI_TypeDef), SIM_spiRead, SIM_spiReadDone,
+    SIM_spiWrite},
+    {SPI4_BASE, sizeof(SPI_TypeDef), SIM_spiRead, SIM_spiReadDone,
+    SIM_spiWrite}
+};
+
+/** DMA models, one region per controller*/
+static const SimRegion_t DmaRegion[2] =
+{
+    {DMA1_BASE, DMA_REGION_SIZE, NULL, NULL, SIM_dmaWrite},
+    {DMA2_BASE, DMA_REGION_SIZE, NULL, NULL, SIM_dmaWrite}
+};
+
+/** Clock client of the shift registers*/
+static const SimClient_t SpiClient =
+{
+    SIM_spiNext, SIM_spiAdvance, NULL
+};
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SIM_spiAttach()
+*//**
+*\b Description:
+ * This function is used to attach a device to a simulated SPI channel. Its
+ * chip select is a GPIO pin or the hardware NSS output of the channel.
+ *
+ * PRE-CONDITION: The Channel is below SIM_SPI_CHANNELS. <br>
+ * PRE-CONDITION: Less than SIM_SPI_DEVICES devices are on the channel. <br>
+ *
+ * POST-CONDITION: The device exchanges frames while it is selected. <br>
+ *
+ * @param[in]   Channel is the SPI channel, SPI1 = 0 to SPI4 = 3.
+ * @param[in]   Device is the device, copied by the simulator.
+ * @param[in]   Port is the chip select port slot, or SIM_NSS.
+ * @param[in]   Pin is the chip select pin, not used with SIM_NSS.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * const SimSpiDevice_t Loopback = {NULL, loopbackExchange, NULL};
+ * SIM_spiAttach(0U, &Loopback, SIM_NSS, 0U);
+ * @endcode
+ *
+ * @see SIM_spiAttach
+ * @see SIM_spiStatsGet
+ *
+*****************************************************************************/
+void SIM_spiAttach(uint8_t Channel, const SimSpiDevice_t * const Device,
+uint8_t Port, uint8_t Pin)
+{
+    /* Prevent to write out of the device table*/
+    if((Channel >= SIM_SPI_CHANNELS) ||
+    (slotCount[Channel] >= SIM_SPI_DEVICES))
+    {
+        fprintf(stderr, "sim: no room for a device on SPI%u\n",
+        (unsigned)Channel + 1U);
+        abort();
+    }
+
+    SimSpiSlot_t * const Slot = &slot[Channel][slotCount[Channel]++];
+    Slot->Device = *Device;
+    Slot->Port = Port;
+    Slot->Pin = Pin;
+    Slot->selected = 0U;
+
+    const uint8_t low = (Port == SIM_NSS) ? spi[Channel].nssLow :
+    (uint8_t)!SIM_pinGet(Port, Pin);
+    SIM_spiSelect(Channel, Slot, low);
+}
+
+/*****************************************************************************
+ * Function: SIM_spiStatsGet()
+*//**
+*\b Description:
+ * This function is used to get the bus metrics of a channel. The bus
+ * utilization is busyCycles over the cycles elapsed.
+ *
+ * PRE-CONDITION: The Channel is below SIM_SPI_CHANNELS. <br>
+ *
+ * POST-CONDITION: A copy of the metrics is returned. <br>
+ *
+ * @param[in]   Channel is the SPI channel, SPI1 = 0 to SPI4 = 3.
+ *
+ * @return  The metrics of the channel.
+ *
+ * \b Example:
+ * @code
+ * const SimSpiStats_t Stats = SIM_spiStatsGet(0U);
+ * double utilization = (double)Stats.busyCycles / SIM_cyclesGet();
+ * @endcode
+ *
+ * @see SIM_spiStatsGet
+ * @see SIM_spiStatsReset
+ *
+*****************************************************************************/
+SimSpiStats_t SIM_spiStatsGet(uint8_t Channel)
+{
+    return spi[Channel].Stats;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiStatsReset()
+*//**
+*\b Description:
+ * This function is used to clear the bus metrics of a channel.
+ *
+ * PRE-CONDITION: The Channel is below SIM_SPI_CHANNELS. <br>
+ *
+ * POST-CONDITION: The metrics of the channel are zero. <br>
+ *
+ * @param[in]   Channel is the SPI channel, SPI1 = 0 to SPI4 = 3.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SIM_spiStatsReset(0U);
+ * @endcode
+ *
+ * @see SIM_spiStatsGet
+ * @see SIM_spiStatsReset
+ *
+*****************************************************************************/
+void SIM_spiStatsReset(uint8_t Channel)
+{
+    memset(&spi[Channel].Stats, 0, sizeof(spi[Channel].Stats));
+}
+
+/*****************************************************************************
+ * Function: SIM_spiInit()
+*//**
+*\b Description:
+ * This function is used to set the channels to their reset values and to
+ * attach the SPI and DMA regions and the shift register clock client.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+void SIM_spiInit(void)
+{
+    for(uint8_t Channel = 0; Channel < SIM_SPI_CHANNELS; Channel++)
+    {
+        SIM_REG(SIM_ADDRESS(spiBase[Channel], SPI_TypeDef, SR)) = SPI_SR_TXE;
+        SIM_regionAttach(&SpiRegion[Channel]);
+    }
+
+    SIM_regionAttach(&DmaRegion[0]);
+    SIM_regionAttach(&DmaRegion[1]);
+    SIM_clientAttach(&SpiClient);
+}
+
+/*****************************************************************************
+ * Function: SIM_spiPinEdge()
+*//**
+*\b Description:
+ * This function is used to select or deselect the devices whose chip
+ * select is a pin that changed.
+ *
+ * @param[in]   Port is the port slot.
+ * @param[in]   changed are the pins that changed.
+ * @param[in]   level are the new pin levels.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+void SIM_spiPinEdge(uint8_t Port, uint16_t changed, uint16_t level)
+{
+    for(uint8_t Channel = 0; Channel < SIM_SPI_CHANNELS; Channel++)
+    {
+        for(uint8_t i = 0; i < slotCount[Channel]; i++)
+        {
+            SimSpiSlot_t * const Slot = &slot[Channel][i];
+
+            if((Slot->Port == Port) && (changed & (1U << Slot->Pin)))
+            {
+                SIM_spiSelect(Channel, Slot,
+                (uint8_t)!((level >> Slot->Pin) & 1U));
+            }
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiIrqPending()
+*//**
+*\b Description:
+ * This function is used to get the level of the SPI global interrupt of a
+ * channel.
+ *
+ * @param[in]   Channel is the SPI channel.
+ *
+ * @return  1 when an enabled event is set, 0 otherwise.
+ *
+*****************************************************************************/
+uint8_t SIM_spiIrqPending(uint32_t Channel)
+{
+    const SimSpi_t * const Spi = &spi[Channel];
+    const uint32_t cr2 = SIM_REG(SIM_ADDRESS(spiBase[Channel], SPI_TypeDef,
+    CR2));
+
+    return (((cr2 & SPI_CR2_TXEIE) && !Spi->txFull) ||
+    ((cr2 & SPI_CR2_RXNEIE) && Spi->rxFull) ||
+    ((cr2 & SPI_CR2_ERRIE) && Spi->overrun)) ? 1U : 0U;
+}
+
+/*****************************************************************************
+ * Function: SIM_dmaIrqPending()
+*//**
+*\b Description:
+ * This function is used to get the level of the interrupt of a stream.
+ *
+ * @param[in]   Stream is the stream, DMA1 = 0 to 7 and DMA2 = 8 to 15.
+ *
+ * @return  1 when an enabled flag is set, 0 otherwise.
+ *
+*****************************************************************************/
+uint8_t SIM_dmaIrqPending(uint32_t Stream)
+{
+    const uint32_t cr = SIM_REG(SIM_ADDRESS(SIM_streamBase((uint8_t)Stream),
+    DMA_Stream_TypeDef, CR));
+    const uint32_t flags = (*SIM_streamFlags((uint8_t)Stream) >>
+    streamFlagShift[Stream % 4U]);
+
+    return (((cr & DMA_SxCR_TCIE) && (flags & DMA_STREAM_TCIF)) ||
+    ((cr & DMA_SxCR_TEIE) && (flags & DMA_STREAM_TEIF))) ? 1U : 0U;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiChannelGet()
+*//**
+*\b Description:
+ * This function is used to get the channel of a register.
+ *
+ * @param[in]   address is the register address.
+ *
+ * @return  The channel.
+ *
+*****************************************************************************/
+static uint8_t SIM_spiChannelGet(uint32_t address)
+{
+    uint8_t Channel = 0;
+
+    while((address - spiBase[Channel]) >= sizeof(SPI_TypeDef))
+    {
+        Channel++;
+    }
+
+    return Channel;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiMask()
+*//**
+*\b Description:
+ * This function is used to get the frame mask of the data frame format.
+ *
+ * @param[in]   Channel is the SPI channel.
+ *
+ * @return  0xFF or 0xFFFF.
+ *
+*****************************************************************************/
+static uint16_t SIM_spiMask(uint8_t Channel)
+{
+    const uint32_t cr1 = SIM_REG(SIM_ADDRESS(spiBase[Channel], SPI_TypeDef,
+    CR1));
+
+    return (cr1 & SPI_CR1_DFF) ? 0xFFFFU : 0x00FFU;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiFrameCycles()
+*//**
+*\b Description:
+ * This function is used to get the length of a frame in CPU cycles. It is
+ * the frame size times the baud rate prescaler, in cycles of the APB clock
+ * of the channel.
+ *
+ * @param[in]   Channel is the SPI channel.
+ *
+ * @return  The CPU cycles of one frame.
+ *
+*****************************************************************************/
+static uint64_t SIM_spiFrameCycles(uint8_t Channel)
+{
+    const uint32_t cr1 = SIM_REG(SIM_ADDRESS(spiBase[Channel], SPI_TypeDef,
+    CR1));
+    const uint32_t cfgr = SIM_REG(SIM_ADDRESS(RCC_BASE, RCC_TypeDef, CFGR));
+    const uint32_t ppre = spiApb1[Channel] ?
+    ((cfgr & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos) :
+    ((cfgr & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos);
+    const uint32_t apbShift = (ppre < 4U) ? 0U : (ppre - 3U);
+    const uint64_t bits = (cr1 & SPI_CR1_DFF) ? 16U : 8U;
+    const uint64_t prescaler = 2ULL << ((cr1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos);
+
+    return (bits * prescaler) << apbShift;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiStatus()
+*//**
+*\b Description:
+ * This function is used to get SR from the state of a channel.
+ *
+ * @param[in]   Channel is the SPI channel.
+ *
+ * @return  The status register.
+ *
+*****************************************************************************/
+static uint32_t SIM_spiStatus(uint8_t Channel)
+{
+    const SimSpi_t * const Spi = &spi[Channel];
+    const uint32_t cr1 = SIM_REG(SIM_ADDRESS(spiBase[Channel], SPI_TypeDef,
+    CR1));
+    uint32_t sr = 0;
+
+    if(Spi->rxFull)
+    {
+        sr |= SPI_SR_RXNE;
+    }
+    if(!Spi->txFull)
+    {
+        sr |= SPI_SR_TXE;
+    }
+    if(Spi->overrun)
+    {
+        sr |= SPI_SR_OVR;
+    }
+    if(Spi->shifting || (Spi->txFull && (cr1 & SPI_CR1_SPE)))
+    {
+        sr |= SPI_SR_BSY;
+    }
+
+    return sr;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiSelect()
+*//**
+*\b Description:
+ * This function is used to move the chip select of a device.
+ *
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Slot is the device.
+ * @param[in]   selected is 1 when the chip select is low.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiSelect(uint8_t Channel, SimSpiSlot_t * const Slot,
+uint8_t selected)
+{
+    if(Slot->selected == selected)
+    {
+        return;
+    }
+
+    Slot->selected = selected;
+    if(selected)
+    {
+        spi[Channel].Stats.selects++;
+    }
+    if(Slot->Device.select != NULL)
+    {
+        Slot->Device.select(Slot->Device.context, selected, SIM_cyclesGet());
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiNss()
+*//**
+*\b Description:
+ * This function is used to update the hardware NSS output. A master with
+ * SSOE drives it low while SPE is set.
+ *
+ * @param[in]   Channel is the SPI channel.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiNss(uint8_t Channel)
+{
+    const uint32_t base = spiBase[Channel];
+    const uint32_t cr1 = SIM_REG(SIM_ADDRESS(base, SPI_TypeDef, CR1));
+    const uint32_t cr2 = SIM_REG(SIM_ADDRESS(base, SPI_TypeDef, CR2));
+    const uint8_t low = ((cr1 & SPI_CR1_MSTR) && (cr1 & SPI_CR1_SPE) &&
+    (cr2 & SPI_CR2_SSOE)) ? 1U : 0U;
+
+    if(low == spi[Channel].nssLow)
+    {
+        return;
+    }
+
+    spi[Channel].nssLow = low;
+    for(uint8_t i = 0; i < slotCount[Channel]; i++)
+    {
+        if(slot[Channel][i].Port == SIM_NSS)
+        {
+            SIM_spiSelect(Channel, &slot[Channel][i], low);
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiService()
+*//**
+*\b Description:
+ * This function is used to move the frames of a channel at a point in
+ * time: the receive stream drains the receive buffer, the transmit stream
+ * fills the transmit buffer and an idle shift register takes the next
+ * frame.
+ *
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   cycle is the point in time.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiService(uint8_t Channel, uint64_t cycle)
+{
+    SimSpi_t * const Spi = &spi[Channel];
+    const uint32_t base = spiBase[Channel];
+    const uint32_t dr = SIM_ADDRESS(base, SPI_TypeDef, DR);
+    uint8_t progress;
+
+    do
+    {
+        const uint32_t cr1 = SIM_REG(SIM_ADDRESS(base, SPI_TypeDef, CR1));
+        const uint32_t cr2 = SIM_REG(SIM_ADDRESS(base, SPI_TypeDef, CR2));
+        progress = 0U;
+
+        if((cr2 & SPI_CR2_RXDMAEN) && Spi->rxFull)
+        {
+            const uint8_t Stream = SIM_streamFind(dr, DMA_PERIPH_TO_MEMORY);
+            if(Stream != NO_STREAM)
+            {
+                uint16_t frame = Spi->rxBuffer;
+                SIM_dmaTransfer(Stream, &frame, DMA_PERIPH_TO_MEMORY);
+                Spi->rxFull = 0U;
+                progress = 1U;
+            }
+        }
+
+        if((cr2 & SPI_CR2_TXDMAEN) && !Spi->txFull)
+        {
+            const uint8_t Stream = SIM_streamFind(dr, DMA_MEMORY_TO_PERIPH);
+            if(Stream != NO_STREAM)
+            {
+                uint16_t frame = 0;
+                SIM_dmaTransfer(Stream, &frame, DMA_MEMORY_TO_PERIPH);
+                Spi->txBuffer = frame & SIM_spiMask(Channel);
+                Spi->txFull = 1U;
+                progress = 1U;
+            }
+        }
+
+        if(!Spi->shifting && Spi->txFull && (cr1 & SPI_CR1_SPE) &&
+        (cr1 & SPI_CR1_MSTR))
+        {
+            Spi->shift = Spi->txBuffer;
+            Spi->txFull = 0U;
+            Spi->shifting = 1U;
+            Spi->frameCycles = SIM_spiFrameCycles(Channel);
+            Spi->shiftEnd = cycle + Spi->frameCycles;
+            progress = 1U;
+        }
+    }while(progress);
+}
+
+/*****************************************************************************
+ * Function: SIM_spiFrameEnd()
+*//**
+*\b Description:
+ * This function is used to complete the frame in the shift register. The
+ * selected devices exchange it, an undriven MISO reads ones.
+ *
+ * @param[in]   Channel is the SPI channel.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiFrameEnd(uint8_t Channel)
+{
+    SimSpi_t * const Spi = &spi[Channel];
+    uint16_t miso = SIM_spiMask(Channel);
+
+    for(uint8_t i = 0; i < slotCount[Channel]; i++)
+    {
+        const SimSpiSlot_t * const Slot = &slot[Channel][i];
+
+        if(Slot->selected && (Slot->Device.exchange != NULL))
+        {
+            miso &= Slot->Device.exchange(Slot->Device.context, Spi->shift,
+            Spi->shiftEnd);
+        }
+    }
+
+    Spi->shifting = 0U;
+    Spi->Stats.frames++;
+    Spi->Stats.busyCycles += Spi->frameCycles;
+
+    /* A full receive buffer keeps its frame, the new one is lost*/
+    if(Spi->rxFull)
+    {
+        Spi->overrun = 1U;
+        Spi->Stats.overruns++;
+    }
+    else
+    {
+        Spi->rxBuffer = miso;
+        Spi->rxFull = 1U;
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiNext()
+*//**
+*\b Description:
+ * This function is used to get the next frame completion of the channels.
+ *
+ * @param[in]   context is not used.
+ *
+ * @return  The cycle, or SIM_NEVER.
+ *
+*****************************************************************************/
+static uint64_t SIM_spiNext(void *context)
+{
+    uint64_t next = SIM_NEVER;
+    (void)context;
+
+    for(uint8_t Channel = 0; Channel < SIM_SPI_CHANNELS; Channel++)
+    {
+        if(spi[Channel].shifting && (spi[Channel].shiftEnd < next))
+        {
+            next = spi[Channel].shiftEnd;
+        }
+    }
+
+    return next;
+}
+
+/*****************************************************************************
+ * Function: SIM_spiAdvance()
+*//**
+*\b Description:
+ * This function is used to complete the frames due by a cycle and to start
+ * the next ones back to back.
+ *
+ * @param[in]   context is not used.
+ * @param[in]   cycle is the point in time.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiAdvance(void *context, uint64_t cycle)
+{
+    (void)context;
+
+    for(uint8_t Channel = 0; Channel < SIM_SPI_CHANNELS; Channel++)
+    {
+        SimSpi_t * const Spi = &spi[Channel];
+
+        if(Spi->shifting && (Spi->shiftEnd <= cycle))
+        {
+            const uint64_t end = Spi->shiftEnd;
+            SIM_spiFrameEnd(Channel);
+            SIM_spiService(Channel, end);
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiRead()
+*//**
+*\b Description:
+ * This function is used to present SR and DR before they are read.
+ *
+ * @param[in]   address is the register read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiRead(uint32_t address)
+{
+    const uint8_t Channel = SIM_spiChannelGet(address);
+    const uint32_t base = spiBase[Channel];
+
+    if(address == SIM_ADDRESS(base, SPI_TypeDef, SR))
+    {
+        SIM_REG(address) = SIM_spiStatus(Channel);
+    }
+    else if(address == SIM_ADDRESS(base, SPI_TypeDef, DR))
+    {
+        SIM_REG(address) = spi[Channel].rxBuffer;
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiReadDone()
+*//**
+*\b Description:
+ * This function is used to apply the side effects of a read. Reading DR
+ * clears RXNE, reading DR then SR clears OVR.
+ *
+ * @param[in]   address is the register read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiReadDone(uint32_t address)
+{
+    const uint8_t Channel = SIM_spiChannelGet(address);
+    const uint32_t base = spiBase[Channel];
+    SimSpi_t * const Spi = &spi[Channel];
+
+    if(address == SIM_ADDRESS(base, SPI_TypeDef, DR))
+    {
+        Spi->rxFull = 0U;
+        Spi->overrunRead = Spi->overrun;
+        SIM_spiService(Channel, SIM_cyclesGet());
+    }
+    else if((address == SIM_ADDRESS(base, SPI_TypeDef, SR)) &&
+    Spi->overrunRead)
+    {
+        Spi->overrun = 0U;
+        Spi->overrunRead = 0U;
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_spiWrite()
+*//**
+*\b Description:
+ * This function is used to apply a store on a channel. Writing DR fills
+ * the transmit buffer, SR is read only and the control registers move
+ * NSS and may start a frame.
+ *
+ * @param[in]   address is the register written.
+ * @param[in]   previous is the value before the store.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_spiWrite(uint32_t address, uint32_t previous)
+{
+    const uint8_t Channel = SIM_spiChannelGet(address);
+    const uint32_t base = spiBase[Channel];
+    SimSpi_t * const Spi = &spi[Channel];
+
+    if(address == SIM_ADDRESS(base, SPI_TypeDef, DR))
+    {
+        /* A write on a full buffer replaces the frame waiting*/
+        Spi->txBuffer = (uint16_t)SIM_REG(address) & SIM_spiMask(Channel);
+        Spi->txFull = 1U;
+        SIM_REG(address) = Spi->rxBuffer;
+    }
+    else if(address == SIM_ADDRESS(base, SPI_TypeDef, SR))
+    {
+        SIM_REG(address) = previous;
+    }
+    else
+    {
+        SIM_spiNss(Channel);
+    }
+
+    SIM_spiService(Channel, SIM_cyclesGet());
+}
+
+/*****************************************************************************
+ * Function: SIM_streamBase()
+*//**
+*\b Description:
+ * This function is used to get the base address of a stream.
+ *
+ * @param[in]   Stream is the stream, DMA1 = 0 to 7 and DMA2 = 8 to 15.
+ *
+ * @return  The base address.
+ *
+*****************************************************************************/
+static uint32_t SIM_streamBase(uint8_t Stream)
+{
+    const uint32_t controller = (Stream < STREAMS_PER_DMA) ? DMA1_BASE :
+    DMA2_BASE;
+
+    return controller + DMA_STREAM_OFFSET +
+    ((uint32_t)(Stream % STREAMS_PER_DMA) * DMA_STREAM_SIZE);
+}
+
+/*****************************************************************************
+ * Function: SIM_streamFlags()
+*//**
+*\b Description:
+ * This function is used to get the interrupt status register of a stream.
+ *
+ * @param[in]   Stream is the stream, DMA1 = 0 to 7 and DMA2 = 8 to 15.
+ *
+ * @return  The backdoor of LISR or HISR.
+ *
+*****************************************************************************/
+static volatile uint32_t * SIM_streamFlags(uint8_t Stream)
+{
+    const uint32_t controller = (Stream < STREAMS_PER_DMA) ? DMA1_BASE :
+    DMA2_BASE;
+
+    return ((Stream % STREAMS_PER_DMA) < 4U) ?
+    SIM_registerGet(SIM_ADDRESS(controller, DMA_TypeDef, LISR)) :
+    SIM_registerGet(SIM_ADDRESS(controller, DMA_TypeDef, HISR));
+}
+
+/*****************************************************************************
+ * Function: SIM_streamFind()
+*//**
+*\b Description:
+ * This function is used to find the enabled stream serving a peripheral
+ * register in a direction.
+ *
+ * @param[in]   peripheral is the address of the peripheral register.
+ * @param[in]   direction is DMA_PERIPH_TO_MEMORY or DMA_MEMORY_TO_PERIPH.
+ *
+ * @return  The stream, or NO_STREAM.
+ *
+*****************************************************************************/
+static uint8_t SIM_streamFind(uint32_t peripheral, uint32_t direction)
+{
+    for(uint8_t Stream = 0; Stream < SIM_DMA_STREAMS; Stream++)
+    {
+        const uint32_t base = SIM_streamBase(Stream);
+        const uint32_t cr = SIM_REG(SIM_ADDRESS(base, DMA_Stream_TypeDef, CR));
+
+        if((cr & DMA_SxCR_EN) && ((cr & DMA_SxCR_DIR) == direction) &&
+        (SIM_REG(SIM_ADDRESS(base, DMA_Stream_TypeDef, PAR)) == peripheral))
+        {
+            return Stream;
+        }
+    }
+
+    return NO_STREAM;
+}
+
+/*****************************************************************************
+ * Function: SIM_dmaMemory()
+*//**
+*\b Description:
+ * This function is used to get the host address of a DMA memory address.
+ * The drivers store 32 bits addresses, the upper half is the one of the
+ * program image, so DMA buffers must be static as on the target.
+ *
+ * @param[in]   address is the memory address of the stream.
+ *
+ * @return  The host address.
+ *
+*****************************************************************************/
+static void * SIM_dmaMemory(uint32_t address)
+{
+    const uintptr_t image = (uintptr_t)__executable_start;
+    const uintptr_t host = (image & ~(uintptr_t)0xFFFFFFFFUL) | address;
+
+    if((host < image) || (host >= (uintptr_t)_end))
+    {
+        fprintf(stderr, "sim: DMA memory 0x%08lx is not static data\n",
+        (unsigned long)address);
+        abort();
+    }
+
+    return (void *)host;
+}
+
+/*****************************************************************************
+ * Function: SIM_dmaTransfer()
+*//**
+*\b Description:
+ * This function is used to move one item of a stream. The stream disables
+ * itself and sets TCIF on its last item.
+ *
+ * @param[in]   Stream is the stream.
+ * @param[in,out] frame is the peripheral side of the item.
+ * @param[in]   direction is DMA_PERIPH_TO_MEMORY or DMA_MEMORY_TO_PERIPH.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_dmaTransfer(uint8_t Stream, uint16_t * const frame,
+uint32_t direction)
+{
+    const uint32_t base = SIM_streamBase(Stream);
+    volatile uint32_t * const Cr =
+    SIM_registerGet(SIM_ADDRESS(base, DMA_Stream_TypeDef, CR));
+    volatile uint32_t * const Ndtr =
+    SIM_registerGet(SIM_ADDRESS(base, DMA_Stream_TypeDef, NDTR));
+    const uint32_t size = 1UL << ((*Cr & DMA_SxCR_MSIZE) >>
+    DMA_SxCR_MSIZE_Pos);
+    const uint32_t offset = (*Cr & DMA_SxCR_MINC) ?
+    (streamIndex[Stream] * size) : 0U;
+    void * const memory = SIM_dmaMemory(SIM_REG(SIM_ADDRESS(base,
+    DMA_Stream_TypeDef, M0AR)) + offset);
+    uint32_t item = *frame;
+
+    if(direction == DMA_PERIPH_TO_MEMORY)
+    {
+        memcpy(memory, &item, size);
+    }
+    else
+    {
+        item = 0;
+        memcpy(&item, memory, size);
+        *frame = (uint16_t)item;
+    }
+
+    streamIndex[Stream]++;
+    *Ndtr = (*Ndtr - 1UL) & 0xFFFFUL;
+    if(*Ndtr == 0UL)
+    {
+        *Cr &= ~DMA_SxCR_EN;
+        *SIM_streamFlags(Stream) |= (DMA_STREAM_TCIF <<
+        streamFlagShift[Stream % 4U]);
+    }
+}
+
+/*****************************************************************************
+ * Function: SIM_dmaWrite()
+*//**
+*\b Description:
+ * This function is used to apply a store on a DMA controller. LIFCR and
+ * HIFCR clear flags, LISR and HISR are read only and enabling a stream
+ * restarts its memory address.
+ *
+ * @param[in]   address is the register written.
+ * @param[in]   previous is the value before the store.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SIM_dmaWrite(uint32_t address, uint32_t previous)
+{
+    const uint32_t controller = (address < DMA2_BASE) ? DMA1_BASE :
+    DMA2_BASE;
+    const uint32_t offset = address - controller;
+
+    if(offset == offsetof(DMA_TypeDef, LIFCR))
+    {
+        SIM_REG(SIM_ADDRESS(controller, DMA_TypeDef, LISR)) &=
+        ~SIM_REG(address);
+        SIM_REG(address) = 0U;
+    }
+    else if(offset == offsetof(DMA_TypeDef, HIFCR))
+    {
+        SIM_REG(SIM_ADDRESS(controller, DMA_TypeDef, HISR)) &=
+        ~SIM_REG(address);
+        SIM_REG(address) = 0U;
+    }
+    else if(offset < DMA_STREAM_OFFSET)
+    {
+        SIM_REG(address) = previous;
+    }
+    else if(((offset - DMA_STREAM_OFFSET) % DMA_STREAM_SIZE) ==
+    offsetof(DMA_Stream_TypeDef, CR))
+    {
+        const uint8_t Stream = (uint8_t)(((offset - DMA_STREAM_OFFSET) /
+        DMA_STREAM_SIZE) + ((controller == DMA2_BASE) ? STREAMS_PER_DMA :
+        0U));
+
+        if(!(previous & DMA_SxCR_EN) && (SIM_REG(address) & DMA_SxCR_EN))
+        {
+            streamIndex[Stream] = 0U;
+        }
+    }
+
+    for(uint8_t Channel = 0; Channel < SIM_SPI_CHANNELS; Channel++)
+    {
+        SIM_spiService(Channel, SIM_cyclesGet());
+    }
+}
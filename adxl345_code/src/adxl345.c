@@ -14,17 +14,132 @@
 * Includes
 *****************************************************************************/
 #include "adxl345.h"
+#include "clock.h"
+#include "probe.h"
+#include "scale.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** SPI clocks of a sample read: address frame plus six data frames*/
+#define SAMPLE_READ_CLOCKS      ((1U + AXIS_BYTES) * 8U)
+/** SPI clock recommended by the datasheet for 1600 Hz and 3200 Hz*/
+#define HIGH_ODR_MIN_SPI_HZ     (2000000UL)
+/** Writable registers: 0x1D to 0x2A, 0x2C to 0x2F, 0x31 and 0x38*/
+#define WRITABLE_REGISTERS      ((((1ULL << EVENT_BLOCK_SIZE) - 1ULL) << \
+    THRESH_TAP_R) | (((1ULL << RATE_BLOCK_SIZE) - 1ULL) << BW_RATE_R) | \
+    (1ULL << DATA_FORMAT_R) | (1ULL << FIFO_CTL_R))
+/** Clean writable registers bridged inside a flush burst. Resending one
+ * register costs a frame, the same as the address frame of a new burst.
+*/
+#define FLUSH_GAP_MAX           (1U)
+/** CS assert to first SCLK edge, tDELAY is 5 ns: below one CPU cycle*/
+#define CS_SETUP_CYCLES         (0U)
+/** Last SCLK edge to CS release, tQUIET is 5 ns: below one CPU cycle*/
+#define CS_HOLD_CYCLES          (0U)
+/** End of a data registers read to the next FIFO or FIFO_STATUS read*/
+#define FIFO_POP_US             (5UL)
+
+/*****************************************************************************
+* Module Preprocessor Macros
+*****************************************************************************/
+/** Minimum SPI clock to read every sample produced at odrMilliHz*/
+#define MIN_SPI_HZ(odrMilliHz) \
+    ((((odrMilliHz) * SAMPLE_READ_CLOCKS) + 999UL) / 1000UL)
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines the RAM copy of the writable registers of a device. A set bit in
+ * dirty marks a register changed in RAM and not yet sent.
+ */
+typedef struct
+{
+    uint8_t image[REGISTER_MAP_SIZE];   /**< Register values by address */
+    uint64_t dirty;                     /**< Registers pending a flush */
+}Adxl345Shadow_t;
 
 /*****************************************************************************
 * Module Variable Definitions
 *****************************************************************************/
 char data;
 
+/** Register shadow of each device*/
+static Adxl345Shadow_t shadow[ADXL345_DEVICES_NUMBER];
+
+/**
+ * The following table contains, for each output data rate, the rate in mHz
+ * and the minimum SPI clock needed to read every sample it produces. The 
+ * minimum is raised to 2 MHz at 1600 Hz and 3200 Hz as the datasheet 
+ * recommends.
+*/
+static const struct
+{
+    uint32_t odrMilliHz;            /**< Output data rate in mHz */
+    uint32_t minSpiHz;              /**< Minimum SPI clock in Hz */
+}odrTable[ADXL345_MAX_ODR] =
+{
+    {100UL,     MIN_SPI_HZ(100UL)},
+    {200UL,     MIN_SPI_HZ(200UL)},
+    {390UL,     MIN_SPI_HZ(390UL)},
+    {780UL,     MIN_SPI_HZ(780UL)},
+    {1560UL,    MIN_SPI_HZ(1560UL)},
+    {3130UL,    MIN_SPI_HZ(3130UL)},
+    {6250UL,    MIN_SPI_HZ(6250UL)},
+    {12500UL,   MIN_SPI_HZ(12500UL)},
+    {25000UL,   MIN_SPI_HZ(25000UL)},
+    {50000UL,   MIN_SPI_HZ(50000UL)},
+    {100000UL,  MIN_SPI_HZ(100000UL)},
+    {200000UL,  MIN_SPI_HZ(200000UL)},
+    {400000UL,  MIN_SPI_HZ(400000UL)},
+    {800000UL,  MIN_SPI_HZ(800000UL)},
+    {1600000UL, HIGH_ODR_MIN_SPI_HZ},
+    {3200000UL, HIGH_ODR_MIN_SPI_HZ}
+};
+
+/** Device being read through DMA on each SPI channel*/
+static const Adxl345Config_t * dmaConfig[SPI_PORTS_NUMBER];
+
+/** Application callback of the DMA read on each SPI channel*/
+static Adxl345Callback_t dmaCallback[SPI_PORTS_NUMBER];
+
+/** Frames sent by the DMA read on each SPI channel*/
+static uint16_t dmaTxFrames[SPI_PORTS_NUMBER][REGISTER_MAP_SIZE + 1U];
+
+/** Frames received by the DMA read on each SPI channel*/
+static uint16_t dmaRxFrames[SPI_PORTS_NUMBER][REGISTER_MAP_SIZE + 1U];
+
+/** Caller buffer and size of the DMA read on each SPI channel*/
+static uint16_t *dmaData[SPI_PORTS_NUMBER];
+static uint16_t dmaSize[SPI_PORTS_NUMBER];
+
+/** Address of the DMA read on each SPI channel*/
+static uint16_t dmaAddress[SPI_PORTS_NUMBER];
+
+/** Samples popped from the FIFO by a failed read, for each device*/
+static uint32_t lostSamples[ADXL345_DEVICES_NUMBER];
+
+/** CYCCNT at the end of the last data registers read of each device, the
+ * FIFO is still popping until popCycles have elapsed*/
+static uint32_t popStamp[ADXL345_DEVICES_NUMBER];
+static uint8_t popPending[ADXL345_DEVICES_NUMBER];
+
+/** HCLK cycles of FIFO_POP_US*/
+static uint32_t popCycles;
+
 /*****************************************************************************
 * Function Prototypes
 *****************************************************************************/
-static void ADXL345_write(const Adxl345Config_t * const Config, 
+static SpiStatus_t ADXL345_write(const Adxl345Config_t * const Config, 
 uint8_t address, uint8_t value);
+static SpiStatus_t ADXL345_writeBurst(const Adxl345Config_t * const Config, 
+uint8_t address, const uint8_t * const values, uint8_t count);
+static uint8_t ADXL345_dataRead(uint16_t address, uint16_t size);
+static void ADXL345_popWait(const Adxl345Config_t * const Config, 
+uint16_t address, uint16_t size);
+static void ADXL345_popMark(const Adxl345Config_t * const Config);
+static void ADXL345_dmaComplete(SpiChannel_t Channel, SpiStatus_t Status);
 
 /*****************************************************************************
 * Function Definitions
@@ -46,9 +161,11 @@ uint8_t address, uint8_t value);
  * POST-CONDITION: The ADXL345 is set up with the configuration settings.
  * 
  * @param[in]   Config A pointer to a structure containing the channel, port, 
- *              and pin of the SPI.
+ *              pin of the SPI, the data rate, range and resolution, the 
+ *              FIFO mode and watermark, and the interrupt sources enabled 
+ *              and mapped to INT1 or INT2.
  * 
- * @return  void
+ * @return  SPI_OK, or the SPI fault that stopped the configuration.
  * 
  * \b Example:
  * @code
@@ -64,7 +181,15 @@ uint8_t address, uint8_t value);
  * {
  *    .Channel = SPI_CHANNEL1,
  *    .Port = DIO_PA, 
- *    .Pin = DIO_PA4
+ *    .Pin = DIO_PA4,
+ *    .Odr = ADXL345_ODR_3200HZ,
+ *    .Range = ADXL345_RANGE_4G,
+ *    .Resolution = ADXL345_10BIT,
+ *    .LowPower = 0,
+ *    .FifoMode = ADXL345_FIFO_STREAM,
+ *    .Watermark = 16,
+ *    .IntEnable = INT_WATERMARK,
+ *    .IntMap = 0
  * };
  * 
  * ADXL345(&Adxl345Config);
@@ -81,14 +206,458 @@ uint8_t address, uint8_t value);
  * @see ADXL345_write
  * 
 *****************************************************************************/
-void ADXL345_init(const Adxl345Config_t * const Config)
+SpiStatus_t ADXL345_init(const Adxl345Config_t * const Config)
 {
-    /*Set data format range to +-4g*/
-    ADXL345_write(Config, DATA_FORMAT_R, FOUR_G);
-    /*Reset all bits*/
-    ADXL345_write(Config, POWER_CTL_R, RESET);
-    /*Configure power control measure bit*/
-    ADXL345_write(Config, POWER_CTL_R, SET_MEASURE);
+    /* Prevent to use a device without a register shadow*/
+    assert(Config->Device < ADXL345_DEVICES_NUMBER);
+
+    lostSamples[Config->Device] = 0;
+    popPending[Config->Device] = 0;
+    popCycles = (CLOCK_hclkGet() / 1000000UL) * FIFO_POP_US;
+
+    /*Write the whole configuration in bursts*/
+    return ADXL345_configApply(Config);
+}
+
+/*****************************************************************************
+ * Function: ADXL345_configApply()
+*//**
+*\b Description:
+ * This function is used to write every ADXL345 setting of a configuration
+ * using the minimum number of chip select windows. Contiguous registers 
+ * are written as multibyte bursts: BW_RATE to INT_MAP (0x2C to 0x2F) and 
+ * THRESH_TAP to TAP_AXES (0x1D to 0x2A). The device is held in standby 
+ * with its interrupts disabled while it is reconfigured, and measurement 
+ * and the interrupts are enabled together in the last burst. Six windows 
+ * replace one window per register. The sequence stops at the first fault,
+ * the shadow then holds the new settings with every register dirty, so 
+ * ADXL345_flush or a new call completes the configuration.
+ * 
+ * PRE-CONDITION: SPI peripheral should be configured. <br>
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: The settings are within their maximum values. <br>
+ *
+ * POST-CONDITION: On SPI_OK the ADXL345 is measuring with the 
+ * configuration settings, and the FIFO is cleared. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * 
+ * @return  SPI_OK, or the SPI fault that stopped the sequence.
+ * 
+ * \b Example:
+ * @code
+ * Adxl345Config.Events.ThreshAct = 16;
+ * Adxl345Config.IntEnable |= INT_ACTIVITY;
+ * ADXL345_configApply(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_init
+ * @see ADXL345_configApply
+ * 
+*****************************************************************************/
+SpiStatus_t ADXL345_configApply(const Adxl345Config_t * const Config)
+{
+    /* Prevent to assign a rate, range or resolution out of range*/
+    assert(Config->Odr < ADXL345_MAX_ODR);
+    assert(Config->Range < ADXL345_MAX_RANGE);
+    assert(Config->Resolution < ADXL345_MAX_RESOLUTION);
+    /* Low power is only available from 12.5 Hz to 400 Hz*/
+    assert(!Config->LowPower || ((Config->Odr >= ADXL345_ODR_12_5HZ) && 
+    (Config->Odr <= ADXL345_ODR_400HZ)));
+    /* Prevent to assign a FIFO mode or watermark out of range*/
+    assert(Config->FifoMode < ADXL345_FIFO_MAX_MODE);
+    assert(Config->Watermark <= FIFO_SAMPLES_MASK);
+
+    /* Prevent to use a shadow out of the range of the devices*/
+    assert(Config->Device < ADXL345_DEVICES_NUMBER);
+
+    const Adxl345EventConfig_t * const Events = &Config->Events;
+    Adxl345Shadow_t * const Shadow = &shadow[Config->Device];
+
+    /*BW_RATE, POWER_CTL, INT_ENABLE and INT_MAP: set the rate, enter 
+    standby with the interrupts disabled and route the sources*/
+    const uint8_t rateBlock[RATE_BLOCK_SIZE] =
+    {
+        (uint8_t)(Config->Odr | (Config->LowPower ? LOW_POWER : 0U)),
+        RESET,
+        RESET,
+        Config->IntMap
+    };
+
+    /*THRESH_TAP to TAP_AXES in register order*/
+    const uint8_t eventBlock[EVENT_BLOCK_SIZE] =
+    {
+        Events->ThreshTap, (uint8_t)Events->OffsetX, 
+        (uint8_t)Events->OffsetY, (uint8_t)Events->OffsetZ, 
+        Events->TapDuration, Events->TapLatency, Events->TapWindow,
+        Events->ThreshAct, Events->ThreshInact, Events->TimeInact,
+        Events->ActInactCtl, Events->ThreshFreeFall, Events->TimeFreeFall,
+        Events->TapAxes
+    };
+
+    /*POWER_CTL and INT_ENABLE: start measuring and enable the sources*/
+    const uint8_t startBlock[] = {SET_MEASURE, Config->IntEnable};
+
+    /*Set data format range and resolution*/
+    const uint8_t dataFormat = (uint8_t)(Config->Range | 
+    ((Config->Resolution == ADXL345_FULL_RES) ? FULL_RES : 0U));
+
+    /*Pass through bypass to clear the FIFO, then set mode and watermark*/
+    const uint8_t fifoCtl = 
+    (uint8_t)((Config->FifoMode << FIFO_MODE_POS) | Config->Watermark);
+
+    /*Each window needs the previous ones on the device, stop at a fault*/
+    SpiStatus_t result = ADXL345_writeBurst(Config, BW_RATE_R, rateBlock, 
+    RATE_BLOCK_SIZE);
+    if(result == SPI_OK)
+    {
+        result = ADXL345_writeBurst(Config, THRESH_TAP_R, eventBlock, 
+        EVENT_BLOCK_SIZE);
+    }
+    if(result == SPI_OK)
+    {
+        result = ADXL345_write(Config, DATA_FORMAT_R, dataFormat);
+    }
+    if(result == SPI_OK)
+    {
+        result = ADXL345_write(Config, FIFO_CTL_R, RESET);
+    }
+    if(result == SPI_OK)
+    {
+        result = ADXL345_write(Config, FIFO_CTL_R, fifoCtl);
+    }
+    if(result == SPI_OK)
+    {
+        result = ADXL345_writeBurst(Config, POWER_CTL_R, startBlock, 
+        sizeof(startBlock)/sizeof(startBlock[0]));
+    }
+
+    /*The shadow holds the new settings, it mirrors the device once every 
+    window is written*/
+    for(uint8_t i = 0; i < EVENT_BLOCK_SIZE; i++)
+    {
+        Shadow->image[THRESH_TAP_R + i] = eventBlock[i];
+    }
+    for(uint8_t i = 0; i < RATE_BLOCK_SIZE; i++)
+    {
+        Shadow->image[BW_RATE_R + i] = rateBlock[i];
+    }
+    Shadow->image[POWER_CTL_R] = startBlock[0];
+    Shadow->image[INT_ENABLE_R] = startBlock[1];
+    Shadow->image[DATA_FORMAT_R] = dataFormat;
+    Shadow->image[FIFO_CTL_R] = fifoCtl;
+    Shadow->dirty = (result == SPI_OK) ? 0U : WRITABLE_REGISTERS;
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: ADXL345_registerSet()
+*//**
+*\b Description:
+ * This function is used to set a configuration register in the register 
+ * shadow. No SPI traffic is generated, the register is marked dirty only 
+ * when its value changes and is sent by the next ADXL345_flush.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: address is a writable register. <br>
+ *
+ * POST-CONDITION: The shadow holds value for the register. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * @param[in]   address is a writable register address.
+ * @param[in]   value is the data to set the register.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * ADXL345_registerSet(&Adxl345Config, THRESH_TAP_R, 48);
+ * ADXL345_flush(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_registerSet
+ * @see ADXL345_registerUpdate
+ * @see ADXL345_registerGet
+ * @see ADXL345_flush
+ * 
+*****************************************************************************/
+void ADXL345_registerSet(const Adxl345Config_t * const Config, 
+uint8_t address, uint8_t value)
+{
+    /* Prevent to use a shadow out of the range of the devices*/
+    assert(Config->Device < ADXL345_DEVICES_NUMBER);
+    /* Prevent to set a read only or reserved register*/
+    assert((address < REGISTER_MAP_SIZE) && 
+    (WRITABLE_REGISTERS & (1ULL << address)));
+
+    Adxl345Shadow_t * const Shadow = &shadow[Config->Device];
+
+    if(Shadow->image[address] != value)
+    {
+        Shadow->image[address] = value;
+        Shadow->dirty |= (1ULL << address);
+    }
+}
+
+/*****************************************************************************
+ * Function: ADXL345_registerUpdate()
+*//**
+*\b Description:
+ * This function is used to modify the bits of a configuration register in 
+ * the register shadow. The current value comes from RAM, so the read of 
+ * the read-modify-write costs no SPI transaction.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: address is a writable register. <br>
+ *
+ * POST-CONDITION: The masked bits of the register hold value. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * @param[in]   address is a writable register address.
+ * @param[in]   mask selects the bits to modify.
+ * @param[in]   value is the new state of the masked bits.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * ADXL345_registerUpdate(&Adxl345Config, INT_ENABLE_R, INT_ACTIVITY, 
+ * INT_ACTIVITY);
+ * ADXL345_flush(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_registerSet
+ * @see ADXL345_registerUpdate
+ * @see ADXL345_registerGet
+ * @see ADXL345_flush
+ * 
+*****************************************************************************/
+void ADXL345_registerUpdate(const Adxl345Config_t * const Config, 
+uint8_t address, uint8_t mask, uint8_t value)
+{
+    const uint8_t current = ADXL345_registerGet(Config, address);
+
+    ADXL345_registerSet(Config, address, 
+    (uint8_t)((current & ~mask) | (value & mask)));
+}
+
+/*****************************************************************************
+ * Function: ADXL345_registerGet()
+*//**
+*\b Description:
+ * This function is used to get a configuration register from the register
+ * shadow, including changes not yet flushed.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: address is a writable register. <br>
+ *
+ * POST-CONDITION: The cached register value is returned. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * @param[in]   address is a writable register address.
+ * 
+ * @return  The register value held by the shadow.
+ * 
+ * \b Example:
+ * @code
+ * uint8_t range = ADXL345_registerGet(&Adxl345Config, DATA_FORMAT_R) & 0x03;
+ * @endcode
+ * 
+ * @see ADXL345_registerSet
+ * @see ADXL345_registerUpdate
+ * @see ADXL345_registerGet
+ * @see ADXL345_flush
+ * 
+*****************************************************************************/
+uint8_t ADXL345_registerGet(const Adxl345Config_t * const Config, 
+uint8_t address)
+{
+    /* Prevent to use a shadow out of the range of the devices*/
+    assert(Config->Device < ADXL345_DEVICES_NUMBER);
+    /* Only the writable registers are cached*/
+    assert((address < REGISTER_MAP_SIZE) && 
+    (WRITABLE_REGISTERS & (1ULL << address)));
+
+    return shadow[Config->Device].image[address];
+}
+
+/*****************************************************************************
+ * Function: ADXL345_flush()
+*//**
+*\b Description:
+ * This function is used to send the dirty registers of the shadow to the 
+ * device. Runs of dirty registers are written as multibyte bursts, a clean
+ * register between two dirty ones is resent rather than opening a new 
+ * chip select window, and a burst never crosses a read only register. The
+ * registers of a burst are written in ascending address order. The flush
+ * stops at the first fault and the registers not written stay dirty.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ *
+ * POST-CONDITION: On SPI_OK the device matches the shadow and no register
+ * is dirty. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * 
+ * @return  SPI_OK, or the SPI fault that stopped the flush.
+ * 
+ * \b Example:
+ * @code
+ * ADXL345_registerSet(&Adxl345Config, THRESH_ACT_R, 20);
+ * ADXL345_registerUpdate(&Adxl345Config, INT_ENABLE_R, INT_ACTIVITY, 
+ * INT_ACTIVITY);
+ * ADXL345_flush(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_registerSet
+ * @see ADXL345_registerUpdate
+ * @see ADXL345_registerGet
+ * @see ADXL345_flush
+ * 
+*****************************************************************************/
+SpiStatus_t ADXL345_flush(const Adxl345Config_t * const Config)
+{
+    /* Prevent to use a shadow out of the range of the devices*/
+    assert(Config->Device < ADXL345_DEVICES_NUMBER);
+
+    Adxl345Shadow_t * const Shadow = &shadow[Config->Device];
+    uint8_t address = THRESH_TAP_R;
+    SpiStatus_t result = SPI_OK;
+
+    while((Shadow->dirty != 0U) && (result == SPI_OK))
+    {
+        /*Find the start of the next dirty run*/
+        while(!(Shadow->dirty & (1ULL << address)))
+        {
+            address++;
+        }
+
+        /*Extend the run over dirty registers, bridging short clean gaps 
+        of writable registers*/
+        uint8_t end = address;
+        uint8_t next = (uint8_t)(address + 1U);
+        while((next < REGISTER_MAP_SIZE) && 
+        (WRITABLE_REGISTERS & (1ULL << next)))
+        {
+            if(Shadow->dirty & (1ULL << next))
+            {
+                end = next;
+            }
+            else if((uint8_t)(next - end) > FLUSH_GAP_MAX)
+            {
+                break;
+            }
+            next++;
+        }
+
+        const uint8_t count = (uint8_t)(end - address + 1U);
+        result = ADXL345_writeBurst(Config, address, &Shadow->image[address],
+        count);
+        if(result == SPI_OK)
+        {
+            Shadow->dirty &= ~((((1ULL << count) - 1ULL)) << address);
+        }
+        address = (uint8_t)(end + 1U);
+    }
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: ADXL345_scaleFactorGet()
+*//**
+*\b Description:
+ * This function is used to get the g/LSB scale factor matching the range 
+ * and resolution of a device configuration.
+ * 
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ *
+ * POST-CONDITION: The scale factor is returned. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * 
+ * @return  The scale factor in g/LSB.
+ * 
+ * \b Example:
+ * @code
+ * xg = samples[0].x * ADXL345_scaleFactorGet(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_scaleFactorGet
+ * @see ADXL345_odrGet
+ * @see ADXL345_minSpiClockGet
+ * @see SCALE_factorGet
+ * 
+*****************************************************************************/
+float ADXL345_scaleFactorGet(const Adxl345Config_t * const Config)
+{
+    return SCALE_factorGet(Config->Range, Config->Resolution);
+}
+
+/*****************************************************************************
+ * Function: ADXL345_odrGet()
+*//**
+*\b Description:
+ * This function is used to get the output data rate in mHz.
+ * 
+ * PRE-CONDITION: The Odr is within the maximum Adxl345Odr_t. <br>
+ *
+ * POST-CONDITION: The output data rate is returned. <br>
+ * 
+ * @param[in]   Odr is the output data rate.
+ * 
+ * @return  The output data rate in mHz.
+ * 
+ * \b Example:
+ * @code
+ * uint32_t rate = ADXL345_odrGet(ADXL345_ODR_3200HZ); // 3200000
+ * @endcode
+ * 
+ * @see ADXL345_scaleFactorGet
+ * @see ADXL345_odrGet
+ * @see ADXL345_minSpiClockGet
+ * 
+*****************************************************************************/
+uint32_t ADXL345_odrGet(Adxl345Odr_t Odr)
+{
+    /* Prevent to read out of the range of the table*/
+    assert(Odr < ADXL345_MAX_ODR);
+
+    return odrTable[Odr].odrMilliHz;
+}
+
+/*****************************************************************************
+ * Function: ADXL345_minSpiClockGet()
+*//**
+*\b Description:
+ * This function is used to get the minimum SPI clock that sustains an 
+ * output data rate, one seven frames read per sample.
+ * 
+ * PRE-CONDITION: The Odr is within the maximum Adxl345Odr_t. <br>
+ *
+ * POST-CONDITION: The minimum SPI clock is returned. <br>
+ * 
+ * @param[in]   Odr is the output data rate.
+ * 
+ * @return  The minimum SPI clock in Hz.
+ * 
+ * \b Example:
+ * @code
+ * assert(spiClockHz >= ADXL345_minSpiClockGet(Adxl345Config.Odr));
+ * @endcode
+ * 
+ * @see ADXL345_scaleFactorGet
+ * @see ADXL345_odrGet
+ * @see ADXL345_minSpiClockGet
+ * 
+*****************************************************************************/
+uint32_t ADXL345_minSpiClockGet(Adxl345Odr_t Odr)
+{
+    /* Prevent to read out of the range of the table*/
+    assert(Odr < ADXL345_MAX_ODR);
+
+    return odrTable[Odr].minSpiHz;
 }
 
 /*****************************************************************************
@@ -111,7 +680,7 @@ void ADXL345_init(const Adxl345Config_t * const Config)
  * @param[in]   address is a register address within the ADXL345 register map.
  * @param[in]   value is the data to set the ADXL345 register.
  * 
- * @return  void
+ * @return  SPI_OK, or the SPI fault of the last attempt.
  * 
  * \b Example:
  * @code
@@ -132,36 +701,76 @@ void ADXL345_init(const Adxl345Config_t * const Config)
  * @see ADXL345_write
  * 
 *****************************************************************************/
-static void ADXL345_write(const Adxl345Config_t * const Config, 
+static SpiStatus_t ADXL345_write(const Adxl345Config_t * const Config, 
 uint8_t address, uint8_t value)
 {
-    uint16_t data[2];
-    /*Enable multi-byte, place address into buffer*/
-    data[0] = address | MULTI_BYTE_EN;
+    return ADXL345_writeBurst(Config, address, &value, 1U);
+}
+
+/*****************************************************************************
+ * Function: ADXL345_writeBurst()
+*//**
+*\b Description:
+ * This function is used to write consecutive ADXL345 registers in one 
+ * multibyte transaction. The address segment is followed by one frame per 
+ * register, all sent by the SPI layer within a single chip select window.
+ * 
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: address to address + count - 1 are writable registers. <br>
+ * PRE-CONDITION: count is greater than 0 and not greater than 
+ * REGISTER_MAP_SIZE. <br>
+ *
+ * POST-CONDITION: The registers are updated with values. <br>
+ *  
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * @param[in]   address is the first register address.
+ * @param[in]   values are the data to set the registers.
+ * @param[in]   count is the number of registers.
+ * 
+ * @return  SPI_OK, or the SPI fault of the last attempt.
+ * 
+ * @see ADXL345_write
+ * @see ADXL345_writeBurst
+ * @see ADXL345_configApply
+ * 
+*****************************************************************************/
+static SpiStatus_t ADXL345_writeBurst(const Adxl345Config_t * const Config, 
+uint8_t address, const uint8_t * const values, uint8_t count)
+{
+    /* Prevent to write beyond the register map*/
+    assert((count > 0U) && (count <= REGISTER_MAP_SIZE));
+
+    /*Enable multi-byte on the address frame*/
+    const uint16_t addressFrame = address | MULTI_BYTE_EN;
+    uint16_t data[REGISTER_MAP_SIZE];
     /* Place the data into buffer*/
-    data[1] = value;
+    for(uint8_t i = 0; i < count; i++)
+    {
+        data[i] = values[i];
+    }
 
-     /*Define the pin configuration for PA4 (CS line)*/
-     const DioPinConfig_t CSLine = 
-     {
-         .Port = Config->Port,
-         .Pin = Config->Pin
-     };
+    /*Address then data, the received frames are discarded*/
+    const SpiSegment_t Segments[] =
+    {
+        {.txData = &addressFrame, .rxData = NULL, .size = 1U},
+        {.txData = data, .rxData = NULL, .size = count}
+    };
 
-    /*SPI transfer configuration*/
-    SpiTransferConfig_t TransferConfig =
+    /*The SPI layer drives the CS line around both segments*/
+    const SpiTransaction_t Transaction =
     {
-        .Channel = Config->Channel,
-        .size = sizeof(data)/sizeof(data[0]),
-        .data = data
+        .Port = Config->Port,
+        .Pin = Config->Pin,
+        .Segments = Segments,
+        .segmentCount = sizeof(Segments)/sizeof(Segments[0]),
+        .csSetup = CS_SETUP_CYCLES,
+        .csHold = CS_HOLD_CYCLES,
+        .repeatable = 1U,
+        .Callback = NULL
     };
 
-    /*Pull cs line low to enable slave*/
-    DIO_pinWrite(&CSLine, DIO_LOW);
-    /*Transmit data and address*/
-    SPI_transfer(&TransferConfig);
-    /*Pull cs line high to disable slave*/
-    DIO_pinWrite(&CSLine, DIO_HIGH);
+    return SPI_transaction(Config->Channel, &Transaction);
 }
 
 /*****************************************************************************
@@ -169,6 +778,9 @@ uint8_t address, uint8_t value)
 *//**
 *\b Description:
  * This function is used to directly read data from ADXL345 register.
+ * A read of the output data registers pops a sample from the FIFO, so it 
+ * is not restarted after a fault: the sample is counted as lost and the 
+ * fault is returned. Other reads are restarted by SPI_transaction.
  * 
  * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
  * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
@@ -176,6 +788,7 @@ uint8_t address, uint8_t value)
  * PRE-CONDITION: The Port is within the maximum DioPort_t. <br>
  * PRE-CONDITION: The Pin is within the maximum DioPin_t. <br>
  * PRE-CONDITION: It is within the boundaries of the ADXL345 register address. <br>
+ * PRE-CONDITION: size is not greater than REGISTER_MAP_SIZE. <br>
  *
  * POST-CONDITION: The data is stored in the data buffer. <br>
  * 
@@ -184,7 +797,7 @@ uint8_t address, uint8_t value)
  * @param[in]   address is a register address within the ADXL345 register map.
  * @param[in]   value is the data to set the ADXL345 register.
  * 
- * @return  void
+ * @return  SPI_OK, or the SPI fault that aborted the read.
  * 
  * \b Example:
  * @code
@@ -209,43 +822,641 @@ uint8_t address, uint8_t value)
  * @see ADXL345_write
  * 
 *****************************************************************************/
-void ADXL345_read(const Adxl345Config_t * const Config, uint16_t address,
-uint16_t size, uint16_t *data)
+SpiStatus_t ADXL345_read(const Adxl345Config_t * const Config, 
+uint16_t address, uint16_t size, uint16_t *data)
+{
+    /* Prevent to read beyond the register map*/
+    assert(size <= REGISTER_MAP_SIZE);
+
+    /*Set read operation and enable multi-byte*/
+    const uint16_t addressFrame = address | READ_OPERATION | MULTI_BYTE_EN;
+
+    /*Address then one dummy frame per register, the registers are stored 
+    straight into the caller buffer*/
+    const SpiSegment_t Segments[] =
+    {
+        {.txData = &addressFrame, .rxData = NULL, .size = 1U},
+        {.txData = NULL, .rxData = data, .size = size}
+    };
+
+    /*The SPI layer drives the CS line around both segments*/
+    const SpiTransaction_t Transaction =
+    {
+        .Port = Config->Port,
+        .Pin = Config->Pin,
+        .Segments = Segments,
+        .segmentCount = sizeof(Segments)/sizeof(Segments[0]),
+        .csSetup = CS_SETUP_CYCLES,
+        .csHold = CS_HOLD_CYCLES,
+        .repeatable = (uint8_t)!ADXL345_dataRead(address, size),
+        .Callback = NULL
+    };
+
+    /*Let the FIFO finish the pop of the previous data read*/
+    ADXL345_popWait(Config, address, size);
+
+    const SpiStatus_t result = SPI_transaction(Config->Channel, 
+    &Transaction);
+
+    /*A read of the data registers popped its sample once it started*/
+    if((result != SPI_BUSY) && ADXL345_dataRead(address, size))
+    {
+        ADXL345_popMark(Config);
+
+        if(result != SPI_OK)
+        {
+            lostSamples[Config->Device]++;
+        }
+    }
+
+    return result;
+}
+
+/*****************************************************************************
+* Function: ADXL345_readDma()
+*//**
+*\b Description:
+ * This function is used to read data from ADXL345 registers through DMA.
+ * The address and data frames are exchanged by DMA in one full-duplex 
+ * operation, so the function returns as soon as the streams are armed and
+ * reads on different SPI channels progress at the same time. The chip 
+ * select is released and the data is copied to the caller buffer from the
+ * completion interrupt before the callback is called.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: The DMA controller serving the channel is clocked. <br>
+ * PRE-CONDITION: Config and data stay valid until the callback is called. <br>
+ * PRE-CONDITION: The SPI channel callback is owned by this driver while the
+ * read is in progress. <br>
+ *
+ * POST-CONDITION: The read is started and the data is stored in the data
+ * buffer once the callback is called. <br>
+ * 
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * @param[in]   address is a register address within the ADXL345 register map.
+ * @param[in]   size is the number of registers to read.
+ * @param[out]  data is the buffer where the registers are stored.
+ * @param[in]   Callback is the function called on completion, or NULL.
+ * 
+ * @return  SPI_OK when the read is started, or SPI_BUSY while the channel
+ *          is in use. A busy channel is left untouched and the callback is
+ *          not called for a read that did not start.
+ * 
+ * \b Example:
+ * @code
+ * static uint16_t dataAxis[AXIS_BYTES];
+ * ADXL345_readDma(&Adxl345Config, DATA_START_R, AXIS_BYTES, dataAxis, 
+ * axisReady);
+ * @endcode
+ * 
+ * @see ADXL345_init
+ * @see ADXL345_read
+ * @see ADXL345_readDma
+ * @see SPI_dmaAcquire
+ * @see SPI_transceiveDmaStart
+ * 
+*****************************************************************************/
+SpiStatus_t ADXL345_readDma(const Adxl345Config_t * const Config, 
+uint16_t address, uint16_t size, uint16_t *data, Adxl345Callback_t Callback)
 {
-    /*Set read operation*/
-    address |= READ_OPERATION;
-    /*Enable multi-byte*/
-    address |= MULTI_BYTE_EN;
+    /* Prevent to read past the register map*/
+    assert((size > 0U) && (size <= REGISTER_MAP_SIZE));
+    /* Prevent to use an empty data buffer*/
+    assert(data != NULL);
+
+    const SpiChannel_t Channel = Config->Channel;
+    uint16_t * const txFrames = dmaTxFrames[Channel];
 
-    /*Define the pin configuration for PA4 (CS line)*/
-     const DioPinConfig_t CSLine = 
-     {
-         .Port = Config->Port,
-         .Pin = Config->Pin
-     };
+    /*Take the channel first, the buffers, the completion state and the CS
+    line below belong to the read still running on a busy channel*/
+    const SpiStatus_t result = SPI_dmaAcquire(Channel);
+    if(result != SPI_OK)
+    {
+        return result;
+    }
 
-    /* SPI transfer configuration*/
-    SpiTransferConfig_t TransferConfig =
+    /*Define the pin configuration for the CS line*/
+    const DioPinConfig_t CSLine = 
     {
-        .Channel = Config->Channel,
-        .size = 1,
-        .data = &address
+        .Port = Config->Port,
+        .Pin = Config->Pin
     };
 
-    /* SPI transfer configuration*/
-    SpiTransferConfig_t receiverConfig =
+    /*Set read operation and enable multi-byte, then clock the registers*/
+    txFrames[0] = (uint16_t)(address | READ_OPERATION | MULTI_BYTE_EN);
+    for(uint16_t i = 1; i <= size; i++)
+    {
+        txFrames[i] = 0;
+    }
+
+    /* SPI exchange configuration*/
+    SpiTransceiveConfig_t TransceiveConfig =
     {
-        .Channel = Config->Channel,
-        .size = size,
-        .data = data
+        .Channel = Channel,
+        .size = (uint16_t)(size + 1U),
+        .txData = txFrames,
+        .rxData = dmaRxFrames[Channel]
+    };
+
+    /*Remember the device so the completion releases its CS line*/
+    dmaConfig[Channel] = Config;
+    dmaCallback[Channel] = Callback;
+    dmaData[Channel] = data;
+    dmaSize[Channel] = size;
+    dmaAddress[Channel] = address;
+    SPI_callbackRegister(Channel, ADXL345_dmaComplete);
+
+    /*Let the FIFO finish the pop of the previous data read, at most 
+    FIFO_POP_US when the read is chained from the completion interrupt*/
+    ADXL345_popWait(Config, address, size);
+
+    /*Pull cs line low to enable slave, the SPI layer frames a hardware 
+    NSS channel itself*/
+    if(!SPI_hardwareNssGet(Channel))
+    {
+        DIO_pinWrite(&CSLine, DIO_LOW);
+    }
+    /*Move the address and data frames through DMA*/
+    SPI_transceiveDmaStart(&TransceiveConfig);
+
+    return SPI_OK;
+}
+
+/*****************************************************************************
+* Function: ADXL345_readSnapshot()
+*//**
+*\b Description:
+ * This function is used to fetch the interrupt source, the axes and the 
+ * FIFO status in one multibyte transaction. INT_SOURCE (0x30) to 
+ * FIFO_STATUS (0x39) are contiguous, so a single chip select window 
+ * replaces the separate status, data and FIFO reads of an acquisition 
+ * cycle. The raw registers are decoded into the snapshot structure.
+ * FIFO_STATUS is clocked out right after the data registers, before the 
+ * FIFO_POP_US the pop takes, so fifoEntries may still count the sample 
+ * this burst read. Use ADXL345_fifoEntriesGet afterwards for an exact 
+ * count, it waits for the pop to complete.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: Snapshot is not NULL. <br>
+ *
+ * POST-CONDITION: The snapshot is populated. Reading the data registers 
+ * pops one FIFO sample and clears the latched interrupt sources. <br>
+ * 
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * @param[out]  Snapshot is the structure where the decoded data is stored.
+ * 
+ * @return  SPI_OK, or the SPI fault. The snapshot is not updated on a 
+ *          fault.
+ * 
+ * \b Example:
+ * @code
+ * Adxl345Snapshot_t Snapshot;
+ * ADXL345_readSnapshot(&Adxl345Config, &Snapshot);
+ * if(Snapshot.intSource & INT_DATA_READY)
+ * {
+ *     x = Snapshot.x;
+ * }
+ * @endcode
+ * 
+ * @see ADXL345_read
+ * @see ADXL345_readSnapshot
+ * @see ADXL345_interruptSourceGet
+ * @see ADXL345_fifoEntriesGet
+ * 
+*****************************************************************************/
+SpiStatus_t ADXL345_readSnapshot(const Adxl345Config_t * const Config,
+Adxl345Snapshot_t * const Snapshot)
+{
+    /* Prevent to use an empty snapshot*/
+    assert(Snapshot != NULL);
+
+    uint16_t registers[SNAPSHOT_SIZE];
+
+    /*Read INT_SOURCE to FIFO_STATUS in one transaction*/
+    const SpiStatus_t result = 
+    ADXL345_read(Config, SNAPSHOT_START_R, SNAPSHOT_SIZE, registers);
+
+    /*Leave the snapshot untouched when the read failed*/
+    if(result != SPI_OK)
+    {
+        return result;
+    }
+
+    /*Decode the registers, the offsets follow the register map*/
+    Snapshot->intSource = (uint8_t)registers[INT_SOURCE_R - SNAPSHOT_START_R];
+    Snapshot->dataFormat = 
+    (uint8_t)registers[DATA_FORMAT_R - SNAPSHOT_START_R];
+    Snapshot->x = (int16_t)((registers[DATA_START_R - SNAPSHOT_START_R + 1U] 
+    << 8) | registers[DATA_START_R - SNAPSHOT_START_R]);
+    Snapshot->y = (int16_t)((registers[DATA_START_R - SNAPSHOT_START_R + 3U] 
+    << 8) | registers[DATA_START_R - SNAPSHOT_START_R + 2U]);
+    Snapshot->z = (int16_t)((registers[DATA_START_R - SNAPSHOT_START_R + 5U] 
+    << 8) | registers[DATA_START_R - SNAPSHOT_START_R + 4U]);
+    Snapshot->FifoMode = (Adxl345FifoMode_t)
+    (registers[FIFO_CTL_R - SNAPSHOT_START_R] >> FIFO_MODE_POS);
+    Snapshot->watermark = 
+    (uint8_t)(registers[FIFO_CTL_R - SNAPSHOT_START_R] & FIFO_SAMPLES_MASK);
+    Snapshot->fifoEntries = 
+    (uint8_t)(registers[FIFO_STATUS_R - SNAPSHOT_START_R] & FIFO_ENTRIES_MASK);
+    Snapshot->fifoTriggered = 
+    (registers[FIFO_STATUS_R - SNAPSHOT_START_R] & FIFO_TRIG_FLAG) ? 1U : 0U;
+
+    return SPI_OK;
+}
+
+/*****************************************************************************
+* Function: ADXL345_interruptSourceGet()
+*//**
+*\b Description:
+ * This function is used to get the interrupt sources that are currently
+ * asserted. DATA_READY, WATERMARK and OVERRUN are cleared by reading the 
+ * data registers, the remaining sources are cleared by this read.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ *
+ * POST-CONDITION: The INT_SOURCE register is returned. <br>
+ * 
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * 
+ * @return  The INT_* sources asserted, 0 when the read failed.
+ * 
+ * \b Example:
+ * @code
+ * if(ADXL345_interruptSourceGet(&Adxl345Config) & INT_OVERRUN)
+ * {
+ *     overruns++;
+ * }
+ * @endcode
+ * 
+ * @see ADXL345_init
+ * @see ADXL345_read
+ * @see ADXL345_interruptSourceGet
+ * @see ADXL345_readFifo
+ * 
+*****************************************************************************/
+uint8_t ADXL345_interruptSourceGet(const Adxl345Config_t * const Config)
+{
+    uint16_t source = 0;
+
+    /*Read the interrupt source register, none is reported on a fault*/
+    if(ADXL345_read(Config, INT_SOURCE_R, 1, &source) != SPI_OK)
+    {
+        source = 0;
+    }
+
+    return (uint8_t)source;
+}
+
+/*****************************************************************************
+* Function: ADXL345_fifoEntriesGet()
+*//**
+*\b Description:
+ * This function is used to get the number of samples waiting in the FIFO.
+ * The count includes the sample held in the output data registers.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The Port is within the maximum DioPort_t. <br>
+ * PRE-CONDITION: The Pin is within the maximum DioPin_t. <br>
+ *
+ * POST-CONDITION: The FIFO_STATUS entries field is returned. <br>
+ * 
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * 
+ * @return  The number of samples available (0 to FIFO_MAX_ENTRIES), 0 
+ *          when the read failed.
+ * 
+ * \b Example:
+ * @code
+ * uint8_t entries = ADXL345_fifoEntriesGet(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_init
+ * @see ADXL345_read
+ * @see ADXL345_fifoEntriesGet
+ * @see ADXL345_readFifo
+ * 
+*****************************************************************************/
+uint8_t ADXL345_fifoEntriesGet(const Adxl345Config_t * const Config)
+{
+    uint16_t status = 0;
+
+    /*Read the FIFO status register, nothing is drained on a fault*/
+    if(ADXL345_read(Config, FIFO_STATUS_R, 1, &status) != SPI_OK)
+    {
+        status = 0;
+    }
+
+    return (uint8_t)(status & FIFO_ENTRIES_MASK);
+}
+
+/*****************************************************************************
+* Function: ADXL345_readFifo()
+*//**
+*\b Description:
+ * This function is used to drain the samples pending in the FIFO in one 
+ * call. The entries count is read once and each sample is then popped with
+ * a six bytes read of DATAX0 to DATAZ1, so every sample produced while the
+ * CPU was busy is collected.
+ * Every read is held FIFO_POP_US after the end of the previous data read,
+ * as the datasheet requires for the FIFO to pop.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: The FIFO mode is not ADXL345_FIFO_BYPASS. <br>
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: The data buffer holds maxSamples * AXIS_BYTES elements. <br>
+ *
+ * POST-CONDITION: The samples are stored in the data buffer as X0, X1, Y0,
+ * Y1, Z0, Z1 for each sample. <br>
+ * 
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * @param[out]  data is the buffer where the samples are stored.
+ * @param[in]   maxSamples is the maximum number of samples to drain.
+ * 
+ * @return  The number of samples stored in the data buffer.
+ * 
+ * \b Example:
+ * @code
+ * uint16_t fifoData[FIFO_MAX_ENTRIES * AXIS_BYTES];
+ * uint8_t samples = ADXL345_readFifo(&Adxl345Config, fifoData, 
+ * FIFO_MAX_ENTRIES);
+ * @endcode
+ * 
+ * @see ADXL345_init
+ * @see ADXL345_read
+ * @see ADXL345_fifoEntriesGet
+ * @see ADXL345_readFifo
+ * 
+*****************************************************************************/
+uint8_t ADXL345_readFifo(const Adxl345Config_t * const Config, 
+uint16_t *data, uint8_t maxSamples)
+{
+    /* Prevent to use an empty data buffer*/
+    assert(data != NULL);
+
+    uint8_t entries = ADXL345_fifoEntriesGet(Config);
+
+    /*Limit the drain to the caller buffer*/
+    if(entries > maxSamples)
+    {
+        entries = maxSamples;
+    }
+
+    /*Each read of the data registers pops one sample from the FIFO, the 
+    drain stops at the first failed read*/
+    uint8_t count = 0;
+    while((count < entries) && (ADXL345_read(Config, DATA_START_R, 
+    AXIS_BYTES, &data[count * AXIS_BYTES]) == SPI_OK))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+/*****************************************************************************
+* Function: ADXL345_readSamples()
+*//**
+*\b Description:
+ * This function is used to drain the samples pending in the FIFO into 
+ * packed sample records. The ADXL345 sends each axis least significant 
+ * byte first, which is the Cortex-M4 memory order, so each axis is formed
+ * by merging two frames and no byte reversal is needed. The caller gets 
+ * ready to use x, y and z values in half the memory of the raw frames.
+ * 
+ * PRE-CONDITION: ADXL345_init must be called with valid configuration data.<br>
+ * PRE-CONDITION: The FIFO mode is not ADXL345_FIFO_BYPASS. <br>
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: Samples holds maxSamples elements. <br>
+ *
+ * POST-CONDITION: The samples are stored in the Samples buffer. <br>
+ * 
+ * @param[in]   Config A pointer to a structure containing the channel, port, 
+ *              and pin of the SPI.
+ * @param[out]  Samples is the buffer where the samples are stored.
+ * @param[in]   maxSamples is the maximum number of samples to drain.
+ * 
+ * @return  The number of samples stored in the Samples buffer.
+ * 
+ * \b Example:
+ * @code
+ * Adxl345Sample_t Samples[FIFO_MAX_ENTRIES];
+ * uint8_t count = ADXL345_readSamples(&Adxl345Config, Samples, 
+ * FIFO_MAX_ENTRIES);
+ * @endcode
+ * 
+ * @see ADXL345_read
+ * @see ADXL345_readFifo
+ * @see ADXL345_readSamples
+ * @see ADXL345_fifoEntriesGet
+ * 
+*****************************************************************************/
+uint8_t ADXL345_readSamples(const Adxl345Config_t * const Config, 
+Adxl345Sample_t * const Samples, uint8_t maxSamples)
+{
+    /* Prevent to use an empty sample buffer*/
+    assert(Samples != NULL);
+
+    uint16_t frames[AXIS_BYTES];
+    uint8_t entries = ADXL345_fifoEntriesGet(Config);
+
+    /*Limit the drain to the caller buffer*/
+    if(entries > maxSamples)
+    {
+        entries = maxSamples;
+    }
+
+    for(uint8_t i = 0; i < entries; i++)
+    {
+        PROBE_STAMP(start);
+
+        /*Each read of the data registers pops one sample from the FIFO, the
+        drain stops at the first failed read*/
+        if(ADXL345_read(Config, DATA_START_R, AXIS_BYTES, frames) != SPI_OK)
+        {
+            return i;
+        }
+
+        /*Merge the low and high byte of each axis*/
+        Samples[i].x = (int16_t)(frames[0] | (frames[1] << 8));
+        Samples[i].y = (int16_t)(frames[2] | (frames[3] << 8));
+        Samples[i].z = (int16_t)(frames[4] | (frames[5] << 8));
+
+        PROBE_RECORD(PROBE_SAMPLE_READ, start);
+    }
+
+    return entries;
+}
+
+/*****************************************************************************
+* Function: ADXL345_lostSamplesGet()
+*//**
+*\b Description:
+ * This function is used to get the number of samples lost by a device. A
+ * read of the data registers pops a sample from the FIFO as soon as it 
+ * starts, so a read that fails afterwards is not restarted: the sample is
+ * dropped and counted here.
+ * 
+ * PRE-CONDITION: Adxl345Config_t needs to be populated. <br>
+ * PRE-CONDITION: The Device is below ADXL345_DEVICES_NUMBER. <br>
+ *
+ * POST-CONDITION: The number of samples lost since ADXL345_init is 
+ * returned. <br>
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * 
+ * @return  The number of samples lost by failed reads.
+ * 
+ * \b Example:
+ * @code
+ * uint32_t lost = ADXL345_lostSamplesGet(&Adxl345Config);
+ * @endcode
+ * 
+ * @see ADXL345_read
+ * @see ADXL345_readDma
+ * @see ADXL345_readSamples
+ * 
+*****************************************************************************/
+uint32_t ADXL345_lostSamplesGet(const Adxl345Config_t * const Config)
+{
+    /* Prevent to read out of the range of the devices*/
+    assert(Config->Device < ADXL345_DEVICES_NUMBER);
+
+    return lostSamples[Config->Device];
+}
+
+/*****************************************************************************
+* Function: ADXL345_dataRead()
+*//**
+*\b Description:
+ * This function is used to tell whether a read covers the output data 
+ * registers, DATAX0 to DATAZ1, and so pops a sample from the FIFO.
+ * 
+ * @param[in]   address is the first register read.
+ * @param[in]   size is the number of registers read.
+ * 
+ * @return  1 when the read pops a sample, 0 otherwise.
+ * 
+*****************************************************************************/
+static uint8_t ADXL345_dataRead(uint16_t address, uint16_t size)
+{
+    return (uint8_t)((address < (DATA_START_R + AXIS_BYTES)) && 
+    ((address + size) > DATA_START_R));
+}
+
+/*****************************************************************************
+* Function: ADXL345_popWait()
+*//**
+*\b Description:
+ * This function is used to hold a read of the output data registers or of
+ * FIFO_STATUS until FIFO_POP_US have elapsed since the last data registers
+ * read of the device ended. The FIFO moves the next sample into the data 
+ * registers during that time, so an earlier read returns the old sample 
+ * or entries count. Other registers are read without waiting.
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * @param[in]   address is the first register read.
+ * @param[in]   size is the number of registers read.
+ * 
+ * @return  void
+ * 
+*****************************************************************************/
+static void ADXL345_popWait(const Adxl345Config_t * const Config, 
+uint16_t address, uint16_t size)
+{
+    if(!popPending[Config->Device] || (address > FIFO_STATUS_R) || 
+    ((address + size) <= DATA_START_R))
+    {
+        return;
+    }
+
+    while((DWT->CYCCNT - popStamp[Config->Device]) < popCycles)
+    {
+    }
+    popPending[Config->Device] = 0;
+}
+
+/*****************************************************************************
+* Function: ADXL345_popMark()
+*//**
+*\b Description:
+ * This function is used to record the end of a data registers read, the 
+ * start of the FIFO pop that ADXL345_popWait lets finish.
+ * 
+ * @param[in]   Config A pointer to the device configuration.
+ * 
+ * @return  void
+ * 
+*****************************************************************************/
+static void ADXL345_popMark(const Adxl345Config_t * const Config)
+{
+    popStamp[Config->Device] = DWT->CYCCNT;
+    popPending[Config->Device] = 1U;
+}
+
+/*****************************************************************************
+* Function: ADXL345_dmaComplete()
+*//**
+*\b Description:
+ * This function is called by the SPI driver when a DMA read completes. It 
+ * releases the chip select of the device, copies the data frames to the 
+ * caller buffer when the read succeeded and notifies the application with
+ * the status.
+ * 
+ * @param[in]   Channel is the SPI channel that completed.
+ * @param[in]   Status is the result of the DMA operation.
+ * 
+ * @return  void
+ * 
+*****************************************************************************/
+static void ADXL345_dmaComplete(SpiChannel_t Channel, SpiStatus_t Status)
+{
+    const Adxl345Config_t * const Config = dmaConfig[Channel];
+
+    const DioPinConfig_t CSLine = 
+    {
+        .Port = Config->Port,
+        .Pin = Config->Pin
     };
 
-    /*Pull cs line low to enable slave*/
-    DIO_pinWrite(&CSLine, DIO_LOW);
-    /*Transmit the address*/
-    SPI_transfer(&TransferConfig);
-    /*Read 6 bytes*/
-    SPI_receive(&receiverConfig);
     /*Pull cs line high to disable slave*/
-    DIO_pinWrite(&CSLine, DIO_HIGH);
-}
\ No newline at end of file
+    if(!SPI_hardwareNssGet(Channel))
+    {
+        DIO_pinWrite(&CSLine, DIO_HIGH);
+    }
+
+    /*The FIFO pops once the data registers read ends*/
+    const uint8_t dataRead = 
+    ADXL345_dataRead(dmaAddress[Channel], dmaSize[Channel]);
+    if(dataRead)
+    {
+        ADXL345_popMark(Config);
+    }
+
+    /*Skip the frame clocked in with the address, the frames of a failed 
+    read are not valid and the sample it may have popped is lost*/
+    if(Status == SPI_OK)
+    {
+        for(uint16_t i = 0; i < dmaSize[Channel]; i++)
+        {
+            dmaData[Channel][i] = dmaRxFrames[Channel][i + 1U];
+        }
+    }
+    else if(dataRead)
+    {
+        lostSamples[Config->Device]++;
+    }
+
+    if(dmaCallback[Channel] != NULL)
+    {
+        dmaCallback[Channel](Config, Status);
+    }
+}
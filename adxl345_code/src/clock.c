@@ -0,0 +1,283 @@
+/**
+ * @file clock.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation for the clock configuration. The PLL brings the
+ * STM32F401 from the 16 MHz HSI reset clock to 80 MHz, and the bus clocks
+ * are decoded back from the RCC registers so the drivers always see the
+ * frequency the hardware runs at.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <assert.h>
+#include "clock.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** APB1 is limited to 42 MHz, APB2 runs at HCLK*/
+#define APB1_DIVIDER        (RCC_CFGR_PPRE1_DIV2)
+#define APB2_DIVIDER        (RCC_CFGR_PPRE2_DIV1)
+/** Flash wait states for 64 MHz to 84 MHz at 2.7 V to 3.6 V*/
+#define FLASH_LATENCY       (FLASH_ACR_LATENCY_2WS)
+/** Regulator scale 2, required above 60 MHz and up to 84 MHz*/
+#define REGULATOR_SCALE     (PWR_CR_VOS_1)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/**
+ * The following tables contain the prescaler of each HPRE and PPREx field
+ * value as a right shift of the input clock.
+ */
+static const uint8_t ahbShift[16] =
+{
+    0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U, 1U, 2U, 3U, 4U, 6U, 7U, 8U, 9U
+};
+static const uint8_t apbShift[8] = {0U, 0U, 0U, 0U, 1U, 2U, 3U, 4U};
+
+_Static_assert((CLOCK_HSI_HZ / CLOCK_PLLM) >= 1000000UL &&
+(CLOCK_HSI_HZ / CLOCK_PLLM) <= 2000000UL,
+"The VCO input must be within 1 MHz and 2 MHz");
+_Static_assert((CLOCK_HSI_HZ / CLOCK_PLLM) * CLOCK_PLLN >= 192000000UL &&
+(CLOCK_HSI_HZ / CLOCK_PLLM) * CLOCK_PLLN <= 432000000UL,
+"The VCO output must be within 192 MHz and 432 MHz");
+_Static_assert(CLOCK_SYSCLK_HZ <= 84000000UL,
+"The STM32F401 runs up to 84 MHz");
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: CLOCK_init()
+*//**
+*\b Description:
+ * This function is used to switch the system clock to the main PLL. The
+ * regulator scale is written while the PLL is off, as VOS only takes a 
+ * new value then, and it is applied once the PLL is locked: VOSRDY is 
+ * awaited before the switch. The flash wait states are raised before the
+ * switch, and the bus prescalers keep APB1 within 42 MHz.
+ *
+ * PRE-CONDITION: The system clock is HSI (reset state). <br>
+ *
+ * POST-CONDITION: SYSCLK = HCLK = PCLK2 = CLOCK_SYSCLK_HZ and
+ * PCLK1 = CLOCK_SYSCLK_HZ / 2. <br>
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * CLOCK_init();
+ * uint32_t pclk2 = CLOCK_pclk2Get();     // 80000000
+ * @endcode
+ *
+ * @see CLOCK_init
+ * @see CLOCK_sysclkGet
+ * @see CLOCK_pclk1Get
+ * @see CLOCK_pclk2Get
+ *
+*****************************************************************************/
+void CLOCK_init(void)
+{
+    /*HSI is the PLL source, it is on after reset*/
+    RCC->CR |= RCC_CR_HSION;
+    while(!(RCC->CR & RCC_CR_HSIRDY))
+    {
+        asm("nop");
+    }
+
+    /*Raise the wait states before the clock, enable prefetch and caches*/
+    FLASH->ACR = FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN |
+    FLASH_LATENCY;
+    while((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_LATENCY)
+    {
+        asm("nop");
+    }
+
+    /*HCLK = SYSCLK, PCLK1 = HCLK / 2, PCLK2 = HCLK*/
+    RCC->CFGR = (RCC->CFGR &~ (RCC_CFGR_HPRE | RCC_CFGR_PPRE1 |
+    RCC_CFGR_PPRE2)) | RCC_CFGR_HPRE_DIV1 | APB1_DIVIDER | APB2_DIVIDER;
+
+    /*The PLL and the regulator scale are configured while the PLL is off*/
+    RCC->CR &=~ RCC_CR_PLLON;
+    while(RCC->CR & RCC_CR_PLLRDY)
+    {
+        asm("nop");
+    }
+
+    /*Select the regulator scale that allows 80 MHz*/
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR = (PWR->CR &~ PWR_CR_VOS) | REGULATOR_SCALE;
+
+    RCC->PLLCFGR = (CLOCK_PLLM << RCC_PLLCFGR_PLLM_Pos) |
+    (CLOCK_PLLN << RCC_PLLCFGR_PLLN_Pos) |
+    (((CLOCK_PLLP / 2U) - 1U) << RCC_PLLCFGR_PLLP_Pos) |
+    (CLOCK_PLLQ << RCC_PLLCFGR_PLLQ_Pos) | RCC_PLLCFGR_PLLSRC_HSI;
+
+    RCC->CR |= RCC_CR_PLLON;
+    while(!(RCC->CR & RCC_CR_PLLRDY))
+    {
+        asm("nop");
+    }
+
+    /*The regulator scale is applied once the PLL is on*/
+    while(!(PWR->CSR & PWR_CSR_VOSRDY))
+    {
+        asm("nop");
+    }
+
+    /*Switch the system clock to the PLL*/
+    RCC->CFGR = (RCC->CFGR &~ RCC_CFGR_SW) | RCC_CFGR_SW_PLL;
+    while((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_PLL)
+    {
+        asm("nop");
+    }
+}
+
+/*****************************************************************************
+ * Function: CLOCK_sysclkGet()
+*//**
+*\b Description:
+ * This function is used to get the system clock. The source and the PLL
+ * factors are read from the RCC registers, so the value is right before
+ * and after CLOCK_init.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The system clock is returned. <br>
+ *
+ * @return  The system clock in Hz.
+ *
+ * \b Example:
+ * @code
+ * uint32_t sysclk = CLOCK_sysclkGet();
+ * @endcode
+ *
+ * @see CLOCK_init
+ * @see CLOCK_sysclkGet
+ * @see CLOCK_hclkGet
+ *
+*****************************************************************************/
+uint32_t CLOCK_sysclkGet(void)
+{
+    const uint32_t source = RCC->CFGR & RCC_CFGR_SWS;
+    uint32_t sysclk = CLOCK_HSI_HZ;
+
+    if(source == RCC_CFGR_SWS_HSE)
+    {
+        sysclk = CLOCK_HSE_HZ;
+    }
+    else if(source == RCC_CFGR_SWS_PLL)
+    {
+        const uint32_t pllcfgr = RCC->PLLCFGR;
+        const uint32_t input = (pllcfgr & RCC_PLLCFGR_PLLSRC) ?
+        CLOCK_HSE_HZ : CLOCK_HSI_HZ;
+        const uint32_t m = (pllcfgr & RCC_PLLCFGR_PLLM) >>
+        RCC_PLLCFGR_PLLM_Pos;
+        const uint32_t n = (pllcfgr & RCC_PLLCFGR_PLLN) >>
+        RCC_PLLCFGR_PLLN_Pos;
+        const uint32_t p = ((((pllcfgr & RCC_PLLCFGR_PLLP) >>
+        RCC_PLLCFGR_PLLP_Pos) + 1U) * 2U);
+
+        /* Prevent to divide by a PLLM left out of its range*/
+        assert(m >= 2U);
+
+        sysclk = (input / m) * n / p;
+    }
+
+    return sysclk;
+}
+
+/*****************************************************************************
+ * Function: CLOCK_hclkGet()
+*//**
+*\b Description:
+ * This function is used to get the AHB clock, which is the CPU clock and
+ * the rate of the DWT cycle counter.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The AHB clock is returned. <br>
+ *
+ * @return  The AHB clock in Hz.
+ *
+ * \b Example:
+ * @code
+ * uint32_t cyclesPerUs = CLOCK_hclkGet() / 1000000UL;
+ * @endcode
+ *
+ * @see CLOCK_sysclkGet
+ * @see CLOCK_hclkGet
+ * @see CLOCK_pclk1Get
+ * @see CLOCK_pclk2Get
+ *
+*****************************************************************************/
+uint32_t CLOCK_hclkGet(void)
+{
+    const uint32_t hpre = (RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos;
+
+    return CLOCK_sysclkGet() >> ahbShift[hpre];
+}
+
+/*****************************************************************************
+ * Function: CLOCK_pclk1Get()
+*//**
+*\b Description:
+ * This function is used to get the APB1 clock, which feeds SPI2 and SPI3.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The APB1 clock is returned. <br>
+ *
+ * @return  The APB1 clock in Hz.
+ *
+ * \b Example:
+ * @code
+ * uint32_t pclk1 = CLOCK_pclk1Get();
+ * @endcode
+ *
+ * @see CLOCK_hclkGet
+ * @see CLOCK_pclk1Get
+ * @see CLOCK_pclk2Get
+ *
+*****************************************************************************/
+uint32_t CLOCK_pclk1Get(void)
+{
+    const uint32_t ppre1 = (RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos;
+
+    return CLOCK_hclkGet() >> apbShift[ppre1];
+}
+
+/*****************************************************************************
+ * Function: CLOCK_pclk2Get()
+*//**
+*\b Description:
+ * This function is used to get the APB2 clock, which feeds SPI1 and SPI4.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The APB2 clock is returned. <br>
+ *
+ * @return  The APB2 clock in Hz.
+ *
+ * \b Example:
+ * @code
+ * uint32_t pclk2 = CLOCK_pclk2Get();
+ * @endcode
+ *
+ * @see CLOCK_hclkGet
+ * @see CLOCK_pclk1Get
+ * @see CLOCK_pclk2Get
+ *
+*****************************************************************************/
+uint32_t CLOCK_pclk2Get(void)
+{
+    const uint32_t ppre2 = (RCC->CFGR & RCC_CFGR_PPRE2) >> RCC_CFGR_PPRE2_Pos;
+
+    return CLOCK_hclkGet() >> apbShift[ppre2];
+}
@@ -11,11 +11,15 @@
 /*****************************************************************************
 * Module Includes
 *****************************************************************************/
-#include "dio.h"        /*For this modules definitions*/                                        
+#include "dio.h"        /*For this modules definitions*/
+#include "probe.h"      /*For the timing probes*/                                        
 
 /*****************************************************************************
 * Module Preprocessor Constants
 *****************************************************************************/
+/** EXTI lines sharing the EXTI9_5 and EXTI15_10 interrupts*/
+#define EXTI9_5_LINES       (0x03E0UL)
+#define EXTI15_10_LINES     (0xFC00UL)
 
 /*****************************************************************************
 * Module Preprocessor Macros
@@ -74,6 +78,16 @@ static uint32_t volatile * const odrRegister[NUMBER_OF_PORTS] =
     (uint32_t*)&GPIOD->ODR, (uint32_t*)&GPIOH->ODR
 };
 
+/* Defines a array of pointers to the GPIO port bit set/reset register. The
+ * low half sets pins and the high half resets pins in one store.
+*/
+static uint32_t volatile * const bsrrRegister[NUMBER_OF_PORTS] =
+{
+    (uint32_t*)&GPIOA->BSRR, (uint32_t*)&GPIOB->BSRR, 
+    (uint32_t*)&GPIOC->BSRR, (uint32_t*)&GPIOD->BSRR, 
+    (uint32_t*)&GPIOH->BSRR
+};
+
 /* Defines a array of pointers to the GPIO alternate function low register.
  * This is compound for two 32 bits registers.
 */
@@ -84,9 +98,47 @@ static uint32_t volatile * const afrRegister[NUMBER_OF_PORTS] =
     (uint32_t*)&GPIOH->AFR[0]
 };
 
+/* Defines a array of pointers to the GPIO alternate function high register.
+ * It holds the function of pins 8 to 15.
+*/
+static uint32_t volatile * const afrHighRegister[NUMBER_OF_PORTS] =
+{
+    (uint32_t*)&GPIOA->AFR[1], (uint32_t*)&GPIOB->AFR[1], 
+    (uint32_t*)&GPIOC->AFR[1], (uint32_t*)&GPIOD->AFR[1], 
+    (uint32_t*)&GPIOH->AFR[1]
+};
+
+/* Defines the SYSCFG_EXTICR code of each port. */
+static const uint8_t extiPortCode[NUMBER_OF_PORTS] = {0U, 1U, 2U, 3U, 7U};
+
+/* Defines the interrupt that serves each EXTI line. */
+static const IRQn_Type extiIrq[DIO_EXTI_LINES] =
+{
+    EXTI0_IRQn, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn,
+    EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn, EXTI9_5_IRQn,
+    EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, EXTI15_10_IRQn, 
+    EXTI15_10_IRQn, EXTI15_10_IRQn
+};
+
+/* Defines the lines that share the interrupt of each EXTI line. */
+static const uint16_t extiGroup[DIO_EXTI_LINES] =
+{
+    0x0001U, 0x0002U, 0x0004U, 0x0008U, 0x0010U,
+    EXTI9_5_LINES, EXTI9_5_LINES, EXTI9_5_LINES, EXTI9_5_LINES, 
+    EXTI9_5_LINES, EXTI15_10_LINES, EXTI15_10_LINES, EXTI15_10_LINES, 
+    EXTI15_10_LINES, EXTI15_10_LINES, EXTI15_10_LINES
+};
+
+/* Function called on the edges of each EXTI line. */
+static DioExtiCallback_t extiCallback[DIO_EXTI_LINES];
+
+/* Cycle count of the last edge of each EXTI line. */
+static volatile uint32_t extiStamp[DIO_EXTI_LINES];
+
 /*****************************************************************************
 * Function Prototypes
 *****************************************************************************/
+static void DIO_extiDispatch(uint32_t lines);
 
 /*****************************************************************************
 * Function Definitions
@@ -96,7 +148,10 @@ static uint32_t volatile * const afrRegister[NUMBER_OF_PORTS] =
 *//**
 *\b Description:
  * This function is used to initialize the DIO based on the configuration  
- * table defined in dio_cfg module.
+ * table defined in dio_cfg module. The rows are grouped by port into 
+ * MODER, OTYPER, OSPEEDR, PUPDR, AFRL and AFRH images, then each register
+ * of a port is committed once. Pins 8 to 15 are muxed through AFRH, so 
+ * high pins such as PB13 to PB15 of SPI2 can be used.
  * 
  * PRE-CONDITION: The MCU clocks must be configured and enabled. <br>
  * PRE-CONDITION: Configuration table needs to be populated (sizeof > 0) <br>
@@ -132,7 +187,11 @@ static uint32_t volatile * const afrRegister[NUMBER_OF_PORTS] =
 *****************************************************************************/
 void DIO_init(const DioConfig_t * const Config, size_t configSize)
 {
-    /* Loop through all the elements of the configuration table. */
+    DioPortImage_t Images[NUMBER_OF_PORTS] = {0};
+
+    /* Loop through all the elements of the configuration table and group 
+     * their fields by port. Nothing is written to the ports yet.
+    */
     for(uint8_t i=0; i<configSize; i++)
     {
         /* Prevent to assign a value out of the range of the port and pin.
@@ -141,233 +200,101 @@ void DIO_init(const DioConfig_t * const Config, size_t configSize)
         */
         assert(Config[i].Port < DIO_MAX_PORT);
         assert(Config[i].Pin < DIO_MAX_PIN);
+        assert(Config[i].Mode < DIO_MAX_MODE);
+        assert(Config[i].Type < DIO_MAX_TYPE);
+        assert(Config[i].Speed < DIO_MAX_SPEED);
+        assert(Config[i].Resistor < DIO_MAX_RESISTOR);
+        assert(Config[i].Function < DIO_MAX_FUNCTION);
 
-        /* 
-         * Set the mode of the Dio pin on the GPIO port mode register. 
-         * Multiply the pin number (Config[i].Pin) by two as MODER uses two 
-         * bits to configure one pin.
+        DioPortImage_t * const Image = &Images[Config[i].Port];
+        const uint32_t pin = Config[i].Pin;
+        /* MODER, OSPEEDR and PUPDR use two bits per pin, AFRL holds pins 
+         * 0 to 7 and AFRH pins 8 to 15 with four bits per pin
         */
-        if(Config[i].Mode == DIO_INPUT)
-        {
-            *moderRegister[Config[i].Port] &=~ (1UL<<(Config[i].Pin*2));
-            *moderRegister[Config[i].Port] &=~ (2UL<<(Config[i].Pin*2));
+        const uint32_t shift2 = pin * 2U;
+        const uint32_t half = pin / 8U;
+        const uint32_t shift4 = (pin % 8U) * 4U;
 
-        }
-        else if (Config[i].Mode == DIO_OUTPUT)
-        {
-            *moderRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*2));
-            *moderRegister[Config[i].Port] &=~ (2UL<<(Config[i].Pin*2));
-        }
-        else if (Config[i].Mode == DIO_FUNCTION)
-        {
-            *moderRegister[Config[i].Port] &=~ (1UL<<(Config[i].Pin*2));
-            *moderRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*2));
-        }
-        else if (Config[i].Mode == DIO_ANALOG)
-        {
-            *moderRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*2));
-            *moderRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*2));
-        }
-        else
-        {
-            assert(Config[i].Mode < DIO_MAX_MODE);
-        }
+        /* Prevent to list a pin twice, the last row would silently win*/
+        assert((Image->Mask1 & (1UL << pin)) == 0UL);
 
-        /*
-         * Set the output type of the Dio pin on the GPIO port output type 
-         * register.
-         */
-        if(Config[i].Type == DIO_PUSH_PULL)
-        {
-            *otyperRegister[Config[i].Port] &= ~(1UL<<Config[i].Pin);
-        }
-        else if (Config[i].Type == DIO_OPEN_DRAIN)
-        {
-            *otyperRegister[Config[i].Port] |= (1UL<<Config[i].Pin);
-        }
-        else
-        {
-            assert(Config[i].Type < DIO_MAX_TYPE);
-        }
+        Image->Mask1 |= (1UL << pin);
+        Image->Mask2 |= (3UL << shift2);
+        Image->AfrMask[half] |= (0xFUL << shift4);
+        Image->Moder |= ((uint32_t)Config[i].Mode << shift2);
+        Image->Otyper |= ((uint32_t)Config[i].Type << pin);
+        Image->Ospeedr |= ((uint32_t)Config[i].Speed << shift2);
+        Image->Pupdr |= ((uint32_t)Config[i].Resistor << shift2);
+        Image->Afr[half] |= ((uint32_t)Config[i].Function << shift4);
+    }
 
-        /*
-         * Set the speed of the Dio pin on the GPIO port output speed 
-         * register. Multiply the pin number (Config[i].Pin) by two as 
-         * OSPEEDR uses two bits to configure one pin. 
-         */
-        if(Config[i].Speed == DIO_LOW_SPEED)
-        {
-            *ospeedrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*2));
-            *ospeedrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*2));
-        }
-        else if (Config[i].Speed == DIO_MEDIUM_SPEED)
-        {
-            *ospeedrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*2));
-            *ospeedrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*2));
-        }
-        else if (Config[i].Speed == DIO_HIGH_SPEED)
-        {
-            *ospeedrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*2));
-            *ospeedrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*2));
-        }
-        else if(Config[i].Speed == DIO_VERY_SPEED)
-        {
-            *ospeedrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*2));
-            *ospeedrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*2));
-        }
-        else
+    /* Commit each register of each port once*/
+    DIO_imageApply(Images, NUMBER_OF_PORTS);
+}
+
+/*****************************************************************************
+ * Function: DIO_imageApply()
+*//**
+*\b Description:
+ * This function is used to initialize the DIO from the port images reduced
+ * from the configuration table at compile time. Each register of a port is
+ * committed with one store of its masked image, and the mux, type, speed 
+ * and resistor are set before MODER so a pin switches straight into its 
+ * final function. Ports without pins in the table are not touched.
+ * 
+ * PRE-CONDITION: The MCU clocks of the ports in use must be enabled. <br>
+ * PRE-CONDITION: imageSize is not greater than NUMBER_OF_PORTS. <br>
+ * 
+ * POST-CONDITION: The pins of the table are set up, the other pins keep 
+ * their setting. <br>
+ * 
+ * @param[in]   Images is a pointer to the port images, ordered by 
+ *              DioPort_t.
+ * @param[in]   imageSize is the number of port images.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * const DioPortImage_t * const DioImage = DIO_imageGet();
+ * size_t imageSize = DIO_imageSizeGet();
+ * 
+ * DIO_imageApply(DioImage, imageSize);
+ * @endcode
+ * 
+ * @see DIO_imageGet
+ * @see DIO_imageSizeGet
+ * @see DIO_init
+ * @see DIO_imageApply
+ * 
+*****************************************************************************/
+void DIO_imageApply(const DioPortImage_t * const Images, size_t imageSize)
+{
+    /* Prevent to write past the register arrays*/
+    assert(imageSize <= NUMBER_OF_PORTS);
+
+    for(uint8_t port = 0; port < imageSize; port++)
+    {
+        const DioPortImage_t * const Image = &Images[port];
+
+        /*No pin of the port is listed in the table*/
+        if(Image->Mask1 == 0UL)
         {
-            assert(Config[i].Speed < DIO_MAX_SPEED);
+            continue;
         }
 
-        /*
-         * Set the internal resistor of the Dio pin on the GPIO port 
-         * pull-up/pull-down register. Multiply the pin number 
-         * (Config[i].Pin) by two as PUPDR uses two bits to configure 
-         * one pin. 
-        */
-       if(Config[i].Resistor == DIO_NO_RESISTOR)
-       {
-            *pupdrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*2));
-            *pupdrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*2));
-       }
-       else if (Config[i].Resistor == DIO_PULLUP)
-       {
-            *pupdrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*2));
-            *pupdrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*2));
-       }
-       else if (Config[i].Resistor == DIO_PULLDOWN)
-       {
-            *pupdrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*2));
-            *pupdrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*2));
-       }
-       else
-       {
-            assert(Config[i].Resistor < DIO_MAX_RESISTOR);
-       }
-
-        /*
-         * Set the alternate function of the Dio pin on the GPIO alternate 
-         * function. Multiply the pin number (Config[i].Pin) by four as AFR 
-         * uses four bits to configure one pin. 
-        */
-       if(Config[i].Function == DIO_AF0)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF1)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF2)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF3)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF4)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF5)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF6)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF7)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF8)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF9)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF10)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF11)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF12)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF13)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] &= ~(2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF14)
-       {
-            *afrRegister[Config[i].Port] &= ~(1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else if(Config[i].Function == DIO_AF15)
-       {
-            *afrRegister[Config[i].Port] |= (1UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (2UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (4UL<<(Config[i].Pin*4));
-            *afrRegister[Config[i].Port] |= (8UL<<(Config[i].Pin*4));
-       }
-       else
-       {
-            assert(Config[i].Function < DIO_MAX_FUNCTION);
-       }
-
+        *afrRegister[port] = (*afrRegister[port] &~ Image->AfrMask[0]) | 
+        Image->Afr[0];
+        *afrHighRegister[port] = (*afrHighRegister[port] &~ 
+        Image->AfrMask[1]) | Image->Afr[1];
+        *otyperRegister[port] = (*otyperRegister[port] &~ Image->Mask1) | 
+        Image->Otyper;
+        *ospeedrRegister[port] = (*ospeedrRegister[port] &~ Image->Mask2) | 
+        Image->Ospeedr;
+        *pupdrRegister[port] = (*pupdrRegister[port] &~ Image->Mask2) | 
+        Image->Pupdr;
+        *moderRegister[port] = (*moderRegister[port] &~ Image->Mask2) | 
+        Image->Moder;
     }
 }
 
@@ -491,13 +418,16 @@ void DIO_pinWrite(const DioPinConfig_t * const PinConfig, DioPinState_t State)
     assert(PinConfig->Port < DIO_MAX_PORT);
     assert(PinConfig->Pin < DIO_MAX_PIN);
 
+    /* BSRR changes the pin with a single store, so an interrupt that 
+     * writes other pins of the port cannot be undone by this write
+    */
     if(State == DIO_HIGH)
     {
-        *odrRegister[PinConfig->Port] |= (1UL<<(PinConfig->Pin));
+        *bsrrRegister[PinConfig->Port] = (1UL<<(PinConfig->Pin));
     }
     else if (State == DIO_LOW)
     {
-        *odrRegister[PinConfig->Port] &= ~(1UL<<(PinConfig->Pin));
+        *bsrrRegister[PinConfig->Port] = (1UL<<(PinConfig->Pin + 16U));
     }
     else
     {
@@ -512,7 +442,8 @@ void DIO_pinWrite(const DioPinConfig_t * const PinConfig, DioPinState_t State)
  * This function is used to toggle the current state of a pin. 
  * This function reads the state of a digital input/output pin 
  * specified by the DioPinConfig_t structure, which contains the port 
- * and pin information.
+ * and pin information. The new state is written through BSRR, so the
+ * other pins of the port are not affected by the read.
  * 
  * PRE-CONDITION: The channel is configured as output <br>
  * PRE-CONDITION: The channel is configured as GPIO <br>
@@ -556,7 +487,227 @@ void DIO_pinToggle(const DioPinConfig_t * const PinConfig)
     assert(PinConfig->Port < DIO_MAX_PORT);
     assert(PinConfig->Pin < DIO_MAX_PIN);
 
-    *odrRegister[PinConfig->Port] ^= (1UL<<(PinConfig->Pin));
+    /* Reset the pin if it is high, set it if it is low. Only this pin is
+     * written, the other pins of the port are not stored back
+    */
+    const uint32_t mask = (1UL<<(PinConfig->Pin));
+    const uint32_t odr = *odrRegister[PinConfig->Port];
+
+    *bsrrRegister[PinConfig->Port] = ((odr & mask) << 16U) | (~odr & mask);
+}
+
+/**********************************************************************
+ * Function: DIO_portWrite()
+*//**
+ *\b Description:
+ * This function is used to write several pins of a port at once. The 
+ * pins selected by mask take the state of the matching bit of value, 
+ * with a single store to BSRR. The pins out of mask are not changed, 
+ * also when an interrupt writes them at the same time.
+ * 
+ * PRE-CONDITION: The pins are configured as output <br>
+ * PRE-CONDITION: The Port is within the maximum DioPort_t. <br>
+ *
+ * POST-CONDITION: The pins in mask take the state in value. <br>
+ * 
+ * @param[in]   Port is the port of the pins.
+ * @param[in]   mask selects the pins to write, bit n is pin n.
+ * @param[in]   value is the state of the pins, bit n is pin n.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * // PB12 low and PB13 high in the same bus cycle
+ * DIO_portWrite(DIO_PB, (1U << DIO_PB12) | (1U << DIO_PB13), 
+ * (1U << DIO_PB13));
+ * @endcode
+ * 
+ * @see DIO_pinWrite
+ * @see DIO_pinToggle
+ * @see DIO_portWrite
+ * 
+ **********************************************************************/
+void DIO_portWrite(DioPort_t Port, uint16_t mask, uint16_t value)
+{
+    /* Prevent to assign a value out of the range of the port.*/
+    assert(Port < DIO_MAX_PORT);
+
+    *bsrrRegister[Port] = ((uint32_t)(mask & ~value) << 16U) | 
+    (uint32_t)(mask & value);
+}
+
+/**********************************************************************
+ * Function: DIO_interruptEnable()
+*//**
+ *\b Description:
+ * This function is used to raise an interrupt on the edges of a pin. The 
+ * pin is routed to the EXTI line of its number, the edges are selected and
+ * the line is unmasked. On each edge the DWT cycle count is captured on 
+ * entry to the interrupt and passed to the callback, so the event time 
+ * does not depend on the dispatch delay.
+ * 
+ * PRE-CONDITION: The SYSCFG clock must be enabled. <br>
+ * PRE-CONDITION: The pin is configured as input. <br>
+ * PRE-CONDITION: The Port is within the maximum DioPort_t. <br>
+ * PRE-CONDITION: The Pin is within the maximum DioPin_t. <br>
+ * PRE-CONDITION: No other port uses the EXTI line of the pin. <br>
+ *
+ * POST-CONDITION: The callback is called from the interrupt on each 
+ * selected edge. <br>
+ * 
+ * @param[in]   PinConfig A pointer to a structure containing the port 
+ *              and pin.
+ * @param[in]   Edge selects the rising, falling or both edges.
+ * @param[in]   Callback is the function called on each edge, or NULL to
+ *              only capture the timestamp.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * const DioPinConfig_t Int1Line = 
+ * {
+ *      .Port = DIO_PA, 
+ *      .Pin = DIO_PA0
+ * };
+ * DIO_interruptEnable(&Int1Line, DIO_EDGE_RISING, int1Event);
+ * @endcode
+ * 
+ * @see DIO_interruptEnable
+ * @see DIO_interruptDisable
+ * @see DIO_interruptStampGet
+ * 
+ **********************************************************************/
+void DIO_interruptEnable(const DioPinConfig_t * const PinConfig, 
+DioEdge_t Edge, DioExtiCallback_t Callback)
+{
+    /* Prevent to assign a value out of the range of the port and pin.*/
+    assert(PinConfig->Port < DIO_MAX_PORT);
+    assert(PinConfig->Pin < DIO_MAX_PIN);
+    assert(Edge < DIO_MAX_EDGE);
+
+    const uint8_t line = (uint8_t)PinConfig->Pin;
+    const uint32_t lineMask = (1UL << line);
+    const uint8_t shift = (uint8_t)((line % 4U) * 4U);
+
+    /* Start the cycle counter that timestamps the edges*/
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* Mask the line while it is routed*/
+    EXTI->IMR &= ~lineMask;
+    extiCallback[line] = Callback;
+
+    /* Route the port to the line, four lines per EXTICR register*/
+    SYSCFG->EXTICR[line / 4U] = (SYSCFG->EXTICR[line / 4U] & 
+    ~(0xFUL << shift)) | ((uint32_t)extiPortCode[PinConfig->Port] << shift);
+
+    /* Select the edges*/
+    if(Edge == DIO_EDGE_FALLING)
+    {
+        EXTI->RTSR &= ~lineMask;
+    }
+    else
+    {
+        EXTI->RTSR |= lineMask;
+    }
+
+    if(Edge == DIO_EDGE_RISING)
+    {
+        EXTI->FTSR &= ~lineMask;
+    }
+    else
+    {
+        EXTI->FTSR |= lineMask;
+    }
+
+    /* Drop an edge latched before, then unmask the line*/
+    EXTI->PR = lineMask;
+    EXTI->IMR |= lineMask;
+    NVIC_EnableIRQ(extiIrq[line]);
+}
+
+/**********************************************************************
+ * Function: DIO_interruptDisable()
+*//**
+ *\b Description:
+ * This function is used to stop the interrupt of a pin. The shared 
+ * EXTI9_5 and EXTI15_10 interrupts stay enabled while another of their 
+ * lines is in use.
+ * 
+ * PRE-CONDITION: The Port is within the maximum DioPort_t. <br>
+ * PRE-CONDITION: The Pin is within the maximum DioPin_t. <br>
+ *
+ * POST-CONDITION: The EXTI line of the pin is masked. <br>
+ * 
+ * @param[in]   PinConfig A pointer to a structure containing the port 
+ *              and pin.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * DIO_interruptDisable(&Int1Line);
+ * @endcode
+ * 
+ * @see DIO_interruptEnable
+ * @see DIO_interruptDisable
+ * @see DIO_interruptStampGet
+ * 
+ **********************************************************************/
+void DIO_interruptDisable(const DioPinConfig_t * const PinConfig)
+{
+    /* Prevent to assign a value out of the range of the port and pin.*/
+    assert(PinConfig->Port < DIO_MAX_PORT);
+    assert(PinConfig->Pin < DIO_MAX_PIN);
+
+    const uint8_t line = (uint8_t)PinConfig->Pin;
+    const uint32_t lineMask = (1UL << line);
+
+    EXTI->IMR &= ~lineMask;
+    EXTI->RTSR &= ~lineMask;
+    EXTI->FTSR &= ~lineMask;
+    EXTI->PR = lineMask;
+    extiCallback[line] = NULL;
+
+    if((EXTI->IMR & extiGroup[line]) == 0UL)
+    {
+        NVIC_DisableIRQ(extiIrq[line]);
+    }
+}
+
+/**********************************************************************
+ * Function: DIO_interruptStampGet()
+*//**
+ *\b Description:
+ * This function is used to get the DWT cycle count of the last edge of an
+ * EXTI line, captured on entry to the interrupt.
+ * 
+ * PRE-CONDITION: The Line is within the maximum DioPin_t. <br>
+ *
+ * POST-CONDITION: The timestamp is returned. <br>
+ * 
+ * @param[in]   Line is the EXTI line, which is the pin number.
+ * 
+ * @return  The cycle count of the last edge.
+ * 
+ * \b Example:
+ * @code
+ * uint32_t latency = DWT->CYCCNT - DIO_interruptStampGet(DIO_PA0);
+ * @endcode
+ * 
+ * @see DIO_interruptEnable
+ * @see DIO_interruptDisable
+ * @see DIO_interruptStampGet
+ * 
+ **********************************************************************/
+uint32_t DIO_interruptStampGet(DioPin_t Line)
+{
+    /* Prevent to read out of the range of the lines*/
+    assert(Line < DIO_EXTI_LINES);
+
+    return extiStamp[Line];
 }
 
 /**********************************************************************
@@ -597,7 +748,7 @@ void DIO_pinToggle(const DioPinConfig_t * const PinConfig)
 **********************************************************************/ 
 void DIO_registerWrite(uint32_t address, uint32_t value)
 {
-    volatile uint32_t * const registerPointer = (uint32_t*)address;
+    volatile uint32_t * const registerPointer = (uint32_t*)(uintptr_t)address;
     *registerPointer = value;
 }
 
@@ -637,7 +788,81 @@ void DIO_registerWrite(uint32_t address, uint32_t value)
  **********************************************************************/ 
 uint32_t DIO_registerRead(uint32_t address)
 {
-    volatile uint32_t * const registerPointer = (uint32_t*)address;
+    volatile uint32_t * const registerPointer = (uint32_t*)(uintptr_t)address;
 
     return *registerPointer;
-}
\ No newline at end of file
+}
+
+/*****************************************************************************
+ * Function: DIO_extiDispatch()
+*//**
+*\b Description:
+ * This function is used to serve the pending EXTI lines of an interrupt.
+ * The timestamp is taken first, the pending bits are cleared and the 
+ * callback of each line is called.
+ * 
+ * @param[in]   lines are the EXTI lines served by the interrupt.
+ * 
+ * @return  void
+ * 
+*****************************************************************************/
+static void DIO_extiDispatch(uint32_t lines)
+{
+    const uint32_t stamp = DWT->CYCCNT;
+    const uint32_t pending = EXTI->PR & EXTI->IMR & lines;
+
+    /* Clear the pending bits by writing one*/
+    EXTI->PR = pending;
+
+    for(uint8_t line = 0; line < DIO_EXTI_LINES; line++)
+    {
+        if(pending & (1UL << line))
+        {
+            extiStamp[line] = stamp;
+            if(extiCallback[line] != NULL)
+            {
+                extiCallback[line]((DioPin_t)line, stamp);
+            }
+        }
+    }
+
+    PROBE_RECORD(PROBE_EXTI_ISR, stamp);
+}
+
+/*****************************************************************************
+* Interrupt Handlers
+*****************************************************************************/
+void EXTI0_IRQHandler(void)
+{
+    DIO_extiDispatch(1UL << 0);
+}
+
+void EXTI1_IRQHandler(void)
+{
+    DIO_extiDispatch(1UL << 1);
+}
+
+void EXTI2_IRQHandler(void)
+{
+    DIO_extiDispatch(1UL << 2);
+}
+
+void EXTI3_IRQHandler(void)
+{
+    DIO_extiDispatch(1UL << 3);
+}
+
+void EXTI4_IRQHandler(void)
+{
+    DIO_extiDispatch(1UL << 4);
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    DIO_extiDispatch(EXTI9_5_LINES);
+}
+
+void EXTI15_10_IRQHandler(void)
+{
+    DIO_extiDispatch(EXTI15_10_LINES);
+}
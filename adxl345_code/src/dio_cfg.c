@@ -22,6 +22,97 @@
 /*****************************************************************************
 * Module Preprocessor Macros
 *****************************************************************************/
+/**
+ * The following list contains the configuration data for each digital
+ * input/output peripheral channel (pin). Each row represent a single pin.
+ * Each column is representing a member of the DioConfig_t structure. The 
+ * list is expanded into the DioConfig table, into the register values of 
+ * each port and into build time checks. The P argument is the port being 
+ * reduced and is passed through to ROW.
+*/
+#define DIO_CONFIG_TABLE(ROW, P)                                            \
+/*                                                                          \
+ *      Port    Pin      Mode          Type           Speed                 \
+ *      Resistor         Function                                           \
+*/                                                                          \
+ROW(P, DIO_PA, DIO_PA0, DIO_INPUT,    DIO_PUSH_PULL, DIO_LOW_SPEED,         \
+       DIO_NO_RESISTOR, DIO_AF0)                                            \
+ROW(P, DIO_PA, DIO_PA4, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED,         \
+       DIO_PULLUP,      DIO_AF5)                                            \
+ROW(P, DIO_PA, DIO_PA5, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED,         \
+       DIO_PULLUP,      DIO_AF5)                                            \
+ROW(P, DIO_PA, DIO_PA6, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED,         \
+       DIO_NO_RESISTOR, DIO_AF5)                                            \
+ROW(P, DIO_PA, DIO_PA7, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED,         \
+       DIO_NO_RESISTOR, DIO_AF5)
+
+/** Expands a row into a DioConfig_t*/
+#define DIO_CONFIG_ROW(P, Port, Pin, Mode, Type, Speed, Resistor, Function) \
+{Port, Pin, Mode, Type, Speed, Resistor, Function},
+
+/** Expands a row into its build time check. The mux is only selected by 
+ * the alternate function mode*/
+#define DIO_CONFIG_CHECK(P, Port, Pin, Mode, Type, Speed, Resistor,         \
+Function)                                                                   \
+_Static_assert(((Port) < DIO_MAX_PORT) && ((Pin) < DIO_MAX_PIN) &&          \
+((Mode) < DIO_MAX_MODE) && ((Type) < DIO_MAX_TYPE) &&                       \
+((Speed) < DIO_MAX_SPEED) && ((Resistor) < DIO_MAX_RESISTOR) &&             \
+((Function) < DIO_MAX_FUNCTION) &&                                          \
+(((Mode) == DIO_FUNCTION) || ((Function) == DIO_AF0)),                      \
+"DioConfig row " #Port " " #Pin " has an invalid setting");
+
+/** Places a field of a row of port P, or nothing for the other ports*/
+#define DIO_FIELD(P, Port, value, shift)                                    \
+(((Port) == (P)) ? ((uint32_t)(value) << (shift)) : 0UL)
+#define DIO_AFR_FIELD(P, Port, Pin, value, half)                            \
+((((Pin) / 8U) == (half)) ?                                                 \
+DIO_FIELD(P, Port, value, ((Pin) % 8U) * 4U) : 0UL)
+
+/** Expand a row into its fields of port P*/
+#define DIO_MASK2(P, Port, Pin, Mode, Type, Speed, Resistor, Function)      \
+| DIO_FIELD(P, Port, 3U, (Pin) * 2U)
+#define DIO_MASK1(P, Port, Pin, Mode, Type, Speed, Resistor, Function)      \
+| DIO_FIELD(P, Port, 1U, (Pin))
+#define DIO_AFRL_MASK(P, Port, Pin, Mode, Type, Speed, Resistor, Function)  \
+| DIO_AFR_FIELD(P, Port, Pin, 0xFU, 0U)
+#define DIO_AFRH_MASK(P, Port, Pin, Mode, Type, Speed, Resistor, Function)  \
+| DIO_AFR_FIELD(P, Port, Pin, 0xFU, 1U)
+#define DIO_MODER(P, Port, Pin, Mode, Type, Speed, Resistor, Function)      \
+| DIO_FIELD(P, Port, Mode, (Pin) * 2U)
+#define DIO_OTYPER(P, Port, Pin, Mode, Type, Speed, Resistor, Function)     \
+| DIO_FIELD(P, Port, Type, (Pin))
+#define DIO_OSPEEDR(P, Port, Pin, Mode, Type, Speed, Resistor, Function)    \
+| DIO_FIELD(P, Port, Speed, (Pin) * 2U)
+#define DIO_PUPDR(P, Port, Pin, Mode, Type, Speed, Resistor, Function)      \
+| DIO_FIELD(P, Port, Resistor, (Pin) * 2U)
+#define DIO_AFRL(P, Port, Pin, Mode, Type, Speed, Resistor, Function)       \
+| DIO_AFR_FIELD(P, Port, Pin, Function, 0U)
+#define DIO_AFRH(P, Port, Pin, Mode, Type, Speed, Resistor, Function)       \
+| DIO_AFR_FIELD(P, Port, Pin, Function, 1U)
+
+/** Expands a row into its pin bit of port P, to find a pin listed twice*/
+#define DIO_PIN_SUM(P, Port, Pin, Mode, Type, Speed, Resistor, Function)    \
++ DIO_FIELD(P, Port, 1U, (Pin))
+
+/** Reduces the table to the register values of port P*/
+#define DIO_PORT_IMAGE(P)                                                   \
+{                                                                           \
+    .Mask2 = 0UL DIO_CONFIG_TABLE(DIO_MASK2, P),                            \
+    .Mask1 = 0UL DIO_CONFIG_TABLE(DIO_MASK1, P),                            \
+    .AfrMask = {0UL DIO_CONFIG_TABLE(DIO_AFRL_MASK, P),                     \
+                0UL DIO_CONFIG_TABLE(DIO_AFRH_MASK, P)},                    \
+    .Moder = 0UL DIO_CONFIG_TABLE(DIO_MODER, P),                            \
+    .Otyper = 0UL DIO_CONFIG_TABLE(DIO_OTYPER, P),                          \
+    .Ospeedr = 0UL DIO_CONFIG_TABLE(DIO_OSPEEDR, P),                        \
+    .Pupdr = 0UL DIO_CONFIG_TABLE(DIO_PUPDR, P),                            \
+    .Afr = {0UL DIO_CONFIG_TABLE(DIO_AFRL, P),                              \
+            0UL DIO_CONFIG_TABLE(DIO_AFRH, P)}                              \
+}
+
+/** Checks that no pin of port P is listed twice*/
+#define DIO_PORT_CHECK(P)                                                   \
+_Static_assert((0UL DIO_CONFIG_TABLE(DIO_PIN_SUM, P)) ==                    \
+(0UL DIO_CONFIG_TABLE(DIO_MASK1, P)), "DioConfig lists a pin of " #P " twice");
 
 /*****************************************************************************
 * Module Typedefs
@@ -32,23 +123,39 @@
 *****************************************************************************/
 /**
  * The following array contains the configuration data for each digital
- * input/output peripheral channel (pin). Each row represent a single pin.
- * Each column is representing a member of the DioConfig_t structure. This 
- * table is read in by Dio_Init, where each channel is then set up based on 
- * this table. 
+ * input/output peripheral channel (pin), generated from DIO_CONFIG_TABLE. 
+ * This table is read in by Dio_Init, where each channel is then set up 
+ * based on this table. 
 */
 const DioConfig_t DioConfig[] = 
 {
-/*                                                          
- *  Port    Pin      Mode        Type           Speed          Resistor         Function
- *                
-*/ 
-   {DIO_PA, DIO_PA4, DIO_OUTPUT,   DIO_PUSH_PULL, DIO_LOW_SPEED, DIO_NO_RESISTOR, DIO_AF5},
-   {DIO_PA, DIO_PA5, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED, DIO_NO_RESISTOR, DIO_AF5},
-   {DIO_PA, DIO_PA6, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED, DIO_NO_RESISTOR, DIO_AF5},
-   {DIO_PA, DIO_PA7, DIO_FUNCTION, DIO_PUSH_PULL, DIO_LOW_SPEED, DIO_NO_RESISTOR, DIO_AF5},
+    DIO_CONFIG_TABLE(DIO_CONFIG_ROW, 0)
 };
 
+/**
+ * The following array contains the register values of each port reduced 
+ * from DIO_CONFIG_TABLE at compile time. This table is read in by 
+ * DIO_imageApply, which commits each register of a port with one store.
+ * The rows follow DioPort_t.
+*/
+const DioPortImage_t DioImage[NUMBER_OF_PORTS] =
+{
+    DIO_PORT_IMAGE(DIO_PA),
+    DIO_PORT_IMAGE(DIO_PB),
+    DIO_PORT_IMAGE(DIO_PC),
+    DIO_PORT_IMAGE(DIO_PD),
+    DIO_PORT_IMAGE(DIO_PH)
+};
+
+DIO_CONFIG_TABLE(DIO_CONFIG_CHECK, 0)
+DIO_PORT_CHECK(DIO_PA)
+DIO_PORT_CHECK(DIO_PB)
+DIO_PORT_CHECK(DIO_PC)
+DIO_PORT_CHECK(DIO_PD)
+DIO_PORT_CHECK(DIO_PH)
+_Static_assert(NUMBER_OF_PORTS == DIO_MAX_PORT, 
+"DioImage holds one row per DioPort_t");
+
 /*****************************************************************************
 * Function Prototypes
 *****************************************************************************/
@@ -133,4 +240,69 @@ const DioConfig_t * const DIO_configGet(void)
 size_t DIO_configSizeGet(void)
 {
    return sizeof(DioConfig)/sizeof(DioConfig[0]);
-}
\ No newline at end of file
+}
+
+/*****************************************************************************
+ * Function: DIO_imageGet()
+*/
+/**
+*\b Description:
+ * This function is used to get the register values of each port reduced 
+ * from the configuration table at compile time.
+ * 
+ * PRE-CONDITION: configuration table needs to be populated (sizeof > 0) <br>
+ * 
+ * POST-CONDITION: A constant pointer to the first port image will be 
+ * returned.<br>
+ * 
+ * @return A pointer to the port images, ordered by DioPort_t.
+ * 
+ * \b Example: 
+ * @code
+ * const DioPortImage_t * const DioImage = DIO_imageGet();
+ * size_t imageSize = DIO_imageSizeGet();
+ * 
+ * DIO_imageApply(DioImage, imageSize);
+ * @endcode
+ * 
+ * @see DIO_configGet
+ * @see DIO_imageGet
+ * @see DIO_imageSizeGet
+ * @see DIO_imageApply
+ * 
+*****************************************************************************/
+const DioPortImage_t * const DIO_imageGet(void)
+{
+   return (const DioPortImage_t*)&DioImage[0];
+}
+
+/*****************************************************************************
+ * Function: DIO_imageSizeGet()
+*/
+/**
+*\b Description:
+ * This function is used to get the number of port images.
+ * 
+ * PRE-CONDITION: None. <br>
+ * 
+ * POST-CONDITION: The number of port images will be returned. <br>
+ * 
+ * @return The number of port images.
+ * 
+ * \b Example: 
+ * @code
+ * const DioPortImage_t * const DioImage = DIO_imageGet();
+ * size_t imageSize = DIO_imageSizeGet();
+ * 
+ * DIO_imageApply(DioImage, imageSize);
+ * @endcode
+ * 
+ * @see DIO_imageGet
+ * @see DIO_imageSizeGet
+ * @see DIO_imageApply
+ * 
+*****************************************************************************/
+size_t DIO_imageSizeGet(void)
+{
+   return sizeof(DioImage)/sizeof(DioImage[0]);
+}
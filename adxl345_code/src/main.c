@@ -15,26 +15,50 @@
 * Includes
 *****************************************************************************/
 #include <adxl345.h>
+#include <clock.h>
+#include <probe.h>
+#include <scale.h>
+#include <sensors.h>
 
 /*****************************************************************************
 * Variable Definitions
 *****************************************************************************/
 int16_t x, y, z;
 float xg, yg, zg;
-uint16_t dataAxis[6];
+float accel[FIFO_MAX_ENTRIES * 3U];
+uint16_t sampleCount;
+/** Set by the INT1 (PA0) interrupt when the ADXL345 has data ready*/
+volatile uint8_t dataReady;
+/** Cycle count of the last INT1 rising edge*/
+volatile uint32_t dataReadyStamp;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void SampleSink(uint8_t Device, const Adxl345Sample_t * const Samples, 
+uint8_t count);
+static void Int1Event(DioPin_t Line, uint32_t timestamp);
 
 int main (void)
 {
-    /*Enable clock access to GPIOA and SPI1*/
+    /*Run the core and the buses at 80 MHz from the PLL*/
+    CLOCK_init();
+
+    /*Start the timing probes, nothing when built without PROBE_ENABLE*/
+    PROBE_INIT();
+
+    /*Enable clock access to GPIOA, DMA2, SPI1 and SYSCFG*/
     RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
     RCC->APB2ENR |= RCC_APB2ENR_SPI1EN;
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
 
-    /*Get the address of the configuration table for DIO*/
-    const DioConfig_t * const DioConfig = DIO_configGet();
-    /*Get the size of the configuration table*/
-    size_t configSizeDio = DIO_configSizeGet();
-    /* Initialize the DIO pins according to the configuration table*/
-    DIO_init(DioConfig, configSizeDio);
+    /*Get the port images reduced from the DIO configuration table*/
+    const DioPortImage_t * const DioImage = DIO_imageGet();
+    /*Get the number of port images*/
+    size_t imageSizeDio = DIO_imageSizeGet();
+    /* Initialize the DIO pins, one store per register of each port*/
+    DIO_imageApply(DioImage, imageSizeDio);
 
     /*Get the address of the configuration table for SPI*/
     const SpiConfig_t * const SpiConfig = SPI_ConfigGet();
@@ -44,33 +68,104 @@ int main (void)
     SPI_init(SpiConfig, configSizeSpi);
 
 
-    /*ADXL345 configuration data*/
-    Adxl345Config_t Adxl345Config =
+    /*ADXL345 INT1 line*/
+    const DioPinConfig_t Int1Line =
     {
-        .Channel = SPI_CHANNEL1,
         .Port = DIO_PA,
-        
-        .Pin = DIO_PA4
+        .Pin = DIO_PA0
     };
 
-    /*Initialize accelerometer*/
-    ADXL345_init(&Adxl345Config);
+    /*Raise an interrupt on the rising edge of INT1*/
+    DIO_interruptEnable(&Int1Line, DIO_EDGE_RISING, Int1Event);
+
+    /*Get the address of the ADXL345 device table*/
+    const Adxl345Config_t * const SensorsConfig = SENSORS_configGet();
+    /*Get the size of the device table*/
+    size_t configSizeSensors = SENSORS_configSizeGet();
+    /*Initialize every accelerometer of the device table, again while a 
+    bus fault leaves a device unconfigured*/
+    while(SENSORS_init(SensorsConfig, configSizeSensors) != SPI_OK)
+    {
+    }
 
     while(1)
     {
-        /*Read the axis values*/
-        ADXL345_read(&Adxl345Config, DATA_START_R, 
-        sizeof(dataAxis)/sizeof(dataAxis[0]), &dataAxis[0]);
-
-        /*Get x, y, z. Order the bytes (x0 and x1) on one 16 bits variable*/
-        x = ((dataAxis[1]<<8) | dataAxis[0]);
-        y = ((dataAxis[3]<<8) | dataAxis[2]);
-        z = ((dataAxis[5]<<8) | dataAxis[4]);
-
-        /*Multiply for four g scale factor*/
-        xg = (x * 0.0078);
-        yg = (y * 0.0078);
-        zg = (z * 0.0078);
+        /*Sleep until INT1 fires or a bus completes. The check runs with 
+        interrupts masked so an event between the test and WFI still wakes
+        the core*/
+        __disable_irq();
+        if(!dataReady && (SENSORS_readyGet() == 0U))
+        {
+            __WFI();
+        }
+        __enable_irq();
+
+        /*Hand the acquisitions completed by DMA to the sink*/
+        sampleCount = SENSORS_collect(SampleSink);
+
+        /*INT1 is a level output, restart while it is held so no edge is 
+        missed. The buses still transferring are left running*/
+        if(dataReady || (DIO_pinRead(&Int1Line) == DIO_HIGH))
+        {
+            dataReady = 0;
+            SENSORS_start();
+        }
     }
 
-}
\ No newline at end of file
+}
+
+/*****************************************************************************
+ * Function: SampleSink()
+*//**
+*\b Description:
+ * This function receives the samples drained from a device. The block is 
+ * converted to g and the newest sample of device 0 is kept for inspection.
+ * 
+ * @param[in]   Device is the device index.
+ * @param[in]   Samples is the block of raw samples.
+ * @param[in]   count is the number of samples.
+ * 
+ * @return  void
+ * 
+*****************************************************************************/
+static void SampleSink(uint8_t Device, const Adxl345Sample_t * const Samples, 
+uint8_t count)
+{
+    const Adxl345Config_t * const Config = SENSORS_deviceGet(Device);
+
+    /*Convert the whole block to g*/
+    SCALE_toFloat(Samples, &accel[0], count, Config->Range, 
+    Config->Resolution);
+
+    if(Device == 0U)
+    {
+        /*Keep the newest sample for inspection*/
+        x = Samples[count - 1U].x;
+        y = Samples[count - 1U].y;
+        z = Samples[count - 1U].z;
+        xg = accel[(count - 1U) * 3U];
+        yg = accel[(count - 1U) * 3U + 1U];
+        zg = accel[(count - 1U) * 3U + 2U];
+    }
+}
+
+/*****************************************************************************
+ * Function: Int1Event()
+*//**
+*\b Description:
+ * This function is called from the EXTI interrupt on the rising edge of 
+ * the ADXL345 INT1 output, wired to PA0. It flags that data is ready and 
+ * keeps the edge time, the main loop performs the read.
+ * 
+ * @param[in]   Line is the EXTI line of the edge.
+ * @param[in]   timestamp is the cycle count of the edge.
+ * 
+ * @return  void
+ * 
+*****************************************************************************/
+static void Int1Event(DioPin_t Line, uint32_t timestamp)
+{
+    (void)Line;
+    dataReadyStamp = timestamp;
+    dataReady = 1;
+}
@@ -0,0 +1,367 @@
+/**
+ * @file probe.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation for the timing probes. A measure is binned by
+ * the position of its most significant bit, so recording costs a count
+ * leading zeros and a few adds in a short critical section, the same from
+ * an interrupt and from the main loop. The module is empty unless
+ * PROBE_ENABLE is defined.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <assert.h>
+#include <string.h>
+#include "probe.h"
+
+#ifdef PROBE_ENABLE
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Digits of the largest uint32_t*/
+#define DECIMAL_DIGITS      (10U)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Statistics of each probe point, read them with the debugger by name*/
+static ProbeStats_t probeStats[PROBE_MAX];
+
+/** Cycles of an empty measure, taken off every measure*/
+static uint32_t overhead;
+
+/** Names of the probe points in the report*/
+static const char * const probeName[PROBE_MAX] =
+{
+    "spi_transaction", "spi_cs", "spi_isr", "dma_isr", "exti_isr",
+    "sample_read", "sample_sink"
+};
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void PROBE_writeText(ProbeWrite_t Write, const char *text);
+static void PROBE_writeNumber(ProbeWrite_t Write, uint32_t value);
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: PROBE_init()
+*//**
+*\b Description:
+ * This function is used to start the DWT cycle counter, measure the cost
+ * of an empty probe and clear the statistics of every probe point.
+ *
+ * PRE-CONDITION: PROBE_ENABLE is defined. <br>
+ *
+ * POST-CONDITION: CYCCNT is running and the probes are cleared. <br>
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * CLOCK_init();
+ * PROBE_INIT();
+ * @endcode
+ *
+ * @see PROBE_record
+ * @see PROBE_statsReset
+ *
+*****************************************************************************/
+void PROBE_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /*Two back to back reads of CYCCNT are the cost of a probe*/
+    const uint32_t start = DWT->CYCCNT;
+    overhead = DWT->CYCCNT - start;
+
+    PROBE_statsReset();
+}
+
+/*****************************************************************************
+ * Function: PROBE_record()
+*//**
+*\b Description:
+ * This function is used to accumulate a measure into a probe point. It is
+ * called by PROBE_RECORD and can be called from an interrupt.
+ *
+ * PRE-CONDITION: PROBE_init is called first. <br>
+ * PRE-CONDITION: The Probe is within the maximum ProbeId_t. <br>
+ *
+ * POST-CONDITION: The count, extremes, sum and histogram are updated. <br>
+ *
+ * @param[in]   Probe is the probe point.
+ * @param[in]   cycles is the measure in CPU cycles.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * PROBE_STAMP(start);
+ * SPI_transaction(SPI_CHANNEL1, &Transaction);
+ * PROBE_RECORD(PROBE_SPI_TRANSACTION, start);
+ * @endcode
+ *
+ * @see PROBE_statsGet
+ *
+*****************************************************************************/
+void PROBE_record(ProbeId_t Probe, uint32_t cycles)
+{
+    /* Prevent to assign a value out of the range of the probes*/
+    assert(Probe < PROBE_MAX);
+
+    cycles = (cycles > overhead) ? (cycles - overhead) : 0U;
+    const uint8_t bucket = (uint8_t)(31U - __CLZ(cycles | 1U));
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    ProbeStats_t * const Stats = &probeStats[Probe];
+    if(cycles < Stats->min)
+    {
+        Stats->min = cycles;
+    }
+    if(cycles > Stats->max)
+    {
+        Stats->max = cycles;
+    }
+    Stats->count++;
+    Stats->sum += cycles;
+    Stats->bucket[bucket]++;
+
+    __set_PRIMASK(primask);
+}
+
+/*****************************************************************************
+ * Function: PROBE_statsGet()
+*//**
+*\b Description:
+ * This function is used to get the statistics of a probe point.
+ *
+ * PRE-CONDITION: The Probe is within the maximum ProbeId_t. <br>
+ *
+ * POST-CONDITION: A pointer to the statistics is returned. <br>
+ *
+ * @param[in]   Probe is the probe point.
+ *
+ * @return  A pointer to the statistics of the probe point.
+ *
+ * \b Example:
+ * @code
+ * const ProbeStats_t * const Stats = PROBE_statsGet(PROBE_SPI_CS);
+ * uint32_t jitter = Stats->max - Stats->min;
+ * @endcode
+ *
+ * @see PROBE_meanGet
+ * @see PROBE_statsReset
+ *
+*****************************************************************************/
+const ProbeStats_t * PROBE_statsGet(ProbeId_t Probe)
+{
+    /* Prevent to assign a value out of the range of the probes*/
+    assert(Probe < PROBE_MAX);
+
+    return &probeStats[Probe];
+}
+
+/*****************************************************************************
+ * Function: PROBE_meanGet()
+*//**
+*\b Description:
+ * This function is used to get the mean measure of a probe point.
+ *
+ * PRE-CONDITION: The Probe is within the maximum ProbeId_t. <br>
+ *
+ * POST-CONDITION: The mean is returned, 0 before the first measure. <br>
+ *
+ * @param[in]   Probe is the probe point.
+ *
+ * @return  The mean measure in CPU cycles.
+ *
+ * \b Example:
+ * @code
+ * uint32_t mean = PROBE_meanGet(PROBE_EXTI_ISR);
+ * @endcode
+ *
+ * @see PROBE_statsGet
+ *
+*****************************************************************************/
+uint32_t PROBE_meanGet(ProbeId_t Probe)
+{
+    /* Prevent to assign a value out of the range of the probes*/
+    assert(Probe < PROBE_MAX);
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    const uint32_t count = probeStats[Probe].count;
+    const uint64_t sum = probeStats[Probe].sum;
+    __set_PRIMASK(primask);
+
+    return (count > 0U) ? (uint32_t)(sum / count) : 0U;
+}
+
+/*****************************************************************************
+ * Function: PROBE_statsReset()
+*//**
+*\b Description:
+ * This function is used to clear the statistics of every probe point.
+ *
+ * PRE-CONDITION: None. <br>
+ *
+ * POST-CONDITION: The counts are zero and the minimums are at their
+ * maximum value. <br>
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * PROBE_statsReset();
+ * @endcode
+ *
+ * @see PROBE_statsGet
+ *
+*****************************************************************************/
+void PROBE_statsReset(void)
+{
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    memset(probeStats, 0, sizeof(probeStats));
+    for(uint8_t i = 0; i < PROBE_MAX; i++)
+    {
+        probeStats[i].min = UINT32_MAX;
+    }
+
+    __set_PRIMASK(primask);
+}
+
+/*****************************************************************************
+ * Function: PROBE_report()
+*//**
+*\b Description:
+ * This function is used to write the statistics of the probe points that
+ * have measures as text, one line per probe point:
+ * name count min mean max followed by bucket:count for each bucket in use.
+ * The lines end with a line feed.
+ *
+ * PRE-CONDITION: Write is not NULL. <br>
+ *
+ * POST-CONDITION: The report is written. <br>
+ *
+ * @param[in]   Write is the character output.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * PROBE_report(ItmWrite);
+ * @endcode
+ *
+ * @see PROBE_statsGet
+ *
+*****************************************************************************/
+void PROBE_report(ProbeWrite_t Write)
+{
+    /* Prevent to use an empty output*/
+    assert(Write != NULL);
+
+    for(uint8_t i = 0; i < PROBE_MAX; i++)
+    {
+        /*Work on a copy so an interrupt does not tear the line*/
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        const ProbeStats_t Stats = probeStats[i];
+        __set_PRIMASK(primask);
+
+        if(Stats.count == 0U)
+        {
+            continue;
+        }
+
+        PROBE_writeText(Write, probeName[i]);
+        Write(' ');
+        PROBE_writeNumber(Write, Stats.count);
+        Write(' ');
+        PROBE_writeNumber(Write, Stats.min);
+        Write(' ');
+        PROBE_writeNumber(Write, (uint32_t)(Stats.sum / Stats.count));
+        Write(' ');
+        PROBE_writeNumber(Write, Stats.max);
+
+        for(uint8_t bucket = 0; bucket < PROBE_BUCKETS; bucket++)
+        {
+            if(Stats.bucket[bucket] > 0U)
+            {
+                Write(' ');
+                PROBE_writeNumber(Write, bucket);
+                Write(':');
+                PROBE_writeNumber(Write, Stats.bucket[bucket]);
+            }
+        }
+        Write('\n');
+    }
+}
+
+/*****************************************************************************
+ * Function: PROBE_writeText()
+*//**
+*\b Description:
+ * This function is used to write a string to the report output.
+ *
+ * @param[in]   Write is the character output.
+ * @param[in]   text is the string to write.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void PROBE_writeText(ProbeWrite_t Write, const char *text)
+{
+    while(*text != '\0')
+    {
+        Write(*text);
+        text++;
+    }
+}
+
+/*****************************************************************************
+ * Function: PROBE_writeNumber()
+*//**
+*\b Description:
+ * This function is used to write an unsigned number in decimal to the
+ * report output, without a printf in the image.
+ *
+ * @param[in]   Write is the character output.
+ * @param[in]   value is the number to write.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void PROBE_writeNumber(ProbeWrite_t Write, uint32_t value)
+{
+    char digits[DECIMAL_DIGITS];
+    uint8_t count = 0;
+
+    do
+    {
+        digits[count] = (char)('0' + (value % 10U));
+        value /= 10U;
+        count++;
+    }while(value > 0U);
+
+    while(count > 0U)
+    {
+        count--;
+        Write(digits[count]);
+    }
+}
+
+#endif /*PROBE_ENABLE*/
@@ -0,0 +1,301 @@
+/**
+ * @file scale.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation for the acceleration scaling. The nominal
+ * ADXL345 sensitivities are powers of two LSB/g, so the fixed-point kernels
+ * reduce to shifts and the float kernel to one single precision multiply.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <string.h>
+#include "scale.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Axes in one sample*/
+#define AXES                (3U)
+/** Fraction bits of a Q15 value of +-SCALE_FULL_SCALE_G (2^15 / 16)*/
+#define Q15_ONE_G_SHIFT     (11U)
+/** Fraction bits of a Q31 value of +-SCALE_FULL_SCALE_G (2^31 / 16)*/
+#define Q31_ONE_G_SHIFT     (27U)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/**
+ * The following table contains the sensitivity of each range and
+ * resolution as log2(LSB/g). 10 bits mode halves the sensitivity on each
+ * range step, full resolution keeps 256 LSB/g.
+ */
+static const uint8_t sensitivityShift[ADXL345_MAX_RESOLUTION]
+[ADXL345_MAX_RANGE] =
+{
+/*   2g  4g  8g  16g */
+    {8U, 7U, 6U, 5U},   /* ADXL345_10BIT */
+    {8U, 8U, 8U, 8U}    /* ADXL345_FULL_RES */
+};
+
+/**
+ * The following table contains the g/LSB scale factor of each range and
+ * resolution. It is the inverse of sensitivityShift, kept in single
+ * precision so the conversion uses the FPU instead of soft double math.
+ */
+static const float scaleFactor[ADXL345_MAX_RESOLUTION][ADXL345_MAX_RANGE] =
+{
+/*   2g           4g           8g           16g */
+    {0.00390625f, 0.0078125f,  0.015625f,   0.03125f},
+    {0.00390625f, 0.00390625f, 0.00390625f, 0.00390625f}
+};
+
+_Static_assert(sizeof(Adxl345Sample_t) == (AXES * sizeof(int16_t)),
+"Adxl345Sample_t must be three packed 16 bits values");
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SCALE_shiftGet()
+*//**
+*\b Description:
+ * This function is used to get the sensitivity of a range and resolution
+ * as log2(LSB/g).
+ *
+ * PRE-CONDITION: The Range is within the maximum Adxl345Range_t. <br>
+ * PRE-CONDITION: The Resolution is within the maximum Adxl345Resolution_t.
+ * <br>
+ *
+ * POST-CONDITION: The sensitivity shift is returned. <br>
+ *
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  log2 of the LSB per g.
+ *
+ * \b Example:
+ * @code
+ * uint8_t shift = SCALE_shiftGet(ADXL345_RANGE_4G, ADXL345_10BIT); // 7
+ * @endcode
+ *
+ * @see SCALE_shiftGet
+ * @see SCALE_factorGet
+ *
+*****************************************************************************/
+uint8_t SCALE_shiftGet(Adxl345Range_t Range, Adxl345Resolution_t Resolution)
+{
+    /* Prevent to read out of the range of the tables*/
+    assert(Range < ADXL345_MAX_RANGE);
+    assert(Resolution < ADXL345_MAX_RESOLUTION);
+
+    return sensitivityShift[Resolution][Range];
+}
+
+/*****************************************************************************
+ * Function: SCALE_factorGet()
+*//**
+*\b Description:
+ * This function is used to get the scale factor in g/LSB of a range and
+ * resolution.
+ *
+ * PRE-CONDITION: The Range is within the maximum Adxl345Range_t. <br>
+ * PRE-CONDITION: The Resolution is within the maximum Adxl345Resolution_t.
+ * <br>
+ *
+ * POST-CONDITION: The scale factor is returned. <br>
+ *
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  The scale factor in g/LSB.
+ *
+ * \b Example:
+ * @code
+ * float factor = SCALE_factorGet(ADXL345_RANGE_4G, ADXL345_10BIT);
+ * @endcode
+ *
+ * @see SCALE_shiftGet
+ * @see SCALE_factorGet
+ *
+*****************************************************************************/
+float SCALE_factorGet(Adxl345Range_t Range, Adxl345Resolution_t Resolution)
+{
+    /* Prevent to read out of the range of the tables*/
+    assert(Range < ADXL345_MAX_RANGE);
+    assert(Resolution < ADXL345_MAX_RESOLUTION);
+
+    return scaleFactor[Resolution][Range];
+}
+
+/*****************************************************************************
+ * Function: SCALE_toFloat()
+*//**
+*\b Description:
+ * This function is used to convert a block of samples to g in single
+ * precision. The factor is looked up once per block and each axis costs
+ * one conversion and one multiply on the FPU.
+ *
+ * PRE-CONDITION: Samples holds count elements. <br>
+ * PRE-CONDITION: out holds count * 3 elements. <br>
+ * PRE-CONDITION: The Range and Resolution match the DATA_FORMAT in use. <br>
+ *
+ * POST-CONDITION: out holds x, y, z in g for each sample. <br>
+ *
+ * @param[in]   Samples is the block of raw samples.
+ * @param[out]  out is the interleaved x, y, z output.
+ * @param[in]   count is the number of samples.
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * float accel[FIFO_MAX_ENTRIES * 3];
+ * SCALE_toFloat(samples, accel, count, ADXL345_RANGE_4G, ADXL345_10BIT);
+ * @endcode
+ *
+ * @see SCALE_toFloat
+ * @see SCALE_toQ15
+ * @see SCALE_toQ31
+ *
+*****************************************************************************/
+void SCALE_toFloat(const Adxl345Sample_t * const Samples, float *out,
+size_t count, Adxl345Range_t Range, Adxl345Resolution_t Resolution)
+{
+    /* Prevent to use empty buffers*/
+    assert(Samples != NULL);
+    assert(out != NULL);
+
+    const float factor = SCALE_factorGet(Range, Resolution);
+
+    for(size_t i = 0; i < count; i++)
+    {
+        out[0] = (float)Samples[i].x * factor;
+        out[1] = (float)Samples[i].y * factor;
+        out[2] = (float)Samples[i].z * factor;
+        out += AXES;
+    }
+}
+
+/*****************************************************************************
+ * Function: SCALE_toQ15()
+*//**
+*\b Description:
+ * This function is used to convert a block of samples to Q15 fractions of
+ * +-SCALE_FULL_SCALE_G. The raw values are shifted two axes at a time: a
+ * 32 bits word holding two axes is shifted once and the bits carried from
+ * the low axis into the high axis are masked out. Only a shift and an AND
+ * per pair are needed, with no multiply, on the Cortex-M4 and on the host.
+ *
+ * PRE-CONDITION: Samples holds count elements. <br>
+ * PRE-CONDITION: out holds count * 3 elements. <br>
+ * PRE-CONDITION: The Range and Resolution match the DATA_FORMAT in use. <br>
+ *
+ * POST-CONDITION: out holds x, y, z in Q15 for each sample. <br>
+ *
+ * @param[in]   Samples is the block of raw samples.
+ * @param[out]  out is the interleaved x, y, z output.
+ * @param[in]   count is the number of samples.
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * int16_t accel[FIFO_MAX_ENTRIES * 3];
+ * SCALE_toQ15(samples, accel, count, ADXL345_RANGE_4G, ADXL345_10BIT);
+ * @endcode
+ *
+ * @see SCALE_toFloat
+ * @see SCALE_toQ15
+ * @see SCALE_toQ31
+ *
+*****************************************************************************/
+void SCALE_toQ15(const Adxl345Sample_t * const Samples, int16_t *out,
+size_t count, Adxl345Range_t Range, Adxl345Resolution_t Resolution)
+{
+    /* Prevent to use empty buffers*/
+    assert(Samples != NULL);
+    assert(out != NULL);
+
+    const uint32_t shift = Q15_ONE_G_SHIFT - SCALE_shiftGet(Range, Resolution);
+    /* Bits carried from the low axis into the high axis by the shift*/
+    const uint32_t carryMask = ~(((1UL << shift) - 1UL) << 16);
+    const int16_t *raw = &Samples[0].x;
+    const size_t axes = count * AXES;
+    size_t i = 0;
+
+    /* Two axes per word. memcpy keeps the access alias safe and compiles
+     * to a single unaligned load and store.
+    */
+    for(; (i + 1U) < axes; i += 2U)
+    {
+        uint32_t pair;
+        memcpy(&pair, &raw[i], sizeof(pair));
+        pair = (pair << shift) & carryMask;
+        memcpy(&out[i], &pair, sizeof(pair));
+    }
+
+    /* Odd axis left over*/
+    if(i < axes)
+    {
+        out[i] = (int16_t)(raw[i] * (int16_t)(1 << shift));
+    }
+}
+
+/*****************************************************************************
+ * Function: SCALE_toQ31()
+*//**
+*\b Description:
+ * This function is used to convert a block of samples to Q31 fractions of
+ * +-SCALE_FULL_SCALE_G. Each axis is widened and shifted.
+ *
+ * PRE-CONDITION: Samples holds count elements. <br>
+ * PRE-CONDITION: out holds count * 3 elements. <br>
+ * PRE-CONDITION: The Range and Resolution match the DATA_FORMAT in use. <br>
+ *
+ * POST-CONDITION: out holds x, y, z in Q31 for each sample. <br>
+ *
+ * @param[in]   Samples is the block of raw samples.
+ * @param[out]  out is the interleaved x, y, z output.
+ * @param[in]   count is the number of samples.
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * int32_t accel[FIFO_MAX_ENTRIES * 3];
+ * SCALE_toQ31(samples, accel, count, ADXL345_RANGE_16G, ADXL345_FULL_RES);
+ * @endcode
+ *
+ * @see SCALE_toFloat
+ * @see SCALE_toQ15
+ * @see SCALE_toQ31
+ *
+*****************************************************************************/
+void SCALE_toQ31(const Adxl345Sample_t * const Samples, int32_t *out,
+size_t count, Adxl345Range_t Range, Adxl345Resolution_t Resolution)
+{
+    /* Prevent to use empty buffers*/
+    assert(Samples != NULL);
+    assert(out != NULL);
+
+    const int32_t gain =
+    (int32_t)(1L << (Q31_ONE_G_SHIFT - SCALE_shiftGet(Range, Resolution)));
+    const int16_t *raw = &Samples[0].x;
+    const size_t axes = count * AXES;
+
+    for(size_t i = 0; i < axes; i++)
+    {
+        out[i] = (int32_t)raw[i] * gain;
+    }
+}
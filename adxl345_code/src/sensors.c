@@ -0,0 +1,777 @@
+/**
+ * @file sensors.c
+ * @author Jose Luis Figueroa
+ * @brief The implementation for the ADXL345 device table. Devices are 
+ * grouped by SPI channel, each bus is owned by one device at a time and the
+ * devices of a bus take turns, so adding a sensor adds SPI frames to its 
+ * bus only and the load of each bus is reported.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <string.h>
+#include "clock.h"
+#include "probe.h"
+#include "sensors.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** SPI frames of a FIFO_STATUS read: address and one register*/
+#define STATUS_READ_FRAMES  (2U)
+/** SPI frames of a sample read: address and six data registers*/
+#define SAMPLE_READ_FRAMES  (AXIS_BYTES + 1U)
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+/**
+ * Defines the steps of a DMA acquisition on a bus.
+ */
+typedef enum
+{
+    BUS_IDLE,       /**< No acquisition in progress */
+    BUS_STATUS,     /**< Reading FIFO_STATUS */
+    BUS_SAMPLES,    /**< Popping the samples of the FIFO */
+    BUS_DONE        /**< Samples waiting for SENSORS_collect */
+}SensorsBusState_t;
+
+/**
+ * Defines the DMA acquisition context of a bus.
+ */
+typedef struct
+{
+    volatile SensorsBusState_t state;       /**< Step in progress */
+    uint8_t device;                         /**< Device being drained */
+    uint8_t entries;                        /**< Samples to pop */
+    uint8_t count;                          /**< Samples popped */
+    uint16_t frames[AXIS_BYTES];            /**< Registers of the last read */
+    Adxl345Sample_t samples[FIFO_MAX_ENTRIES]; /**< Samples popped */
+}SensorsBus_t;
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Device table given to SENSORS_init*/
+static const Adxl345Config_t *sensorTable;
+/** Number of devices in the table*/
+static size_t sensorCount;
+/** Devices of each bus, in table order*/
+static uint8_t busDevices[SPI_PORTS_NUMBER][ADXL345_DEVICES_NUMBER];
+/** Number of devices of each bus*/
+static uint8_t busSize[SPI_PORTS_NUMBER];
+/** Position in busDevices of the next device to serve*/
+static uint8_t busNext[SPI_PORTS_NUMBER];
+/** Device that owns each bus, or SENSORS_BUS_FREE*/
+static volatile uint8_t busOwner[SPI_PORTS_NUMBER];
+/** Samples drained from the device being served*/
+static Adxl345Sample_t samples[FIFO_MAX_ENTRIES];
+/** DMA acquisition of each bus*/
+static SensorsBus_t bus[SPI_PORTS_NUMBER];
+/** Buses with a DMA acquisition waiting for SENSORS_collect*/
+static volatile uint8_t readyMask;
+/** Throughput counters*/
+static SensorsStats_t stats;
+/** CYCCNT at the FIFO_STATUS read that sized the last drain of each device*/
+static uint32_t drainStamp[ADXL345_DEVICES_NUMBER];
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void SENSORS_turnEnd(uint8_t channel, uint8_t device, uint8_t count);
+static void SENSORS_dmaComplete(const Adxl345Config_t * const Config, 
+SpiStatus_t Status);
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SENSORS_init()
+*//**
+*\b Description:
+ * This function is used to initialize every ADXL345 of the device table. 
+ * All the chip select lines are released first, so a device on a shared 
+ * bus does not answer while another one is configured. The devices are then
+ * grouped by SPI channel for the round-robin acquisition.
+ *
+ * PRE-CONDITION: DIO_init and SPI_init must be called for every channel 
+ * and chip select pin of the table. <br>
+ * PRE-CONDITION: configSize <= ADXL345_DEVICES_NUMBER. <br>
+ * PRE-CONDITION: The Device of each row matches its row index. <br>
+ * PRE-CONDITION: A hardware NSS channel serves a single device. <br>
+ *
+ * POST-CONDITION: On SPI_OK every device is measuring. Every bus is free.
+ * <br>
+ *
+ * @param[in]   Config is a pointer to the device table.
+ * @param[in]   configSize is the number of devices in the table.
+ *
+ * @return  SPI_OK, or the first SPI fault met while configuring the 
+ *          devices. Every device is still attempted.
+ *
+ * \b Example:
+ * @code
+ * const Adxl345Config_t * const SensorsConfig = SENSORS_configGet();
+ * size_t configSize = SENSORS_configSizeGet();
+ *
+ * SENSORS_init(SensorsConfig, configSize);
+ * @endcode
+ *
+ * @see SENSORS_configGet
+ * @see SENSORS_configSizeGet
+ * @see SENSORS_init
+ * @see SENSORS_poll
+ *
+*****************************************************************************/
+SpiStatus_t SENSORS_init(const Adxl345Config_t * const Config, 
+size_t configSize)
+{
+    /* Prevent to use an empty table or more devices than the shadows*/
+    assert(Config != NULL);
+    assert(configSize <= ADXL345_DEVICES_NUMBER);
+
+    sensorTable = Config;
+    sensorCount = configSize;
+
+    for(uint8_t i = 0; i < SPI_PORTS_NUMBER; i++)
+    {
+        busSize[i] = 0;
+        busNext[i] = 0;
+        busOwner[i] = SENSORS_BUS_FREE;
+        bus[i].state = BUS_IDLE;
+    }
+    readyMask = 0;
+
+    /*Release every chip select before talking to any device*/
+    for(uint8_t i = 0; i < configSize; i++)
+    {
+        /* Prevent a row index that does not match the device shadow*/
+        assert(Config[i].Device == i);
+        assert(Config[i].Channel < SPI_PORTS_NUMBER);
+        /* Prevent a bus clock the device cannot follow or that starves the 
+         * output data rate
+        */
+        assert(SPI_bitRateGet(Config[i].Channel) <= ADXL345_SPI_CLOCK_MAX);
+        assert(SPI_bitRateGet(Config[i].Channel) >= 
+        ADXL345_minSpiClockGet(Config[i].Odr));
+
+        const DioPinConfig_t ChipSelect = 
+        {
+            .Port = Config[i].Port,
+            .Pin = Config[i].Pin
+        };
+        if(!SPI_hardwareNssGet(Config[i].Channel))
+        {
+            DIO_pinWrite(&ChipSelect, DIO_HIGH);
+        }
+
+        busDevices[Config[i].Channel][busSize[Config[i].Channel]] = i;
+        busSize[Config[i].Channel]++;
+    }
+
+    /* The NSS output of a channel selects a single device*/
+    for(uint8_t i = 0; i < SPI_PORTS_NUMBER; i++)
+    {
+        assert(!SPI_hardwareNssGet((SpiChannel_t)i) || (busSize[i] <= 1U));
+    }
+
+    SpiStatus_t result = SPI_OK;
+    for(uint8_t i = 0; i < configSize; i++)
+    {
+        const SpiStatus_t status = ADXL345_init(&Config[i]);
+        if(result == SPI_OK)
+        {
+            result = status;
+        }
+    }
+
+    SENSORS_statsReset();
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_poll()
+*//**
+*\b Description:
+ * This function is used to run one acquisition pass. Each bus serves the 
+ * next device of its round-robin: the FIFO of the device is drained and the
+ * samples are handed to the sink. Devices on separate buses are all served
+ * on every pass, devices sharing a bus are served once every busSize 
+ * passes, so no device is starved by another one. A bus owned by another 
+ * user keeps its turn for the next pass.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ * PRE-CONDITION: The pass rate keeps every FIFO below FIFO_DEPTH samples. <br>
+ *
+ * POST-CONDITION: The counters include the samples and frames of the pass.
+ * <br>
+ *
+ * @param[in]   Sink is the function that receives the samples, or NULL.
+ *
+ * @return  The number of samples drained in the pass.
+ *
+ * \b Example:
+ * @code
+ * while(1)
+ * {
+ *     SENSORS_poll(SampleSink);
+ * }
+ * @endcode
+ *
+ * @see SENSORS_init
+ * @see SENSORS_poll
+ * @see SENSORS_statsGet
+ *
+*****************************************************************************/
+uint16_t SENSORS_poll(SensorsSink_t Sink)
+{
+    uint16_t total = 0;
+
+    for(uint8_t channel = 0; channel < SPI_PORTS_NUMBER; channel++)
+    {
+        if(busSize[channel] == 0U)
+        {
+            continue;
+        }
+
+        const uint8_t device = busDevices[channel][busNext[channel]];
+
+        if(!SENSORS_busAcquire((SpiChannel_t)channel, device))
+        {
+            stats.busContention++;
+            continue;
+        }
+
+        drainStamp[device] = DWT->CYCCNT;
+        const uint8_t count = ADXL345_readSamples(&sensorTable[device], 
+        &samples[0], FIFO_MAX_ENTRIES);
+
+        SENSORS_busRelease((SpiChannel_t)channel, device);
+        SENSORS_turnEnd(channel, device, count);
+        total += count;
+
+        if((count > 0U) && (Sink != NULL))
+        {
+            PROBE_STAMP(start);
+            Sink(device, &samples[0], count);
+            PROBE_RECORD(PROBE_SAMPLE_SINK, start);
+        }
+    }
+
+    stats.passes++;
+
+    return total;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_start()
+*//**
+*\b Description:
+ * This function is used to start a DMA acquisition on every idle bus. The
+ * next device of each bus is drained without the CPU: the FIFO_STATUS read
+ * and every sample read are chained from the DMA completion interrupt, and
+ * each SPI channel uses its own DMA streams, so all the buses transfer at 
+ * the same time. The function returns once the reads are started.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ * PRE-CONDITION: The DMA controllers serving the channels are clocked. <br>
+ * PRE-CONDITION: The SPI channel callbacks are owned by this module while 
+ * an acquisition is in progress. <br>
+ *
+ * POST-CONDITION: Each idle bus owned by nobody has an acquisition in 
+ * progress. <br>
+ *
+ * @return  The number of buses started.
+ *
+ * \b Example:
+ * @code
+ * SENSORS_start();
+ * while(SENSORS_readyGet() == 0U)
+ * {
+ *     __WFI();
+ * }
+ * SENSORS_collect(SampleSink);
+ * @endcode
+ *
+ * @see SENSORS_start
+ * @see SENSORS_readyGet
+ * @see SENSORS_collect
+ *
+*****************************************************************************/
+uint8_t SENSORS_start(void)
+{
+    uint8_t started = 0;
+
+    for(uint8_t channel = 0; channel < SPI_PORTS_NUMBER; channel++)
+    {
+        SensorsBus_t * const Bus = &bus[channel];
+
+        if((busSize[channel] == 0U) || (Bus->state != BUS_IDLE))
+        {
+            continue;
+        }
+
+        const uint8_t device = busDevices[channel][busNext[channel]];
+
+        if(!SENSORS_busAcquire((SpiChannel_t)channel, device))
+        {
+            stats.busContention++;
+            continue;
+        }
+
+        Bus->device = device;
+        Bus->entries = 0;
+        Bus->count = 0;
+        Bus->state = BUS_STATUS;
+        drainStamp[device] = DWT->CYCCNT;
+        if(ADXL345_readDma(&sensorTable[device], FIFO_STATUS_R, 1, 
+        &Bus->frames[0], SENSORS_dmaComplete) != SPI_OK)
+        {
+            /*The bus faulted, give it back and retry on the next start*/
+            Bus->state = BUS_IDLE;
+            SENSORS_busRelease((SpiChannel_t)channel, device);
+            continue;
+        }
+        started++;
+    }
+
+    return started;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_readyGet()
+*//**
+*\b Description:
+ * This function is used to get the buses whose DMA acquisition completed 
+ * and waits for SENSORS_collect.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ *
+ * POST-CONDITION: The ready buses are returned. <br>
+ *
+ * @return  A mask with bit n set when SPI channel n is ready.
+ *
+ * \b Example:
+ * @code
+ * if(SENSORS_readyGet() != 0U)
+ * {
+ *     SENSORS_collect(SampleSink);
+ * }
+ * @endcode
+ *
+ * @see SENSORS_start
+ * @see SENSORS_readyGet
+ * @see SENSORS_collect
+ *
+*****************************************************************************/
+uint8_t SENSORS_readyGet(void)
+{
+    return readyMask;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_collect()
+*//**
+*\b Description:
+ * This function is used to collect the DMA acquisitions completed since 
+ * the last call. The samples of each ready bus are handed to the sink in 
+ * thread context, the bus is released and its round-robin moves to the 
+ * next device. Buses still transferring are left untouched, so the 
+ * completions are taken in the order they arrive.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ *
+ * POST-CONDITION: The ready buses are idle and the counters include their
+ * samples and frames. <br>
+ *
+ * @param[in]   Sink is the function that receives the samples, or NULL.
+ *
+ * @return  The number of samples collected.
+ *
+ * \b Example:
+ * @code
+ * SENSORS_collect(SampleSink);
+ * SENSORS_start();
+ * @endcode
+ *
+ * @see SENSORS_start
+ * @see SENSORS_readyGet
+ * @see SENSORS_collect
+ *
+*****************************************************************************/
+uint16_t SENSORS_collect(SensorsSink_t Sink)
+{
+    uint16_t total = 0;
+
+    for(uint8_t channel = 0; channel < SPI_PORTS_NUMBER; channel++)
+    {
+        SensorsBus_t * const Bus = &bus[channel];
+
+        if(Bus->state != BUS_DONE)
+        {
+            continue;
+        }
+
+        /*The completion interrupts of the other buses also set the mask*/
+        const uint32_t primask = __get_PRIMASK();
+        __disable_irq();
+        readyMask &= (uint8_t)~(1U << channel);
+        __set_PRIMASK(primask);
+
+        SENSORS_busRelease((SpiChannel_t)channel, Bus->device);
+        SENSORS_turnEnd(channel, Bus->device, Bus->count);
+        total += Bus->count;
+
+        if((Bus->count > 0U) && (Sink != NULL))
+        {
+            PROBE_STAMP(start);
+            Sink(Bus->device, &Bus->samples[0], Bus->count);
+            PROBE_RECORD(PROBE_SAMPLE_SINK, start);
+        }
+
+        Bus->state = BUS_IDLE;
+    }
+
+    return total;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_busAcquire()
+*//**
+*\b Description:
+ * This function is used to take the ownership of an SPI bus for a device. 
+ * Any transaction on a shared bus, including a DMA read that completes in 
+ * an interrupt, must own the bus so two chip selects are never active at 
+ * the same time. The test and set runs with interrupts masked.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ *
+ * POST-CONDITION: On success the bus is owned by the device. <br>
+ *
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Device is the device that needs the bus.
+ *
+ * @return  1 when the bus was taken, 0 when it is owned by another device.
+ *
+ * \b Example:
+ * @code
+ * if(SENSORS_busAcquire(SPI_CHANNEL1, 0))
+ * {
+ *     ADXL345_readSnapshot(SENSORS_deviceGet(0), &Snapshot);
+ *     SENSORS_busRelease(SPI_CHANNEL1, 0);
+ * }
+ * @endcode
+ *
+ * @see SENSORS_busAcquire
+ * @see SENSORS_busRelease
+ *
+*****************************************************************************/
+uint8_t SENSORS_busAcquire(SpiChannel_t Channel, uint8_t Device)
+{
+    /* Prevent to assign a value out of the range of the bus table*/
+    assert(Channel < SPI_PORTS_NUMBER);
+    assert(Device < ADXL345_DEVICES_NUMBER);
+
+    uint8_t taken = 0;
+    const uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(busOwner[Channel] == SENSORS_BUS_FREE)
+    {
+        busOwner[Channel] = Device;
+        taken = 1;
+    }
+    __set_PRIMASK(primask);
+
+    return taken;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_busRelease()
+*//**
+*\b Description:
+ * This function is used to give back an SPI bus taken with 
+ * SENSORS_busAcquire.
+ *
+ * PRE-CONDITION: The bus is owned by the Device. <br>
+ *
+ * POST-CONDITION: The bus is free. <br>
+ *
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Device is the device that owns the bus.
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SENSORS_busRelease(SPI_CHANNEL1, 0);
+ * @endcode
+ *
+ * @see SENSORS_busAcquire
+ * @see SENSORS_busRelease
+ *
+*****************************************************************************/
+void SENSORS_busRelease(SpiChannel_t Channel, uint8_t Device)
+{
+    /* Prevent to assign a value out of the range of the bus table*/
+    assert(Channel < SPI_PORTS_NUMBER);
+    /* Only the owner gives the bus back*/
+    assert(busOwner[Channel] == Device);
+    (void)Device;
+
+    busOwner[Channel] = SENSORS_BUS_FREE;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_deviceGet()
+*//**
+*\b Description:
+ * This function is used to get the configuration of a device of the table.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ * PRE-CONDITION: Device is a row of the device table. <br>
+ *
+ * POST-CONDITION: The configuration of the device is returned. <br>
+ *
+ * @param[in]   Device is the device index.
+ *
+ * @return  A pointer to the device configuration.
+ *
+ * \b Example:
+ * @code
+ * const Adxl345Config_t * const Config = SENSORS_deviceGet(0);
+ * @endcode
+ *
+ * @see SENSORS_init
+ * @see SENSORS_deviceGet
+ *
+*****************************************************************************/
+const Adxl345Config_t * SENSORS_deviceGet(uint8_t Device)
+{
+    /* Prevent to read out of the range of the table*/
+    assert(Device < sensorCount);
+
+    return &sensorTable[Device];
+}
+
+/*****************************************************************************
+ * Function: SENSORS_statsGet()
+*//**
+*\b Description:
+ * This function is used to get the throughput counters of the device table.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ *
+ * POST-CONDITION: A pointer to the counters is returned. <br>
+ *
+ * @return  A pointer to the throughput counters.
+ *
+ * \b Example:
+ * @code
+ * const SensorsStats_t * const Stats = SENSORS_statsGet();
+ * uint32_t frames = Stats->busFrames[SPI_CHANNEL1];
+ * @endcode
+ *
+ * @see SENSORS_statsGet
+ * @see SENSORS_statsReset
+ * @see SENSORS_rateGet
+ *
+*****************************************************************************/
+const SensorsStats_t * SENSORS_statsGet(void)
+{
+    return &stats;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_statsReset()
+*//**
+*\b Description:
+ * This function is used to clear the throughput counters, to start a new
+ * measurement window.
+ *
+ * PRE-CONDITION: The DWT cycle counter is running, SPI_init starts it. <br>
+ *
+ * POST-CONDITION: Every counter is zero and the window starts at the 
+ * current CYCCNT. <br>
+ *
+ * @return  void
+ *
+ * \b Example:
+ * @code
+ * SENSORS_statsReset();
+ * @endcode
+ *
+ * @see SENSORS_statsGet
+ * @see SENSORS_statsReset
+ *
+*****************************************************************************/
+void SENSORS_statsReset(void)
+{
+    memset(&stats, 0, sizeof(stats));
+    stats.windowStart = DWT->CYCCNT;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_rateGet()
+*//**
+*\b Description:
+ * This function is used to get the samples/s of all devices over the 
+ * window started by the last SENSORS_statsReset. The window is timed with
+ * the DWT cycle counter, which wraps after 2^32 HCLK cycles: about 53 s at
+ * 80 MHz, so the window is reset more often than that.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ *
+ * POST-CONDITION: The sample rate is returned. <br>
+ *
+ * @return  The samples per second, 0 when no cycle has elapsed.
+ *
+ * \b Example:
+ * @code
+ * SENSORS_statsReset();
+ * // acquire for a while
+ * uint32_t rate = SENSORS_rateGet();
+ * @endcode
+ *
+ * @see SENSORS_statsGet
+ * @see SENSORS_statsReset
+ *
+*****************************************************************************/
+uint32_t SENSORS_rateGet(void)
+{
+    const uint32_t elapsed = DWT->CYCCNT - stats.windowStart;
+
+    return (elapsed > 0U) ? 
+    (uint32_t)(((uint64_t)stats.samples * CLOCK_hclkGet()) / elapsed) : 0U;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_drainStampGet()
+*//**
+*\b Description:
+ * This function is used to get the DWT cycle at which the FIFO_STATUS read
+ * that sized the last drain of a device started. Every sample of that 
+ * drain was ready by then and the device produces one per output data 
+ * rate period, so the sample n places before the newest one was ready 
+ * about n periods earlier. A sink uses it to time each sample it receives
+ * from the moment it was ready rather than from the interrupt.
+ *
+ * PRE-CONDITION: SENSORS_init must be called. <br>
+ * PRE-CONDITION: The Device is below ADXL345_DEVICES_NUMBER. <br>
+ *
+ * POST-CONDITION: The cycle count is returned. <br>
+ *
+ * @param[in]   Device is the device drained.
+ *
+ * @return  The CYCCNT value at the start of the FIFO_STATUS read.
+ *
+ * \b Example:
+ * @code
+ * // In the sink, the oldest of count samples
+ * uint32_t age = DWT->CYCCNT - SENSORS_drainStampGet(Device) + 
+ * (count - 1U) * period;
+ * @endcode
+ *
+ * @see SENSORS_poll
+ * @see SENSORS_start
+ *
+*****************************************************************************/
+uint32_t SENSORS_drainStampGet(uint8_t Device)
+{
+    /* Prevent to read out of the range of the devices*/
+    assert(Device < ADXL345_DEVICES_NUMBER);
+
+    return drainStamp[Device];
+}
+
+/*****************************************************************************
+ * Function: SENSORS_turnEnd()
+*//**
+*\b Description:
+ * This function is used to close the turn of a device on its bus. The 
+ * round-robin moves to the next device of the bus and the counters are 
+ * updated with the samples and the SPI frames of the turn.
+ *
+ * @param[in]   channel is the SPI channel.
+ * @param[in]   device is the device served.
+ * @param[in]   count is the number of samples drained.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SENSORS_turnEnd(uint8_t channel, uint8_t device, uint8_t count)
+{
+    busNext[channel]++;
+    if(busNext[channel] >= busSize[channel])
+    {
+        busNext[channel] = 0;
+    }
+
+    stats.busFrames[channel] += STATUS_READ_FRAMES + 
+    ((uint32_t)count * SAMPLE_READ_FRAMES);
+    stats.deviceSamples[device] += count;
+    stats.samples += count;
+}
+
+/*****************************************************************************
+ * Function: SENSORS_dmaComplete()
+*//**
+*\b Description:
+ * This function is called from the DMA completion interrupt of a bus. It 
+ * chains the next read of the acquisition: the FIFO_STATUS read gives the
+ * number of samples to pop, and each sample read stores one sample until
+ * the FIFO is drained. The bus is then flagged as ready. A failed read 
+ * ends the turn with the samples already stored, the sample it popped is 
+ * dropped and counted by the ADXL345 driver.
+ *
+ * @param[in]   Config is the device whose read completed.
+ * @param[in]   Status is the result of the read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void SENSORS_dmaComplete(const Adxl345Config_t * const Config, 
+SpiStatus_t Status)
+{
+    const uint8_t channel = (uint8_t)Config->Channel;
+    SensorsBus_t * const Bus = &bus[channel];
+
+    if(Status != SPI_OK)
+    {
+        /*The frames are not valid, stop draining the FIFO*/
+        Bus->entries = Bus->count;
+    }
+    else if(Bus->state == BUS_STATUS)
+    {
+        Bus->entries = (uint8_t)(Bus->frames[0] & FIFO_ENTRIES_MASK);
+        Bus->state = BUS_SAMPLES;
+    }
+    else
+    {
+        /*Merge the low and high byte of each axis*/
+        Adxl345Sample_t * const Sample = &Bus->samples[Bus->count];
+        Sample->x = (int16_t)(Bus->frames[0] | (Bus->frames[1] << 8));
+        Sample->y = (int16_t)(Bus->frames[2] | (Bus->frames[3] << 8));
+        Sample->z = (int16_t)(Bus->frames[4] | (Bus->frames[5] << 8));
+        Bus->count++;
+    }
+
+    /*Each read of the data registers pops one sample from the FIFO, a read
+    that fails to start ends the turn with the samples already stored*/
+    if((Bus->count < Bus->entries) && 
+    (ADXL345_readDma(Config, DATA_START_R, AXIS_BYTES, &Bus->frames[0], 
+    SENSORS_dmaComplete) == SPI_OK))
+    {
+        return;
+    }
+
+    Bus->state = BUS_DONE;
+    readyMask |= (uint8_t)(1U << channel);
+}
@@ -0,0 +1,129 @@
+/**
+ * @file sensors_cfg.c
+ * @author Jose Luis Figueroa
+ * @brief This module contains the implementation for the ADXL345 device 
+ * table configuration.
+ * @version 1.0
+ * @date 2026-10-16
+ * 
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ * 
+ */
+
+/*****************************************************************************
+* Module Includes
+*****************************************************************************/
+#include "sensors_cfg.h"
+ 
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+
+/*****************************************************************************
+* Module Preprocessor Macros
+*****************************************************************************/
+
+/*****************************************************************************
+* Module Typedefs
+*****************************************************************************/
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/**
+ * The following array contains the configuration data for each ADXL345 
+ * mounted on the board. Each row represents a single device and its row 
+ * index must match its Device field. Devices may share an SPI channel, as 
+ * long as each one has its own chip select pin configured as an output in
+ * the DIO table. This table is read in by SENSORS_init.
+*/
+const Adxl345Config_t SensorsConfig[] = 
+{
+    {
+        .Device = 0,
+        .Channel = SPI_CHANNEL1,
+        .Port = DIO_PA,
+        .Pin = DIO_PA4,
+        .Odr = ADXL345_ODR_3200HZ,
+        .Range = ADXL345_RANGE_4G,
+        .Resolution = ADXL345_10BIT,
+        .LowPower = 0,
+        .FifoMode = ADXL345_FIFO_STREAM,
+        .Watermark = 16,
+        .IntEnable = INT_WATERMARK,
+        .IntMap = 0
+    },
+};
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+/*****************************************************************************
+ * Function: SENSORS_configGet()
+*//**
+*\b Description:
+ * This function is used to initialize the sensors based on the 
+ * configuration table defined in sensors_cfg module.
+ * 
+ * PRE-CONDITION: configuration table needs to be populated (sizeof > 0) <br>
+ * 
+ * POST-CONDITION: A constant pointer to the first member of the  
+ * configuration table will be returned.<br>
+ * 
+ * @return A pointer to the configuration table. <br>
+ * 
+ * \b Example: 
+ * @code
+ * const Adxl345Config_t * const SensorsConfig = SENSORS_configGet();
+ * size_t configSize = SENSORS_configSizeGet();
+ * 
+ * SENSORS_init(SensorsConfig, configSize);
+ * @endcode
+ * 
+ * @see SENSORS_configGet
+ * @see SENSORS_configSizeGet
+ * @see SENSORS_init
+ * 
+*****************************************************************************/
+const Adxl345Config_t * const SENSORS_configGet(void)
+{
+   /* The cast is performed to ensure that the address of the first element 
+    * of configuration table is returned as a constant pointer and not a
+    * pointer that can be modified
+   */
+  return (const Adxl345Config_t*)&SensorsConfig[0];
+}
+
+/*****************************************************************************
+ * Function: SENSORS_configSizeGet()
+*//**
+*\b Description:
+ * This function is used to get the size of the configuration table.
+ * 
+ * PRE-CONDITION: configuration table needs to be populated (sizeof > 0) <br>
+ * 
+ * POST-CONDITION: The size of the configuration table will be returned. <br>
+ * 
+ * @return The size of the configuration table.
+ * 
+ * \b Example: 
+ * @code
+ * const Adxl345Config_t * const SensorsConfig = SENSORS_configGet();
+ * size_t configSize = SENSORS_configSizeGet();
+ * 
+ * SENSORS_init(SensorsConfig, configSize);
+ * @endcode
+ * 
+ * @see SENSORS_configGet
+ * @see SENSORS_configSizeGet
+ * @see SENSORS_init
+ * 
+*****************************************************************************/
+size_t SENSORS_configSizeGet(void)
+{
+   return sizeof(SensorsConfig)/sizeof(SensorsConfig[0]);
+}
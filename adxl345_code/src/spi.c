@@ -12,10 +12,20 @@
 * Includes
 *****************************************************************************/
 #include "spi.h"
+#include "clock.h"
+#include "probe.h"
 
 /*****************************************************************************
 * Module Preprocessor Constants
 *****************************************************************************/
+/** Frames in flight while transceiving: one shifting, one buffered*/
+#define TRANSCEIVE_IN_FLIGHT (2U)
+/** DMA stream interrupt flags (FEIF, DMEIF, TEIF, HTIF, TCIF)*/
+#define DMA_STREAM_FLAGS    (0x3DUL)
+/** DMA stream transfer complete interrupt flag*/
+#define DMA_STREAM_TCIF     (0x20UL)
+/** DMA stream transfer error interrupt flag*/
+#define DMA_STREAM_TEIF     (0x08UL)
 
 /*****************************************************************************
 * Module Preprocessor Macros
@@ -24,6 +34,55 @@
 /*****************************************************************************
 * Module Typedefs
 *****************************************************************************/
+/**
+ * Defines the user of a channel. Blocking, DMA and queued operations share
+ * the data register, so the first one to take the channel keeps it until 
+ * it has completed and the others get SPI_BUSY.
+ */
+typedef enum
+{
+    SPI_OWNER_NONE,         /**< The channel is free */
+    SPI_OWNER_BLOCKING,     /**< A blocking transfer or transaction */
+    SPI_OWNER_DMA,          /**< A DMA operation */
+    SPI_OWNER_QUEUE         /**< The transactions of the queue */
+}SpiOwner_t;
+
+/**
+ * Defines a position in the frames of a transaction.
+ */
+typedef struct
+{
+    uint8_t segment;                /**< Segment of the frame */
+    uint16_t offset;                /**< Frame within the segment */
+}SpiCursor_t;
+
+/**
+ * Defines a slot of a channel queue: the copy of the descriptor and the 
+ * cycle count when it was enqueued.
+ */
+typedef struct
+{
+    SpiTransaction_t Transaction;   /**< Copy of the enqueued descriptor */
+    uint32_t stamp;                 /**< DWT cycle count at SPI_enqueue */
+}SpiQueueSlot_t;
+
+/**
+ * Defines the queue of a channel. The transaction at head is on the bus 
+ * while count is not zero.
+ */
+typedef struct
+{
+    SpiQueueSlot_t slot[SPI_QUEUE_DEPTH];   /**< Ring of transactions */
+    volatile uint8_t head;                  /**< Slot on the bus */
+    volatile uint8_t count;                 /**< Slots in use */
+    uint16_t total;                         /**< Frames of the transaction */
+    uint16_t txCount;                       /**< Frames written */
+    uint16_t rxCount;                       /**< Frames read */
+    uint32_t stamp;                         /**< DWT cycle count of the 
+                                                 last frame moved */
+    SpiCursor_t TxCursor;                   /**< Next frame to write */
+    SpiCursor_t RxCursor;                   /**< Next frame to read */
+}SpiQueue_t;
 
 /*****************************************************************************
 * Module Variable Definitions
@@ -56,9 +115,135 @@ static uint16_t volatile * const dataRegister[SPI_PORTS_NUMBER] =
     (uint16_t*)&SPI4->DR
 };
 
+/** Define an array of pointers to the DMA stream receiving for each SPI.
+ * SPI1 and SPI4 are served by DMA2, SPI2 and SPI3 only by DMA1.
+*/
+static DMA_Stream_TypeDef * const rxStream[SPI_PORTS_NUMBER] =
+{
+    DMA2_Stream2, DMA1_Stream3, DMA1_Stream0, DMA2_Stream0
+};
+
+/** Define an array of pointers to the DMA stream transmitting for each SPI*/
+static DMA_Stream_TypeDef * const txStream[SPI_PORTS_NUMBER] =
+{
+    DMA2_Stream3, DMA1_Stream4, DMA1_Stream5, DMA2_Stream1
+};
+
+/** Define the DMA request channel (CHSEL) of the SPI streams*/
+static const uint32_t dmaChannel[SPI_PORTS_NUMBER] =
+{
+    (3UL << DMA_SxCR_CHSEL_Pos), (0UL << DMA_SxCR_CHSEL_Pos),
+    (0UL << DMA_SxCR_CHSEL_Pos), (4UL << DMA_SxCR_CHSEL_Pos)
+};
+
+/** Define an array of pointers to the interrupt status register of the 
+ * receive streams
+*/
+static uint32_t volatile * const rxFlagStatus[SPI_PORTS_NUMBER] =
+{
+    &DMA2->LISR, &DMA1->LISR, &DMA1->LISR, &DMA2->LISR
+};
+
+/** Define an array of pointers to the interrupt flag clear register of the
+ * receive streams
+*/
+static uint32_t volatile * const rxFlagClear[SPI_PORTS_NUMBER] =
+{
+    &DMA2->LIFCR, &DMA1->LIFCR, &DMA1->LIFCR, &DMA2->LIFCR
+};
+
+/** Define an array of pointers to the interrupt flag clear register of the
+ * transmit streams
+*/
+static uint32_t volatile * const txFlagClear[SPI_PORTS_NUMBER] =
+{
+    &DMA2->LIFCR, &DMA1->HIFCR, &DMA1->HIFCR, &DMA2->LIFCR
+};
+
+/** Define the position of the receive stream flags on its ISR/IFCR*/
+static const uint8_t rxFlagShift[SPI_PORTS_NUMBER] = {16U, 22U, 0U, 0U};
+
+/** Define the position of the transmit stream flags on its ISR/IFCR*/
+static const uint8_t txFlagShift[SPI_PORTS_NUMBER] = {22U, 0U, 6U, 6U};
+
+/** Define the interrupt of the receive streams*/
+static const IRQn_Type rxStreamIrq[SPI_PORTS_NUMBER] =
+{
+    DMA2_Stream2_IRQn, DMA1_Stream3_IRQn, DMA1_Stream0_IRQn, 
+    DMA2_Stream0_IRQn
+};
+
+/** Completion callback registered for each channel*/
+static SpiCallback_t dmaCallback[SPI_PORTS_NUMBER];
+
+/** Frame transmitted while receiving through DMA*/
+static uint16_t dmaDummyTx;
+
+/** Frames discarded while transmitting through DMA*/
+static uint16_t dmaDummyRx[SPI_PORTS_NUMBER];
+
+/** Defines an array of the SPI global interrupts*/
+static const IRQn_Type spiIrq[SPI_PORTS_NUMBER] =
+{
+    SPI1_IRQn, SPI2_IRQn, SPI3_IRQn, SPI4_IRQn
+};
+
+/** Budget of every wait on a status flag of each channel, in CPU cycles*/
+static uint32_t timeoutCycles[SPI_PORTS_NUMBER] =
+{
+    SPI_TIMEOUT_CYCLES, SPI_TIMEOUT_CYCLES, SPI_TIMEOUT_CYCLES, 
+    SPI_TIMEOUT_CYCLES
+};
+
+/** Fault counters of each channel*/
+static SpiFaultStats_t faultStats[SPI_PORTS_NUMBER];
+
+/** Channels whose NSS output frames the transactions (SSOE with SPE gating)*/
+static uint8_t nssHardware[SPI_PORTS_NUMBER];
+
+/** Transaction queue of each channel*/
+static SpiQueue_t queue[SPI_PORTS_NUMBER];
+
+/** Sizing metrics of each channel queue*/
+static SpiQueueStats_t queueStats[SPI_PORTS_NUMBER];
+
+/** User of each channel*/
+static volatile SpiOwner_t channelOwner[SPI_PORTS_NUMBER];
+
+#ifdef PROBE_ENABLE
+/** Cycle count of the chip select assert of each channel*/
+static uint32_t selectStamp[SPI_PORTS_NUMBER];
+#endif
+
 /*****************************************************************************
 * Function Prototypes
 *****************************************************************************/
+static void SPI_dmaStart(SpiChannel_t Channel, const uint16_t *txData,
+uint32_t txIncrement, uint16_t *rxData, uint32_t rxIncrement, uint16_t size);
+static void SPI_dmaIrqHandler(SpiChannel_t Channel);
+static SpiStatus_t SPI_transactionRun(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction);
+static SpiStatus_t SPI_faultCheck(SpiChannel_t Channel, uint16_t flags, 
+uint16_t faults, uint32_t start);
+static SpiStatus_t SPI_waitFlag(SpiChannel_t Channel, uint16_t flag, 
+uint16_t state, uint16_t faults);
+static void SPI_queueStart(SpiChannel_t Channel);
+static void SPI_queueFinish(SpiChannel_t Channel, SpiStatus_t Status);
+static void SPI_queueStallCheck(SpiChannel_t Channel);
+static uint8_t SPI_acquire(SpiChannel_t Channel, SpiOwner_t Owner);
+static void SPI_release(SpiChannel_t Channel);
+static uint16_t SPI_segmentsSize(const SpiTransaction_t * const Transaction);
+static void SPI_cursorAdvance(const SpiTransaction_t * const Transaction, 
+SpiCursor_t * const Cursor, uint16_t step);
+static void SPI_delay(uint32_t cycles);
+static void SPI_nssAssert(SpiChannel_t Channel);
+static void SPI_nssRelease(SpiChannel_t Channel);
+static void SPI_select(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction);
+static void SPI_deselect(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction);
+static void SPI_queueIrqHandler(SpiChannel_t Channel);
+static uint32_t SPI_pclkGet(SpiChannel_t Channel);
 
 /*****************************************************************************
 * Function Definitions
@@ -68,9 +253,11 @@ static uint16_t volatile * const dataRegister[SPI_PORTS_NUMBER] =
 *//**
 *\b Description:
  * This function is used to initialize the SPI based on the configuration  
- * table defined in spi_cfg module.
+ * table defined in spi_cfg module. The control registers of each row are 
+ * reduced at compile time, so each register is written once.
  * 
  * PRE-CONDITION: The MCU clocks must be configured and enabled. <br>
+ * PRE-CONDITION: CLOCK_init is called first when MaxBitRate is used. <br>
  * PRE-CONDITION: SPI pins should be configured using GPIO driver. <br>
  * PRE-CONDITION: Configuration table needs to be populated (sizeof > 0) <br>
  * PRE-CONDITION: The setting is within the maximum values (SPI_MAX). <br>
@@ -97,7 +284,7 @@ static uint16_t volatile * const dataRegister[SPI_PORTS_NUMBER] =
  * @see SPI_Transfer
  * @see SPI_RegisterWrite
  * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
+ * @see SPI_callbackRegister
  * 
 *****************************************************************************/
 void SPI_init(const SpiConfig_t * const Config, size_t configSize)
@@ -109,170 +296,44 @@ void SPI_init(const SpiConfig_t * const Config, size_t configSize)
          * The registers arrays are limited to the SPI_PORTS_NUMBER, higher 
          * value can cause a memory violation.
         */
-       assert(Config[i].Channel < SPI_MAX_CHANNEL);
-
-        /**Set the configuration of the SPI on the control register 1*/
-        /**Set the Clock phase and polarity modes*/
-        if(Config[i].Mode == SPI_MODE0)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_CPHA;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_CPOL;
-        } 
-        else if(Config[i].Mode == SPI_MODE1)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_CPHA;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_CPOL;
-        }
-        else if(Config[i].Mode == SPI_MODE2)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_CPHA;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_CPOL;
-        }
-        else if(Config[i].Mode == SPI_MODE3)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_CPHA;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_CPOL;
-        }
-        else
-        {
-            assert(Config[i].Mode < SPI_MAX_MODE);
-        }
-
-        /**Set the hierarchy of the device*/
-        if(Config[i].Hierarchy == SPI_MASTER)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_MSTR;
-        }
-        else if(Config[i].Hierarchy == SPI_SLAVE)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_MSTR;
-        } 
-        else
-        {
-            assert(Config[i].Hierarchy < SPI_MAX_HIERARCHY);
-        }
-
-        /**Set the baud rate of the device*/
-        if(Config[i].BaudRate == SPI_FPCLK2)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK4)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK8)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK16)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK32)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK64)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK128)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_2;
-        }
-        else if(Config[i].BaudRate == SPI_FPCLK256)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_0;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_1;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_BR_2;
-        }
-        else
-        {
-            assert(Config[i].BaudRate < SPI_MAX_FPCLK);
-        }
-
-        /**Set the slave select pin management for the device*/
-        if(Config[i].SlaveSelect == SPI_SOFTWARE_NSS)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_SSM;
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_SSI;
-        }
-        else if(Config[i].SlaveSelect == SPI_HARDWARE_NSS_ENABLED)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_SSM;
-            *controlRegister2[Config[i].Channel] |= SPI_CR2_SSOE;
-        }
-        else if(Config[i].SlaveSelect == SPI_HARDWARE_NSS_DISABLED)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_SSM;
-            *controlRegister2[Config[i].Channel] &=~ SPI_CR2_SSOE;
-        }
-        else
-        {
-            assert(Config[i].SlaveSelect < SPI_MAX_NSS);
-        }
+        assert(Config[i].Channel < SPI_MAX_CHANNEL);
+        /* Prevent a row whose images do not match its settings, the table 
+         * is expected to come from SPI_CONFIG_TABLE
+        */
+        assert(Config[i].Cr1Image == SPI_CR1_IMAGE(Config[i].Mode, 
+        Config[i].Hierarchy, Config[i].BaudRate, Config[i].SlaveSelect, 
+        Config[i].FrameFormat, Config[i].TypeTransfer, Config[i].DataSize));
+        assert(Config[i].Cr2Image == SPI_CR2_IMAGE(Config[i].SlaveSelect));
 
-        /**Set the frame format of the device*/
-        if(Config[i].FrameFormat == SPI_MSB)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_LSBFIRST;
-        }
-        else if(Config[i].FrameFormat == SPI_LSB)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_LSBFIRST;
-        }
-        else
-        {
-            assert(Config[i].FrameFormat < SPI_MAX_FF);
-        }
+        const SpiChannel_t Channel = Config[i].Channel;
+        uint16_t cr1 = Config[i].Cr1Image;
 
-        /**Set the data transfer type of the device*/
-        if(Config[i].TypeTransfer == SPI_RECEIVE_MODE)
+        /**A bit rate limit selects the fastest prescaler of the running bus
+         * clock that stays within it*/
+        if(Config[i].MaxBitRate > 0U)
         {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_RXONLY;
-        }
-        else if(Config[i].TypeTransfer == SPI_FULL_DUPLEX)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_RXONLY;
-        }
-        else
-        {
-            assert(Config[i].TypeTransfer < SPI_MAX_DF);
+            cr1 = (uint16_t)((cr1 &~ SPI_CR1_BR) | 
+            ((uint32_t)SPI_baudRateSelect(Channel, Config[i].MaxBitRate) << 
+            SPI_CR1_BR_Pos));
         }
 
-        /**Set the data frame format (size) of the device*/
-        if(Config[i].DataSize == SPI_8BITS)
-        {
-            *controlRegister1[Config[i].Channel] &=~ SPI_CR1_DFF;
-        }
-        else if(Config[i].DataSize == SPI_16BITS)
-        {
-            *controlRegister1[Config[i].Channel] |= SPI_CR1_DFF;
-        }
-        else
+        /**The master drives NSS low while SPE is set, so a hardware NSS 
+         * channel is enabled for each transaction instead*/
+        nssHardware[Channel] = ((Config[i].Cr2Image & SPI_CR2_SSOE) && 
+        (cr1 & SPI_CR1_MSTR)) ? 1U : 0U;
+        if(!nssHardware[Channel])
         {
-            assert(Config[i].DataSize < SPI_MAX_BITS);
+            cr1 |= SPI_CR1_SPE;
         }
 
-        /**Enable the SPI module*/
-        *controlRegister1[Config[i].Channel] |= SPI_CR1_SPE;
+        /**Commit each control register with a single store*/
+        *controlRegister2[Channel] = Config[i].Cr2Image;
+        *controlRegister1[Channel] = cr1;
     }
 
+    /**Start the cycle counter that times the queued transactions*/
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 /*****************************************************************************
@@ -295,7 +356,8 @@ void SPI_init(const SpiConfig_t * const Config, size_t configSize)
  * @param[in] SpiTransferConfig A pointer to a structure containing the
  * channel, size, and data to be read.
  * 
- * @return  void
+ * @return  SPI_OK, the fault or timeout that stopped the frames, or 
+ *          SPI_BUSY while the channel is used by its queue or by DMA.
  * 
  * \b Example:
  * @code
@@ -315,10 +377,10 @@ void SPI_init(const SpiConfig_t * const Config, size_t configSize)
  * @see SPI_Transfer
  * @see SPI_RegisterWrite
  * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
+ * @see SPI_callbackRegister
  * 
  ****************************************************************************/
-void SPI_transfer(const SpiTransferConfig_t * const TransferConfig)
+SpiStatus_t SPI_transfer(const SpiTransferConfig_t * const TransferConfig)
 {
     /* Prevent to assign a value out of the range of the channel*/
     assert(TransferConfig->Channel < SPI_MAX_CHANNEL);
@@ -327,32 +389,49 @@ void SPI_transfer(const SpiTransferConfig_t * const TransferConfig)
     /* Prevent to use an empty data transfer*/
     assert(TransferConfig->data != NULL);
 
-    for (uint16_t i = 0; i < TransferConfig->size; i++)
+    const SpiChannel_t Channel = TransferConfig->Channel;
+    SpiStatus_t result = SPI_OK;
+
+    if(!SPI_acquire(Channel, SPI_OWNER_BLOCKING))
+    {
+        return SPI_BUSY;
+    }
+
+    SPI_nssAssert(Channel);
+
+    /* The received frames are not read, so OVR is expected and not a fault*/
+    for (uint16_t i = 0; (i < TransferConfig->size) && (result == SPI_OK); i++)
     {
         /* Wait until TXE is set (buffer empty)*/
-        while(!(*statusRegister[TransferConfig->Channel] & SPI_SR_TXE))
+        result = SPI_waitFlag(Channel, SPI_SR_TXE, SPI_SR_TXE, SPI_SR_MODF);
+        if(result == SPI_OK)
         {
-            asm("nop");
+            *dataRegister[Channel] = TransferConfig->data[i];
         }
-        *dataRegister[TransferConfig->Channel] = TransferConfig->data[i];
     }
 
     /* Wait until TXE is set to ensure the bus is empty*/
-    while(!(*statusRegister[TransferConfig->Channel] & SPI_SR_TXE))
+    if(result == SPI_OK)
     {
-        asm("nop");
+        result = SPI_waitFlag(Channel, SPI_SR_TXE, SPI_SR_TXE, SPI_SR_MODF);
     }
 
     /* Wait until bus is not busy to reset*/
-    while(*statusRegister[TransferConfig->Channel] & SPI_SR_BSY)
+    if(result == SPI_OK)
     {
-        asm("nop");
+        result = SPI_waitFlag(Channel, SPI_SR_BSY, 0, SPI_SR_MODF);
     }
 
-    /* Clear OVR bit (Overrun flag) in case of error*/
+    /* Clear OVR bit (Overrun flag) left by the frames not read*/
     uint16_t clearingFlag;
-    clearingFlag = *dataRegister[TransferConfig->Channel];
-    clearingFlag = *statusRegister[TransferConfig->Channel];
+    clearingFlag = *dataRegister[Channel];
+    clearingFlag = *statusRegister[Channel];
+    (void)clearingFlag;
+
+    SPI_nssRelease(Channel);
+    SPI_release(Channel);
+
+    return result;
 }
 
 /*****************************************************************************
@@ -375,7 +454,8 @@ void SPI_transfer(const SpiTransferConfig_t * const TransferConfig)
  * @param[in] SpiTransferConfig A pointer to a structure containing the 
  * channel, size, and data to be read.
  * 
- * @return  void
+ * @return  SPI_OK, the fault or timeout that stopped the frames, or 
+ *          SPI_BUSY while the channel is used by its queue or by DMA.
  * 
  * \b Example:
  * @code
@@ -395,10 +475,10 @@ void SPI_transfer(const SpiTransferConfig_t * const TransferConfig)
  * @see SPI_Transfer
  * @see SPI_RegisterWrite
  * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
+ * @see SPI_callbackRegister
  * 
  ****************************************************************************/
-void SPI_receive(const SpiTransferConfig_t * const TransferConfig)
+SpiStatus_t SPI_receive(const SpiTransferConfig_t * const TransferConfig)
 {
     /* Prevent to assign a value out of the range of the channel*/
     assert(TransferConfig->Channel < SPI_MAX_CHANNEL);
@@ -407,97 +487,1961 @@ void SPI_receive(const SpiTransferConfig_t * const TransferConfig)
     /* Prevent to use an empty data transfer*/
     assert(TransferConfig != NULL);
 
-    for (uint8_t i = 0; i < TransferConfig->size; i++)
+    const SpiChannel_t Channel = TransferConfig->Channel;
+    SpiStatus_t result = SPI_OK;
+
+    if(!SPI_acquire(Channel, SPI_OWNER_BLOCKING))
+    {
+        return SPI_BUSY;
+    }
+
+    SPI_nssAssert(Channel);
+
+    for (uint8_t i = 0; (i < TransferConfig->size) && (result == SPI_OK); i++)
     {
         /* Send dummy data (Recommended).*/
-        *dataRegister[TransferConfig->Channel] = 0;
+        *dataRegister[Channel] = 0;
         /* Wait for RXNE flag to be sent*/
-        while(!(*statusRegister[TransferConfig->Channel] & SPI_SR_RXNE))
+        result = SPI_waitFlag(Channel, SPI_SR_RXNE, SPI_SR_RXNE, 
+        SPI_SR_MODF | SPI_SR_OVR);
+        if(result == SPI_OK)
         {
-            asm("nop");
+            /* Read the data*/
+            TransferConfig->data[i] = *dataRegister[Channel];
         }
-        /* Read the data*/
-        TransferConfig->data[i] = *dataRegister[TransferConfig->Channel];
     }
+
+    /* Wait until bus is not busy to reset*/
+    if(result == SPI_OK)
+    {
+        result = SPI_waitFlag(Channel, SPI_SR_BSY, 0, SPI_SR_MODF);
+    }
+
+    SPI_nssRelease(Channel);
+    SPI_release(Channel);
+
+    return result;
 }
 
 /*****************************************************************************
- * Function: SPI_registerWrite()
+ * Function: SPI_transceive()
 *//**
  *\b Description:
- * This function is used to directly address and modify a SPI register.
- * The function should be used to access specialized functionality in 
- * the SPI peripheral that is not exposed by any other function of the
- * interface.
+ * This function is used to exchange data on the SPI bus in a single pass.
+ * The next frame is written as soon as TXE is set while the received 
+ * frames are drained on RXNE, so the shift register is fed continuously 
+ * and back-to-back frames have no idle gaps. At most two frames are in 
+ * flight, which guarantees each frame is read before the next one 
+ * completes and no overrun occurs.
  * 
- * PRE-CONDITION: Address is within the boundaries of the SPI register
- * address space. <br>
+ * PRE-CONDITION: The MCU clocks must be configured and enabled. <br>
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: SpiTransceiveConfig_t needs to be populated. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The size is greater than 0. <br>
  * 
- * POST-CONDITION: The register located at address with be updated with
- * value. <br>
+ * POST-CONDITION: The frames are exchanged and the bus is idle. <br>
  * 
- * @param[in]   address is a register address within the SPI peripheral
- *              map.
- * @param[in]   value is the value to set the SPI register. 
+ * @param[in] TransceiveConfig A pointer to a structure containing the 
+ * channel, size, and the data to be sent and received.
  * 
- * @return void
+ * @return  SPI_OK, the fault or timeout that stopped the frames, or 
+ *          SPI_BUSY while the channel is used by its queue or by DMA.
  * 
- * \b Example
+ * \b Example:
  * @code
- *  SPI_registerWrite(0x1000, 0x15);
+ * uint16_t frames[] = {0xF2, 0, 0, 0, 0, 0, 0};
+ * SpiTransceiveConfig_t TransceiveConfig =
+ * {
+ *     .Channel = SPI_CHANNEL1,
+ *     .size = sizeof(frames)/sizeof(frames[0]),
+ *     .txData = frames,
+ *     .rxData = frames
+ * };
+ * SPI_transceive(&TransceiveConfig);
  * @endcode
  * 
- * @see SPI_configGet
- * @see SPI_configSizeGet
- * @see SPI_Init
- * @see SPI_Transfer
- * @see SPI_RegisterWrite
- * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
+ * @see SPI_transfer
+ * @see SPI_receive
+ * @see SPI_transceive
+ * @see SPI_transferDma
+ * @see SPI_receiveDma
  * 
-****************************************************************************/  
-void SPI_registerWrite(uint32_t address, uint32_t value)
+ ****************************************************************************/
+SpiStatus_t SPI_transceive(
+const SpiTransceiveConfig_t * const TransceiveConfig)
 {
-    volatile uint32_t * const registerPointer = (uint32_t*)address;
-    *registerPointer = value;
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(TransceiveConfig->Channel < SPI_MAX_CHANNEL);
+    /* Prevent to use an empty data size*/
+    assert(TransceiveConfig->size > 0);
+
+    const SpiChannel_t Channel = TransceiveConfig->Channel;
+    uint16_t volatile * const status = statusRegister[Channel];
+    uint16_t volatile * const data = dataRegister[Channel];
+    const uint16_t * const txData = TransceiveConfig->txData;
+    uint16_t * const rxData = TransceiveConfig->rxData;
+    const uint16_t size = TransceiveConfig->size;
+    uint16_t txCount = 0;
+    uint16_t rxCount = 0;
+    SpiStatus_t result = SPI_OK;
+
+    if(!SPI_acquire(Channel, SPI_OWNER_BLOCKING))
+    {
+        return SPI_BUSY;
+    }
+
+    /* Drop a stale frame and clear OVR so the first frame read is ours*/
+    uint16_t clearingFlag;
+    clearingFlag = *data;
+    clearingFlag = *status;
+    (void)clearingFlag;
+
+    SPI_nssAssert(Channel);
+
+    /* The budget restarts on every frame moved*/
+    uint32_t start = DWT->CYCCNT;
+
+    while((rxCount < size) && (result == SPI_OK))
+    {
+        const uint16_t flags = *status;
+
+        result = SPI_faultCheck(Channel, flags, SPI_SR_MODF | SPI_SR_OVR, 
+        start);
+
+        /* Feed the transmit buffer while the shift register is busy*/
+        if((result == SPI_OK) && (flags & SPI_SR_TXE) && (txCount < size) &&
+        ((uint16_t)(txCount - rxCount) < TRANSCEIVE_IN_FLIGHT))
+        {
+            *data = (txData != NULL) ? txData[txCount] : 0U;
+            txCount++;
+            start = DWT->CYCCNT;
+        }
+
+        /* Drain the received frame*/
+        if((result == SPI_OK) && (flags & SPI_SR_RXNE))
+        {
+            const uint16_t frame = *data;
+
+            if(rxData != NULL)
+            {
+                rxData[rxCount] = frame;
+            }
+            rxCount++;
+            start = DWT->CYCCNT;
+        }
+    }
+
+    /* Wait until bus is not busy so the caller can release the slave*/
+    if(result == SPI_OK)
+    {
+        result = SPI_waitFlag(Channel, SPI_SR_BSY, 0, SPI_SR_MODF);
+    }
+
+    SPI_nssRelease(Channel);
+    SPI_release(Channel);
+
+    return result;
 }
 
 /*****************************************************************************
- * Function: SPI_registerRead()
+ * Function: SPI_transaction()
 *//**
  *\b Description:
- * This function is used to directly address a SPI register. The 
- * function should be used to access specialized functionality in the 
- * SPI peripheral that is not exposed by any other function of the 
- * interface.
+ * This function is used to run a scatter-gather transaction on the SPI bus.
+ * The chip select is driven by this function: it is asserted, the setup 
+ * gap is waited, the frames of every segment are clocked back to back with
+ * at most two frames in flight, so there is no idle time between an 
+ * address segment and a data segment, and the chip select is released 
+ * once the bus is idle and the hold gap has elapsed. A timeout, overrun 
+ * or mode fault aborts the attempt. A repeatable transaction is then 
+ * restarted up to SPI_RETRY_MAX times, any other one returns the fault at
+ * once since its frames may already have changed the slave state.
  * 
- * PRE-CONDITION: Address is within the boundaries of the SPI register 
- * address space. <br>
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The transaction has at least one frame. <br>
  * 
- * POST-CONDITION: The value stored in the register is returned to the 
- * caller. <br>
+ * POST-CONDITION: The chip select is released. On SPI_OK the frames are 
+ * exchanged and the callback, if any, has been called. <br>
  * 
- * @param[in]   address is the address of the SPI register to read.
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Transaction is the descriptor of the transaction.
  * 
- * @return  The current value of the SPI register.
+ * @return  SPI_OK, the fault of the last attempt, or SPI_BUSY while the
+ *          channel is used by its queue or by DMA.
  * 
  * \b Example:
  * @code
- * type spiValue = SPI_registerRead(0x1000);
+ * const uint16_t address = 0xF2;
+ * uint16_t axes[6];
+ * const SpiSegment_t Segments[] =
+ * {
+ *     {.txData = &address, .rxData = NULL, .size = 1},
+ *     {.txData = NULL, .rxData = axes, .size = 6}
+ * };
+ * const SpiTransaction_t Transaction =
+ * {
+ *     .Port = DIO_PA,
+ *     .Pin = DIO_PA4,
+ *     .Segments = Segments,
+ *     .segmentCount = 2
+ * };
+ * SPI_transaction(SPI_CHANNEL1, &Transaction);
  * @endcode
  * 
- * @see SPI_configGet
- * @see SPI_configSizeGet
- * @see SPI_Init
- * @see SPI_Transfer
- * @see SPI_RegisterWrite
- * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
- *
+ * @see SPI_transceive
+ * @see SPI_transaction
+ * @see SPI_enqueue
+ * 
  ****************************************************************************/
-uint16_t SPI_registerRead(uint32_t address)
+SpiStatus_t SPI_transaction(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction)
 {
-    volatile uint16_t * const registerPointer = (uint16_t *)address;
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
 
-    return *registerPointer;
-}
\ No newline at end of file
+    if(!SPI_acquire(Channel, SPI_OWNER_BLOCKING))
+    {
+        return SPI_BUSY;
+    }
+
+    PROBE_STAMP(start);
+    SpiStatus_t result = SPI_transactionRun(Channel, Transaction);
+
+    /* The faults are cleared by then, restart the whole transaction*/
+    for(uint8_t retry = 0; (result != SPI_OK) && Transaction->repeatable &&
+    (retry < SPI_RETRY_MAX); retry++)
+    {
+        faultStats[Channel].retries++;
+        result = SPI_transactionRun(Channel, Transaction);
+    }
+
+    SPI_release(Channel);
+
+    if((result == SPI_OK) && (Transaction->Callback != NULL))
+    {
+        Transaction->Callback(Channel, Transaction, result);
+    }
+
+    PROBE_RECORD(PROBE_SPI_TRANSACTION, start);
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: SPI_transferDma()
+*//**
+ *\b Description:
+ * This function is used to start a data transfer on the SPI bus through 
+ * DMA. The function returns once the streams are armed, the frames are 
+ * shifted out without CPU intervention and the callback registered for the
+ * channel is called when the last frame has been clocked. The received 
+ * frames are discarded.
+ * 
+ * PRE-CONDITION: The MCU clocks must be configured and enabled, including 
+ * the DMA controller serving the channel. <br>
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: SpiTransferConfig_t needs to be populated. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The size is greater than 0. <br>
+ * PRE-CONDITION: The data is not NULL and stays valid until completion. <br>
+ * 
+ * POST-CONDITION: The DMA transfer is started. <br>
+ * 
+ * @param[in] SpiTransferConfig A pointer to a structure containing the
+ * channel, size, and data to be sent.
+ * 
+ * @return  SPI_OK when the operation is started, or SPI_BUSY while the
+ *          previous DMA operation of the channel is in progress.
+ * 
+ * \b Example:
+ * @code
+ * static uint16_t data[] = {0x56, 0x12};
+ * SpiTransferConfig_t TransferConfig =
+ * {
+ *     .Channel = SPI_CHANNEL1,
+ *     .size = sizeof(data)/sizeof(data[0]),
+ *     .data = data
+ * };
+ * SPI_callbackRegister(SPI_CHANNEL1, transferDone);
+ * SPI_transferDma(&TransferConfig);
+ * @endcode
+ * 
+ * @see SPI_transfer
+ * @see SPI_receive
+ * @see SPI_transferDma
+ * @see SPI_receiveDma
+ * @see SPI_callbackRegister
+ * 
+ ****************************************************************************/
+SpiStatus_t SPI_transferDma(const SpiTransferConfig_t * const TransferConfig)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(TransferConfig->Channel < SPI_MAX_CHANNEL);
+    /* Prevent to use an empty data size*/
+    assert(TransferConfig->size > 0);
+    /* Prevent to use an empty data transfer*/
+    assert(TransferConfig->data != NULL);
+
+    const SpiStatus_t result = SPI_dmaAcquire(TransferConfig->Channel);
+    if(result != SPI_OK)
+    {
+        return result;
+    }
+
+    /* Transmit from the buffer and sink the received frames*/
+    SPI_dmaStart(TransferConfig->Channel, TransferConfig->data, 
+    DMA_SxCR_MINC, &dmaDummyRx[TransferConfig->Channel], 0, 
+    TransferConfig->size);
+
+    return SPI_OK;
+}
+
+/*****************************************************************************
+ * Function: SPI_receiveDma()
+*//**
+ *\b Description:
+ * This function is used to start a data reception on the SPI bus through
+ * DMA. Dummy frames are sent to clock the slave and the received frames 
+ * are written to the buffer without CPU intervention. The callback 
+ * registered for the channel is called when the last frame is stored.
+ * 
+ * PRE-CONDITION: The MCU clocks must be configured and enabled, including 
+ * the DMA controller serving the channel. <br>
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: SpiTransferConfig_t needs to be populated. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The size is greater than 0. <br>
+ * PRE-CONDITION: The data is not NULL and stays valid until completion. <br>
+ * 
+ * POST-CONDITION: The DMA reception is started. <br>
+ * 
+ * @param[in] SpiTransferConfig A pointer to a structure containing the 
+ * channel, size, and data to be read.
+ * 
+ * @return  SPI_OK when the operation is started, or SPI_BUSY while the
+ *          previous DMA operation of the channel is in progress.
+ * 
+ * \b Example:
+ * @code
+ * static uint16_t rxdata[6];
+ * SpiTransferConfig_t ReceiveConfig =
+ * {
+ *     .Channel = SPI_CHANNEL1,
+ *     .size = sizeof(rxdata)/sizeof(rxdata[0]),
+ *     .data = rxdata
+ * };
+ * SPI_callbackRegister(SPI_CHANNEL1, receiveDone);
+ * SPI_receiveDma(&ReceiveConfig);
+ * @endcode
+ * 
+ * @see SPI_transfer
+ * @see SPI_receive
+ * @see SPI_transferDma
+ * @see SPI_receiveDma
+ * @see SPI_callbackRegister
+ * 
+ ****************************************************************************/
+SpiStatus_t SPI_receiveDma(const SpiTransferConfig_t * const TransferConfig)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(TransferConfig->Channel < SPI_MAX_CHANNEL);
+    /* Prevent to use an empty data size*/
+    assert(TransferConfig->size > 0);
+    /* Prevent to use an empty data transfer*/
+    assert(TransferConfig->data != NULL);
+
+    const SpiStatus_t result = SPI_dmaAcquire(TransferConfig->Channel);
+    if(result != SPI_OK)
+    {
+        return result;
+    }
+
+    /* Transmit dummy frames and store the received frames*/
+    SPI_dmaStart(TransferConfig->Channel, &dmaDummyTx, 0, 
+    TransferConfig->data, DMA_SxCR_MINC, TransferConfig->size);
+
+    return SPI_OK;
+}
+
+/*****************************************************************************
+ * Function: SPI_transceiveDma()
+*//**
+ *\b Description:
+ * This function is used to start a full-duplex exchange on the SPI bus 
+ * through DMA. The frames of txData are sent and the received frames are 
+ * written to rxData without CPU intervention, so a register address and 
+ * its data are moved in one operation. Each channel has its own pair of 
+ * streams, so exchanges on different channels run at the same time. The 
+ * callback registered for the channel is called when the last frame is 
+ * stored.
+ * 
+ * PRE-CONDITION: The MCU clocks must be configured and enabled, including 
+ * the DMA controller serving the channel. <br>
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: SpiTransceiveConfig_t needs to be populated. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The size is greater than 0. <br>
+ * PRE-CONDITION: The buffers are not NULL and stay valid until completion.
+ * <br>
+ * 
+ * POST-CONDITION: The DMA exchange is started. <br>
+ * 
+ * @param[in] TransceiveConfig A pointer to a structure containing the 
+ * channel, size, and the data to be sent and received.
+ * 
+ * @return  SPI_OK when the operation is started, or SPI_BUSY while the
+ *          previous DMA operation of the channel is in progress.
+ * 
+ * \b Example:
+ * @code
+ * static const uint16_t txFrames[] = {0xF2, 0, 0, 0, 0, 0, 0};
+ * static uint16_t rxFrames[7];
+ * SpiTransceiveConfig_t TransceiveConfig =
+ * {
+ *     .Channel = SPI_CHANNEL1,
+ *     .size = sizeof(txFrames)/sizeof(txFrames[0]),
+ *     .txData = txFrames,
+ *     .rxData = rxFrames
+ * };
+ * SPI_callbackRegister(SPI_CHANNEL1, exchangeDone);
+ * SPI_transceiveDma(&TransceiveConfig);
+ * @endcode
+ * 
+ * @see SPI_transceive
+ * @see SPI_transferDma
+ * @see SPI_receiveDma
+ * @see SPI_transceiveDma
+ * @see SPI_dmaAcquire
+ * @see SPI_callbackRegister
+ * 
+ ****************************************************************************/
+SpiStatus_t SPI_transceiveDma(
+const SpiTransceiveConfig_t * const TransceiveConfig)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(TransceiveConfig->Channel < SPI_MAX_CHANNEL);
+    /* Prevent to use an empty data size*/
+    assert(TransceiveConfig->size > 0);
+    /* Prevent to use an empty data transfer*/
+    assert(TransceiveConfig->txData != NULL);
+    assert(TransceiveConfig->rxData != NULL);
+
+    const SpiStatus_t result = SPI_dmaAcquire(TransceiveConfig->Channel);
+    if(result != SPI_OK)
+    {
+        return result;
+    }
+
+    SPI_transceiveDmaStart(TransceiveConfig);
+
+    return SPI_OK;
+}
+
+/*****************************************************************************
+ * Function: SPI_dmaAcquire()
+*//**
+ *\b Description:
+ * This function is used to take a channel for a DMA exchange before the 
+ * caller prepares it. A driver that keeps per-channel state for the 
+ * completion, or drives a software chip select, takes the channel first 
+ * and only then writes its state and selects its slave, so a call that 
+ * finds the channel busy leaves the running operation untouched. The 
+ * exchange is started with SPI_transceiveDmaStart.
+ * 
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: On SPI_OK the channel is held for DMA until the 
+ * completion of the exchange started next. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  SPI_OK when the channel is taken, or SPI_BUSY while it is in 
+ *          use or a stream is still enabled.
+ * 
+ * \b Example:
+ * @code
+ * if(SPI_dmaAcquire(SPI_CHANNEL1) == SPI_OK)
+ * {
+ *     SPI_callbackRegister(SPI_CHANNEL1, exchangeDone);
+ *     SPI_transceiveDmaStart(&TransceiveConfig);
+ * }
+ * @endcode
+ * 
+ * @see SPI_transceiveDmaStart
+ * @see SPI_transceiveDma
+ * 
+ ****************************************************************************/
+SpiStatus_t SPI_dmaAcquire(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    if(!SPI_acquire(Channel, SPI_OWNER_DMA))
+    {
+        return SPI_BUSY;
+    }
+
+    /* Streams can only be configured while disabled, an enabled stream is
+     * still moving the frames of the previous operation*/
+    if((rxStream[Channel]->CR & DMA_SxCR_EN) || 
+    (txStream[Channel]->CR & DMA_SxCR_EN))
+    {
+        SPI_release(Channel);
+        return SPI_BUSY;
+    }
+
+    return SPI_OK;
+}
+
+/*****************************************************************************
+ * Function: SPI_transceiveDmaStart()
+*//**
+ *\b Description:
+ * This function is used to start a full-duplex DMA exchange on a channel 
+ * taken with SPI_dmaAcquire. It behaves as SPI_transceiveDma once the 
+ * channel is taken and cannot fail.
+ * 
+ * PRE-CONDITION: SPI_dmaAcquire returned SPI_OK for the channel and no 
+ * exchange was started on it since. <br>
+ * PRE-CONDITION: SpiTransceiveConfig_t needs to be populated. <br>
+ * PRE-CONDITION: The size is greater than 0. <br>
+ * PRE-CONDITION: The buffers are not NULL and stay valid until completion.
+ * <br>
+ * 
+ * POST-CONDITION: The DMA exchange is started. <br>
+ * 
+ * @param[in] TransceiveConfig A pointer to a structure containing the 
+ * channel, size, and the data to be sent and received.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * if(SPI_dmaAcquire(SPI_CHANNEL1) == SPI_OK)
+ * {
+ *     SPI_transceiveDmaStart(&TransceiveConfig);
+ * }
+ * @endcode
+ * 
+ * @see SPI_dmaAcquire
+ * @see SPI_transceiveDma
+ * 
+ ****************************************************************************/
+void SPI_transceiveDmaStart(
+const SpiTransceiveConfig_t * const TransceiveConfig)
+{
+    const SpiChannel_t Channel = TransceiveConfig->Channel;
+
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+    /* Prevent to use an empty data size*/
+    assert(TransceiveConfig->size > 0);
+    /* Prevent to use an empty data transfer*/
+    assert(TransceiveConfig->txData != NULL);
+    assert(TransceiveConfig->rxData != NULL);
+    /* Prevent to start on a channel that was not taken for DMA*/
+    assert(channelOwner[Channel] == SPI_OWNER_DMA);
+    assert(!(rxStream[Channel]->CR & DMA_SxCR_EN));
+
+    /* Transmit from one buffer and store into the other*/
+    SPI_dmaStart(Channel, TransceiveConfig->txData, DMA_SxCR_MINC, 
+    TransceiveConfig->rxData, DMA_SxCR_MINC, TransceiveConfig->size);
+}
+
+/*****************************************************************************
+ * Function: SPI_callbackRegister()
+*//**
+ *\b Description:
+ * This function is used to register the function called when a DMA 
+ * operation on the channel completes. The callback runs in interrupt 
+ * context. Registering NULL removes the callback.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: The callback is assigned to the channel. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Callback is the function to call on completion.
+ * 
+ * @return void
+ * 
+ * \b Example
+ * @code
+ * void transferDone(SpiChannel_t Channel, SpiStatus_t Status)
+ * {
+ *     dataReady = (Status == SPI_OK);
+ * }
+ * SPI_callbackRegister(SPI_CHANNEL1, transferDone);
+ * @endcode
+ * 
+ * @see SPI_transferDma
+ * @see SPI_receiveDma
+ * @see SPI_callbackRegister
+ * 
+****************************************************************************/
+void SPI_callbackRegister(SpiChannel_t Channel, SpiCallback_t Callback)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    dmaCallback[Channel] = Callback;
+}
+
+/*****************************************************************************
+ * Function: SPI_enqueue()
+*//**
+ *\b Description:
+ * This function is used to queue a transaction on a channel without 
+ * waiting for the bus. The descriptor is copied into the channel ring, so 
+ * it may live on the caller stack while its segments must not, and the 
+ * transaction starts at once when the queue is empty. The frames are 
+ * moved by the SPI TXE and RXNE interrupts, the chip select is driven 
+ * around each transaction and the callback is called from interrupt 
+ * context once the bus is idle after the last frame. The queue owns the 
+ * channel while it is not empty, so blocking and DMA operations get 
+ * SPI_BUSY meanwhile. An overrun or mode fault aborts the transaction on 
+ * the bus through the SPI error interrupt, and a transaction that moved no
+ * frame within the channel budget is aborted by the next call that needs 
+ * the channel, SPI_enqueue or a blocking or DMA operation; the callback is
+ * called with the fault in both cases.
+ * 
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The transaction has at least one frame. <br>
+ * PRE-CONDITION: The segments and buffers stay valid until the callback is
+ * called. <br>
+ * 
+ * POST-CONDITION: The transaction is queued, or rejected on a full queue.
+ * <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Transaction is the descriptor of the transaction.
+ * 
+ * @return  1 when the transaction is queued, 0 when the queue is full or 
+ *          the channel is used by a blocking or DMA operation.
+ * 
+ * \b Example:
+ * @code
+ * static const uint16_t address = 0xF2;
+ * static uint16_t axes[6];
+ * static const SpiSegment_t Segments[] =
+ * {
+ *     {.txData = &address, .rxData = NULL, .size = 1},
+ *     {.txData = NULL, .rxData = axes, .size = 6}
+ * };
+ * SpiTransaction_t Transaction =
+ * {
+ *     .Port = DIO_PA,
+ *     .Pin = DIO_PA4,
+ *     .Segments = Segments,
+ *     .segmentCount = 2,
+ *     .Callback = axesDone
+ * };
+ * SPI_enqueue(SPI_CHANNEL1, &Transaction);
+ * @endcode
+ * 
+ * @see SPI_enqueue
+ * @see SPI_queueStatsGet
+ * @see SPI_queueStatsReset
+ * 
+ ****************************************************************************/
+uint8_t SPI_enqueue(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+    /* Prevent to queue an empty transaction*/
+    assert(SPI_segmentsSize(Transaction) > 0);
+
+    SpiQueue_t * const Queue = &queue[Channel];
+    SpiQueueStats_t * const Stats = &queueStats[Channel];
+    uint8_t queued = 0;
+
+    /* The interrupt handler pops the ring, mask it while pushing*/
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    SPI_queueStallCheck(Channel);
+
+    /* An empty queue takes the channel before its first transaction*/
+    if((Queue->count < SPI_QUEUE_DEPTH) && ((Queue->count > 0U) || 
+    SPI_acquire(Channel, SPI_OWNER_QUEUE)))
+    {
+        SpiQueueSlot_t * const Slot = 
+        &Queue->slot[(Queue->head + Queue->count) % SPI_QUEUE_DEPTH];
+
+        Slot->Transaction = *Transaction;
+        Slot->stamp = DWT->CYCCNT;
+        Queue->count++;
+
+        Stats->enqueued++;
+        Stats->depth = Queue->count;
+        if(Queue->count > Stats->maxDepth)
+        {
+            Stats->maxDepth = Queue->count;
+        }
+
+        /* An empty queue has no interrupt pending to start it*/
+        if(Queue->count == 1U)
+        {
+            SPI_queueStart(Channel);
+        }
+        queued = 1;
+    }
+    else
+    {
+        Stats->rejected++;
+    }
+
+    __set_PRIMASK(primask);
+
+    return queued;
+}
+
+/*****************************************************************************
+ * Function: SPI_queueStatsGet()
+*//**
+ *\b Description:
+ * This function is used to get the sizing metrics of a channel queue.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: A pointer to the metrics is returned. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  A pointer to the metrics of the channel queue.
+ * 
+ * \b Example:
+ * @code
+ * const SpiQueueStats_t * const Stats = SPI_queueStatsGet(SPI_CHANNEL1);
+ * uint32_t average = (uint32_t)(Stats->latencySum / Stats->completed);
+ * @endcode
+ * 
+ * @see SPI_enqueue
+ * @see SPI_queueStatsGet
+ * @see SPI_queueStatsReset
+ * 
+ ****************************************************************************/
+const SpiQueueStats_t * SPI_queueStatsGet(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    return &queueStats[Channel];
+}
+
+/*****************************************************************************
+ * Function: SPI_queueStatsReset()
+*//**
+ *\b Description:
+ * This function is used to clear the sizing metrics of a channel queue. 
+ * The current depth is kept.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: The counters and maxima are cleared. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * SPI_queueStatsReset(SPI_CHANNEL1);
+ * @endcode
+ * 
+ * @see SPI_enqueue
+ * @see SPI_queueStatsGet
+ * @see SPI_queueStatsReset
+ * 
+ ****************************************************************************/
+void SPI_queueStatsReset(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    const uint8_t depth = queueStats[Channel].depth;
+    queueStats[Channel] = (SpiQueueStats_t){0};
+    queueStats[Channel].depth = depth;
+    queueStats[Channel].maxDepth = depth;
+
+    __set_PRIMASK(primask);
+}
+
+/*****************************************************************************
+ * Function: SPI_hardwareNssGet()
+*//**
+ *\b Description:
+ * This function is used to know whether the NSS output of the channel 
+ * frames the transactions. On such a channel the peripheral is enabled for
+ * each transaction and disabled after it, which drives NSS low and 
+ * releases it aligned to the clock, and the chip select pin of the 
+ * transactions is not used.
+ * 
+ * PRE-CONDITION: SPI_Init must be called with valid configuration data. <br>
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: The NSS management of the channel is returned. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  1 for a master with SPI_HARDWARE_NSS_ENABLED, 0 otherwise.
+ * 
+ * \b Example:
+ * @code
+ * if(!SPI_hardwareNssGet(SPI_CHANNEL1))
+ * {
+ *     DIO_pinWrite(&CSLine, DIO_LOW);
+ * }
+ * @endcode
+ * 
+ * @see SPI_init
+ * @see SPI_transaction
+ * @see SPI_hardwareNssGet
+ * 
+ ****************************************************************************/
+uint8_t SPI_hardwareNssGet(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    return nssHardware[Channel];
+}
+
+/*****************************************************************************
+ * Function: SPI_timeoutSet()
+*//**
+ *\b Description:
+ * This function is used to set the budget of every wait on a status flag
+ * of a channel. A wait that runs out of budget ends the operation with 
+ * SPI_TIMEOUT instead of blocking the CPU.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: The waits of the channel are bounded by cycles. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   cycles is the budget in CPU cycles.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * SPI_timeoutSet(SPI_CHANNEL1, 8000);     // 100 us at 80 MHz
+ * @endcode
+ * 
+ * @see SPI_timeoutSet
+ * @see SPI_faultStatsGet
+ * @see SPI_faultStatsReset
+ * 
+ ****************************************************************************/
+void SPI_timeoutSet(SpiChannel_t Channel, uint32_t cycles)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    timeoutCycles[Channel] = cycles;
+}
+
+/*****************************************************************************
+ * Function: SPI_faultStatsGet()
+*//**
+ *\b Description:
+ * This function is used to get the fault counters of a channel, to report
+ * bus problems as telemetry.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: A pointer to the counters is returned. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  A pointer to the fault counters of the channel.
+ * 
+ * \b Example:
+ * @code
+ * const SpiFaultStats_t * const Faults = SPI_faultStatsGet(SPI_CHANNEL1);
+ * if(Faults->timeouts > 0U)
+ * {
+ *     // Report a sensor lost
+ * }
+ * @endcode
+ * 
+ * @see SPI_timeoutSet
+ * @see SPI_faultStatsGet
+ * @see SPI_faultStatsReset
+ * 
+ ****************************************************************************/
+const SpiFaultStats_t * SPI_faultStatsGet(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    return &faultStats[Channel];
+}
+
+/*****************************************************************************
+ * Function: SPI_faultStatsReset()
+*//**
+ *\b Description:
+ * This function is used to clear the fault counters of a channel.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: Every counter of the channel is zero. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ * \b Example:
+ * @code
+ * SPI_faultStatsReset(SPI_CHANNEL1);
+ * @endcode
+ * 
+ * @see SPI_timeoutSet
+ * @see SPI_faultStatsGet
+ * @see SPI_faultStatsReset
+ * 
+ ****************************************************************************/
+void SPI_faultStatsReset(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    faultStats[Channel] = (SpiFaultStats_t){0};
+}
+
+/*****************************************************************************
+ * Function: SPI_baudRateSelect()
+*//**
+ *\b Description:
+ * This function is used to select the fastest prescaler that keeps the 
+ * bit rate of a channel within a slave limit. The bit rate is the clock of
+ * the APB bus of the channel divided by 2 to 256, so the running bus clock
+ * is read instead of assuming one.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The bus clock divided by 256 is within maxBitRate. <br>
+ * 
+ * POST-CONDITION: The prescaler is returned. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   maxBitRate is the highest bit rate the slaves accept in Hz.
+ * 
+ * @return  The fastest prescaler within maxBitRate.
+ * 
+ * \b Example:
+ * @code
+ * // 80 MHz PCLK2 and the 5 MHz ADXL345 limit: SPI_FPCLK16, 5 MHz
+ * SpiBaudRate_t BaudRate = SPI_baudRateSelect(SPI_CHANNEL1, 5000000UL);
+ * @endcode
+ * 
+ * @see SPI_init
+ * @see SPI_baudRateSelect
+ * @see SPI_bitRateGet
+ * 
+ ****************************************************************************/
+SpiBaudRate_t SPI_baudRateSelect(SpiChannel_t Channel, uint32_t maxBitRate)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    const uint32_t pclk = SPI_pclkGet(Channel);
+    uint8_t divider = SPI_FPCLK2;
+
+    /*Each prescaler step halves the bit rate, fPCLK / 2^(BR + 1)*/
+    while((divider < SPI_FPCLK256) && ((pclk >> (divider + 1U)) > maxBitRate))
+    {
+        divider++;
+    }
+
+    /* Prevent to exceed the slave limit with the slowest prescaler*/
+    assert((pclk >> (divider + 1U)) <= maxBitRate);
+
+    return (SpiBaudRate_t)divider;
+}
+
+/*****************************************************************************
+ * Function: SPI_bitRateGet()
+*//**
+ *\b Description:
+ * This function is used to get the bit rate a channel runs at, from its 
+ * prescaler and the running bus clock.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: The bit rate is returned. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  The bit rate in Hz.
+ * 
+ * \b Example:
+ * @code
+ * assert(SPI_bitRateGet(SPI_CHANNEL1) >= 
+ * ADXL345_minSpiClockGet(ADXL345_ODR_800HZ));
+ * @endcode
+ * 
+ * @see SPI_init
+ * @see SPI_baudRateSelect
+ * @see SPI_bitRateGet
+ * 
+ ****************************************************************************/
+uint32_t SPI_bitRateGet(SpiChannel_t Channel)
+{
+    /* Prevent to assign a value out of the range of the channel*/
+    assert(Channel < SPI_MAX_CHANNEL);
+
+    const uint32_t divider = (*controlRegister1[Channel] & 
+    (SPI_CR1_BR_0 | SPI_CR1_BR_1 | SPI_CR1_BR_2)) / SPI_CR1_BR_0;
+
+    return SPI_pclkGet(Channel) >> (divider + 1U);
+}
+
+/*****************************************************************************
+ * Function: SPI_registerWrite()
+*//**
+ *\b Description:
+ * This function is used to directly address and modify a SPI register.
+ * The function should be used to access specialized functionality in 
+ * the SPI peripheral that is not exposed by any other function of the
+ * interface.
+ * 
+ * PRE-CONDITION: Address is within the boundaries of the SPI register
+ * address space. <br>
+ * 
+ * POST-CONDITION: The register located at address with be updated with
+ * value. <br>
+ * 
+ * @param[in]   address is a register address within the SPI peripheral
+ *              map.
+ * @param[in]   value is the value to set the SPI register. 
+ * 
+ * @return void
+ * 
+ * \b Example
+ * @code
+ *  SPI_registerWrite(0x1000, 0x15);
+ * @endcode
+ * 
+ * @see SPI_configGet
+ * @see SPI_configSizeGet
+ * @see SPI_Init
+ * @see SPI_Transfer
+ * @see SPI_RegisterWrite
+ * @see SPI_RegisterRead
+ * @see SPI_callbackRegister
+ * 
+****************************************************************************/  
+void SPI_registerWrite(uint32_t address, uint32_t value)
+{
+    volatile uint32_t * const registerPointer = (uint32_t*)(uintptr_t)address;
+    *registerPointer = value;
+}
+
+/*****************************************************************************
+ * Function: SPI_registerRead()
+*//**
+ *\b Description:
+ * This function is used to directly address a SPI register. The 
+ * function should be used to access specialized functionality in the 
+ * SPI peripheral that is not exposed by any other function of the 
+ * interface.
+ * 
+ * PRE-CONDITION: Address is within the boundaries of the SPI register 
+ * address space. <br>
+ * 
+ * POST-CONDITION: The value stored in the register is returned to the 
+ * caller. <br>
+ * 
+ * @param[in]   address is the address of the SPI register to read.
+ * 
+ * @return  The current value of the SPI register.
+ * 
+ * \b Example:
+ * @code
+ * type spiValue = SPI_registerRead(0x1000);
+ * @endcode
+ * 
+ * @see SPI_configGet
+ * @see SPI_configSizeGet
+ * @see SPI_Init
+ * @see SPI_Transfer
+ * @see SPI_RegisterWrite
+ * @see SPI_RegisterRead
+ * @see SPI_callbackRegister
+ *
+ ****************************************************************************/
+uint16_t SPI_registerRead(uint32_t address)
+{
+    volatile uint16_t * const registerPointer =
+    (uint16_t *)(uintptr_t)address;
+
+    return *registerPointer;
+}
+
+/*****************************************************************************
+ * Function: SPI_dmaStart()
+*//**
+ *\b Description:
+ * This function is used to arm the receive and transmit DMA streams of the
+ * channel. Both streams move 16 bits per frame, matching the driver's data
+ * buffers, and only the receive stream raises the completion interrupt as 
+ * its last frame marks the end of the bus activity.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * PRE-CONDITION: The channel is taken with SPI_dmaAcquire. <br>
+ * PRE-CONDITION: The size is greater than 0. <br>
+ * 
+ * POST-CONDITION: The streams are enabled and the SPI issues DMA requests.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   txData is the memory read by the transmit stream.
+ * @param[in]   txIncrement is DMA_SxCR_MINC to walk txData or 0.
+ * @param[out]  rxData is the memory written by the receive stream.
+ * @param[in]   rxIncrement is DMA_SxCR_MINC to walk rxData or 0.
+ * @param[in]   size is the number of frames.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_dmaStart(SpiChannel_t Channel, const uint16_t *txData,
+uint32_t txIncrement, uint16_t *rxData, uint32_t rxIncrement, uint16_t size)
+{
+    DMA_Stream_TypeDef * const RxStream = rxStream[Channel];
+    DMA_Stream_TypeDef * const TxStream = txStream[Channel];
+
+    /* Clear the flags of the previous operation*/
+    *rxFlagClear[Channel] = (DMA_STREAM_FLAGS << rxFlagShift[Channel]);
+    *txFlagClear[Channel] = (DMA_STREAM_FLAGS << txFlagShift[Channel]);
+
+    /* Peripheral to memory, 16 bits, completion and error interrupts*/
+    RxStream->PAR = (uint32_t)(uintptr_t)dataRegister[Channel];
+    RxStream->M0AR = (uint32_t)(uintptr_t)rxData;
+    RxStream->NDTR = size;
+    RxStream->FCR = 0;
+    RxStream->CR = dmaChannel[Channel] | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 |
+    DMA_SxCR_PSIZE_0 | rxIncrement | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+
+    /* Memory to peripheral, 16 bits, no interrupts*/
+    TxStream->PAR = (uint32_t)(uintptr_t)dataRegister[Channel];
+    TxStream->M0AR = (uint32_t)(uintptr_t)txData;
+    TxStream->NDTR = size;
+    TxStream->FCR = 0;
+    TxStream->CR = dmaChannel[Channel] | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 |
+    DMA_SxCR_PSIZE_0 | txIncrement | DMA_SxCR_DIR_0;
+
+    /* Drop a stale frame so the receive stream starts aligned*/
+    uint16_t clearingFlag;
+    clearingFlag = *dataRegister[Channel];
+    clearingFlag = *statusRegister[Channel];
+    (void)clearingFlag;
+
+    NVIC_EnableIRQ(rxStreamIrq[Channel]);
+
+    /* Receive path first so no frame is lost, then start transmitting*/
+    RxStream->CR |= DMA_SxCR_EN;
+    *controlRegister2[Channel] |= SPI_CR2_RXDMAEN;
+    TxStream->CR |= DMA_SxCR_EN;
+    *controlRegister2[Channel] |= SPI_CR2_TXDMAEN;
+    SPI_nssAssert(Channel);
+}
+
+/*****************************************************************************
+ * Function: SPI_dmaIrqHandler()
+*//**
+ *\b Description:
+ * This function is used to service the receive stream interrupt of a 
+ * channel. It clears the stream flags, releases the SPI DMA requests and 
+ * calls the registered callback with SPI_OK, or with SPI_DMA_ERROR when a
+ * stream error stopped the operation, which is counted in the fault 
+ * statistics.
+ * 
+ * PRE-CONDITION: The Channel is within the maximum SpiChannel_t. <br>
+ * 
+ * POST-CONDITION: The channel is ready for a new DMA operation. <br>
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_dmaIrqHandler(SpiChannel_t Channel)
+{
+    PROBE_STAMP(start);
+    uint32_t flags = (*rxFlagStatus[Channel] >> rxFlagShift[Channel]);
+
+    /* Clear the flags of both streams*/
+    *rxFlagClear[Channel] = (DMA_STREAM_FLAGS << rxFlagShift[Channel]);
+    *txFlagClear[Channel] = (DMA_STREAM_FLAGS << txFlagShift[Channel]);
+
+    /* The streams disable themselves on completion. On an error they are 
+     * stopped so the bus is released as well.
+    */
+    SpiStatus_t result = SPI_OK;
+    if((flags & DMA_STREAM_TEIF) || !(flags & DMA_STREAM_TCIF))
+    {
+        rxStream[Channel]->CR &=~ DMA_SxCR_EN;
+        txStream[Channel]->CR &=~ DMA_SxCR_EN;
+        faultStats[Channel].dmaErrors++;
+        result = SPI_DMA_ERROR;
+    }
+
+    *controlRegister2[Channel] &=~ (SPI_CR2_TXDMAEN | SPI_CR2_RXDMAEN);
+
+    /* The last frame is stored once its last bit is sampled, the clock 
+     * settles within a bit time before a hardware NSS is released*/
+    if(nssHardware[Channel] && (result == SPI_OK))
+    {
+        (void)SPI_waitFlag(Channel, SPI_SR_BSY, 0, 0);
+    }
+    SPI_nssRelease(Channel);
+
+    /* The callback may chain the next operation on the channel*/
+    SPI_release(Channel);
+
+    if(dmaCallback[Channel] != NULL)
+    {
+        dmaCallback[Channel](Channel, result);
+    }
+
+    PROBE_RECORD(PROBE_DMA_ISR, start);
+}
+
+/*****************************************************************************
+ * Function: SPI_queueStart()
+*//**
+ *\b Description:
+ * This function is used to put the transaction at the head of a channel 
+ * queue on the bus. The chip select is asserted and the TXE, RXNE and 
+ * error interrupts are enabled, the first TXE interrupt writes the first 
+ * frame.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_queueStart(SpiChannel_t Channel)
+{
+    SpiQueue_t * const Queue = &queue[Channel];
+    const SpiQueueSlot_t * const Slot = &Queue->slot[Queue->head];
+    const uint32_t wait = DWT->CYCCNT - Slot->stamp;
+
+    if(wait > queueStats[Channel].waitMax)
+    {
+        queueStats[Channel].waitMax = wait;
+    }
+
+    Queue->total = SPI_segmentsSize(&Slot->Transaction);
+    Queue->txCount = 0;
+    Queue->rxCount = 0;
+    Queue->TxCursor = (SpiCursor_t){0, 0};
+    Queue->RxCursor = (SpiCursor_t){0, 0};
+    SPI_cursorAdvance(&Slot->Transaction, &Queue->TxCursor, 0);
+    SPI_cursorAdvance(&Slot->Transaction, &Queue->RxCursor, 0);
+
+    /* Drop a stale frame and clear OVR so the first frame read is ours*/
+    uint16_t clearingFlag;
+    clearingFlag = *dataRegister[Channel];
+    clearingFlag = *statusRegister[Channel];
+    (void)clearingFlag;
+
+    SPI_select(Channel, &Slot->Transaction);
+    SPI_delay(Slot->Transaction.csSetup);
+    Queue->stamp = DWT->CYCCNT;
+
+    NVIC_EnableIRQ(spiIrq[Channel]);
+    *controlRegister2[Channel] |= (SPI_CR2_RXNEIE | SPI_CR2_TXEIE | 
+    SPI_CR2_ERRIE);
+}
+
+/*****************************************************************************
+ * Function: SPI_queueIrqHandler()
+*//**
+ *\b Description:
+ * This function is used to move the frames of the transaction on the bus.
+ * RXNE stores or discards the received frame in its segment, TXE writes 
+ * the next frame while less than two frames are in flight and is masked 
+ * otherwise, so the shift register stays fed without an overrun. An 
+ * overrun or a mode fault aborts the transaction. After the last frame 
+ * the handler does not wait for the bus: TXE is left enabled and brings it
+ * back until BSY is clear, then the transaction is finished.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_queueIrqHandler(SpiChannel_t Channel)
+{
+    PROBE_STAMP(start);
+    SpiQueue_t * const Queue = &queue[Channel];
+    const SpiTransaction_t * const Transaction = 
+    &Queue->slot[Queue->head].Transaction;
+    const uint16_t total = Queue->total;
+    uint16_t volatile * const status = statusRegister[Channel];
+    uint16_t volatile * const data = dataRegister[Channel];
+    uint16_t volatile * const control = controlRegister2[Channel];
+
+    /* A transaction aborted after a stall may leave a request pending*/
+    if(Queue->count == 0U)
+    {
+        return;
+    }
+
+    const uint16_t flags = *status;
+    const SpiStatus_t result = SPI_faultCheck(Channel, flags, 
+    SPI_SR_MODF | SPI_SR_OVR, Queue->stamp);
+
+    if(result != SPI_OK)
+    {
+        SPI_queueFinish(Channel, result);
+        PROBE_RECORD(PROBE_SPI_ISR, start);
+        return;
+    }
+
+    if(flags & SPI_SR_RXNE)
+    {
+        const uint16_t frame = *data;
+        const SpiSegment_t * const Segment = 
+        &Transaction->Segments[Queue->RxCursor.segment];
+
+        if(Segment->rxData != NULL)
+        {
+            Segment->rxData[Queue->RxCursor.offset] = frame;
+        }
+        SPI_cursorAdvance(Transaction, &Queue->RxCursor, 1);
+        Queue->rxCount++;
+        Queue->stamp = DWT->CYCCNT;
+
+        if(Queue->txCount < total)
+        {
+            *control |= SPI_CR2_TXEIE;
+        }
+    }
+
+    if((*control & SPI_CR2_TXEIE) && (*status & SPI_SR_TXE))
+    {
+        if((Queue->txCount < total) && ((uint16_t)(Queue->txCount - 
+        Queue->rxCount) < TRANSCEIVE_IN_FLIGHT))
+        {
+            const SpiSegment_t * const Segment = 
+            &Transaction->Segments[Queue->TxCursor.segment];
+
+            *data = (Segment->txData != NULL) ? 
+            Segment->txData[Queue->TxCursor.offset] : 0U;
+            SPI_cursorAdvance(Transaction, &Queue->TxCursor, 1);
+            Queue->txCount++;
+            Queue->stamp = DWT->CYCCNT;
+        }
+
+        if((Queue->txCount >= total) || ((uint16_t)(Queue->txCount - 
+        Queue->rxCount) >= TRANSCEIVE_IN_FLIGHT))
+        {
+            *control &=~ SPI_CR2_TXEIE;
+        }
+    }
+
+    if(Queue->rxCount < total)
+    {
+        PROBE_RECORD(PROBE_SPI_ISR, start);
+        return;
+    }
+
+    /* The last frame is read once its last bit is sampled and the clock 
+     * settles a moment later. TXE is set by then, it brings the handler 
+     * back to close the transaction once the bus is idle*/
+    if(*status & SPI_SR_BSY)
+    {
+        *control = (uint16_t)((*control & ~SPI_CR2_RXNEIE) | SPI_CR2_TXEIE);
+    }
+    else
+    {
+        SPI_queueFinish(Channel, SPI_OK);
+    }
+
+    PROBE_RECORD(PROBE_SPI_ISR, start);
+}
+
+/*****************************************************************************
+ * Function: SPI_queueFinish()
+*//**
+ *\b Description:
+ * This function is used to close the transaction at the head of a channel
+ * queue, completed or aborted. The interrupts are disabled, the chip 
+ * select is released, the callback is called with the status and the next
+ * transaction is started. The channel is given back once the queue is 
+ * empty.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Status is SPI_OK, or the fault that aborted the transaction.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_queueFinish(SpiChannel_t Channel, SpiStatus_t Status)
+{
+    SpiQueue_t * const Queue = &queue[Channel];
+    const SpiQueueSlot_t * const Slot = &Queue->slot[Queue->head];
+    const SpiTransaction_t * const Transaction = &Slot->Transaction;
+    SpiQueueStats_t * const Stats = &queueStats[Channel];
+
+    *controlRegister2[Channel] &=~ (SPI_CR2_RXNEIE | SPI_CR2_TXEIE | 
+    SPI_CR2_ERRIE);
+
+    if(Status == SPI_OK)
+    {
+        SPI_delay(Transaction->csHold);
+    }
+    SPI_deselect(Channel, Transaction);
+
+    if(Status == SPI_OK)
+    {
+        const uint32_t latency = DWT->CYCCNT - Slot->stamp;
+        Stats->completed++;
+        Stats->latencySum += latency;
+        if(latency > Stats->latencyMax)
+        {
+            Stats->latencyMax = latency;
+        }
+    }
+    else
+    {
+        Stats->aborted++;
+    }
+
+    if(Transaction->Callback != NULL)
+    {
+        Transaction->Callback(Channel, Transaction, Status);
+    }
+
+    Queue->head = (uint8_t)((Queue->head + 1U) % SPI_QUEUE_DEPTH);
+    Queue->count--;
+    Stats->depth = Queue->count;
+
+    if(Queue->count > 0U)
+    {
+        SPI_queueStart(Channel);
+    }
+    else
+    {
+        SPI_release(Channel);
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_queueStallCheck()
+*//**
+ *\b Description:
+ * This function is used to abort the transaction at the head of a channel
+ * queue when it moved no frame within the channel budget. A lost frame 
+ * raises no interrupt, so the check runs whenever the channel is needed. 
+ * The callback gets SPI_TIMEOUT and the next transaction is started, or 
+ * the channel is given back. It runs with interrupts masked.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_queueStallCheck(SpiChannel_t Channel)
+{
+    const SpiQueue_t * const Queue = &queue[Channel];
+
+    if((Queue->count > 0U) && 
+    ((DWT->CYCCNT - Queue->stamp) > timeoutCycles[Channel]))
+    {
+        faultStats[Channel].timeouts++;
+        SPI_queueFinish(Channel, SPI_TIMEOUT);
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_acquire()
+*//**
+ *\b Description:
+ * This function is used to take a free channel for a kind of operation. 
+ * The test and set runs with interrupts masked. A queue that holds the 
+ * channel with a stalled transaction is checked first, so the channel is 
+ * reclaimed once the queue empties instead of being held forever.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Owner is the operation that needs the channel.
+ * 
+ * @return  1 when the channel was taken, 0 when it is in use.
+ * 
+ ****************************************************************************/
+static uint8_t SPI_acquire(SpiChannel_t Channel, SpiOwner_t Owner)
+{
+    uint8_t taken = 0;
+    const uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(channelOwner[Channel] == SPI_OWNER_QUEUE)
+    {
+        SPI_queueStallCheck(Channel);
+    }
+    if(channelOwner[Channel] == SPI_OWNER_NONE)
+    {
+        channelOwner[Channel] = Owner;
+        taken = 1;
+    }
+    __set_PRIMASK(primask);
+
+    return taken;
+}
+
+/*****************************************************************************
+ * Function: SPI_release()
+*//**
+ *\b Description:
+ * This function is used to give back a channel taken with SPI_acquire.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_release(SpiChannel_t Channel)
+{
+    channelOwner[Channel] = SPI_OWNER_NONE;
+}
+
+/*****************************************************************************
+ * Function: SPI_transactionRun()
+*//**
+ *\b Description:
+ * This function is used to run one attempt of a transaction. The chip 
+ * select is released on every path, also when a fault stops the frames.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Transaction is the descriptor of the transaction.
+ * 
+ * @return  SPI_OK, or the fault that stopped the attempt.
+ * 
+ ****************************************************************************/
+static SpiStatus_t SPI_transactionRun(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction)
+{
+    uint16_t volatile * const status = statusRegister[Channel];
+    uint16_t volatile * const data = dataRegister[Channel];
+    const SpiSegment_t * const Segments = Transaction->Segments;
+    const uint16_t total = SPI_segmentsSize(Transaction);
+    SpiCursor_t TxCursor = {0, 0};
+    SpiCursor_t RxCursor = {0, 0};
+    uint16_t txCount = 0;
+    uint16_t rxCount = 0;
+    SpiStatus_t result = SPI_OK;
+
+    /* Prevent to run an empty transaction*/
+    assert(total > 0);
+
+    /* Start both cursors on the first frame*/
+    SPI_cursorAdvance(Transaction, &TxCursor, 0);
+    SPI_cursorAdvance(Transaction, &RxCursor, 0);
+
+    /* Drop a stale frame and clear OVR so the first frame read is ours*/
+    uint16_t clearingFlag;
+    clearingFlag = *data;
+    clearingFlag = *status;
+    (void)clearingFlag;
+
+    SPI_select(Channel, Transaction);
+    SPI_delay(Transaction->csSetup);
+
+    /* The budget restarts on every frame moved*/
+    uint32_t start = DWT->CYCCNT;
+
+    while((rxCount < total) && (result == SPI_OK))
+    {
+        const uint16_t flags = *status;
+
+        result = SPI_faultCheck(Channel, flags, SPI_SR_MODF | SPI_SR_OVR, 
+        start);
+
+        /* Feed the transmit buffer while the shift register is busy*/
+        if((result == SPI_OK) && (flags & SPI_SR_TXE) && (txCount < total) &&
+        ((uint16_t)(txCount - rxCount) < TRANSCEIVE_IN_FLIGHT))
+        {
+            const SpiSegment_t * const Segment = &Segments[TxCursor.segment];
+
+            *data = (Segment->txData != NULL) ? 
+            Segment->txData[TxCursor.offset] : 0U;
+            SPI_cursorAdvance(Transaction, &TxCursor, 1);
+            txCount++;
+            start = DWT->CYCCNT;
+        }
+
+        /* Drain the received frame*/
+        if((result == SPI_OK) && (flags & SPI_SR_RXNE))
+        {
+            const uint16_t frame = *data;
+            const SpiSegment_t * const Segment = &Segments[RxCursor.segment];
+
+            if(Segment->rxData != NULL)
+            {
+                Segment->rxData[RxCursor.offset] = frame;
+            }
+            SPI_cursorAdvance(Transaction, &RxCursor, 1);
+            rxCount++;
+            start = DWT->CYCCNT;
+        }
+    }
+
+    /* Wait until bus is not busy before releasing the slave*/
+    if(result == SPI_OK)
+    {
+        result = SPI_waitFlag(Channel, SPI_SR_BSY, 0, SPI_SR_MODF);
+    }
+
+    SPI_delay(Transaction->csHold);
+    SPI_deselect(Channel, Transaction);
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: SPI_faultCheck()
+*//**
+ *\b Description:
+ * This function is used to check a status register value for the faults 
+ * of interest and the elapsed budget of a wait. A fault is counted and 
+ * cleared: OVR by reading DR then SR, MODF by reading SR then writing CR1,
+ * which also gives back the master mode and SPE the fault removed.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   flags is the status register value.
+ * @param[in]   faults are the fault flags to check, SPI_SR_MODF and/or 
+ *              SPI_SR_OVR.
+ * @param[in]   start is the cycle count when the wait started.
+ * 
+ * @return  SPI_OK, or the fault or timeout detected.
+ * 
+ ****************************************************************************/
+static SpiStatus_t SPI_faultCheck(SpiChannel_t Channel, uint16_t flags, 
+uint16_t faults, uint32_t start)
+{
+    SpiStatus_t result = SPI_OK;
+    uint16_t clearingFlag;
+
+    if(flags & faults & SPI_SR_MODF)
+    {
+        /* SR was read with MODF set, writing CR1 completes the clearing*/
+        faultStats[Channel].modeFaults++;
+        *controlRegister1[Channel] |= SPI_CR1_MSTR;
+        if(!nssHardware[Channel])
+        {
+            *controlRegister1[Channel] |= SPI_CR1_SPE;
+        }
+        result = SPI_MODE_FAULT;
+    }
+    else if(flags & faults & SPI_SR_OVR)
+    {
+        faultStats[Channel].overruns++;
+        clearingFlag = *dataRegister[Channel];
+        clearingFlag = *statusRegister[Channel];
+        (void)clearingFlag;
+        result = SPI_OVERRUN;
+    }
+    else if((DWT->CYCCNT - start) > timeoutCycles[Channel])
+    {
+        faultStats[Channel].timeouts++;
+        result = SPI_TIMEOUT;
+    }
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: SPI_waitFlag()
+*//**
+ *\b Description:
+ * This function is used to wait until a status flag reaches a state, 
+ * within the budget of the channel and while no fault of interest is set.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   flag is the status flag to wait on.
+ * @param[in]   state is the awaited value, flag or 0.
+ * @param[in]   faults are the fault flags that stop the wait.
+ * 
+ * @return  SPI_OK, or the fault or timeout detected.
+ * 
+ ****************************************************************************/
+static SpiStatus_t SPI_waitFlag(SpiChannel_t Channel, uint16_t flag, 
+uint16_t state, uint16_t faults)
+{
+    const uint32_t start = DWT->CYCCNT;
+    SpiStatus_t result = SPI_OK;
+    uint16_t flags = *statusRegister[Channel];
+
+    while(((flags & flag) != state) && (result == SPI_OK))
+    {
+        result = SPI_faultCheck(Channel, flags, faults, start);
+        flags = *statusRegister[Channel];
+    }
+
+    return result;
+}
+
+/*****************************************************************************
+ * Function: SPI_segmentsSize()
+*//**
+ *\b Description:
+ * This function is used to count the frames of all the segments of a 
+ * transaction.
+ * 
+ * @param[in]   Transaction is the descriptor of the transaction.
+ * 
+ * @return  The number of frames of the transaction.
+ * 
+ ****************************************************************************/
+static uint16_t SPI_segmentsSize(const SpiTransaction_t * const Transaction)
+{
+    /* Prevent to use an empty segment list*/
+    assert((Transaction->Segments != NULL) || 
+    (Transaction->segmentCount == 0));
+
+    uint16_t total = 0;
+
+    for(uint8_t i = 0; i < Transaction->segmentCount; i++)
+    {
+        total += Transaction->Segments[i].size;
+    }
+
+    return total;
+}
+
+/*****************************************************************************
+ * Function: SPI_cursorAdvance()
+*//**
+ *\b Description:
+ * This function is used to move a cursor step frames forward and past the
+ * empty segments, so it always points to a frame while frames are left.
+ * 
+ * @param[in]   Transaction is the descriptor of the transaction.
+ * @param[in,out] Cursor is the cursor to move.
+ * @param[in]   step is the number of frames to move, 0 or 1.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_cursorAdvance(const SpiTransaction_t * const Transaction, 
+SpiCursor_t * const Cursor, uint16_t step)
+{
+    Cursor->offset += step;
+
+    while((Cursor->segment < Transaction->segmentCount) && 
+    (Cursor->offset >= Transaction->Segments[Cursor->segment].size))
+    {
+        Cursor->segment++;
+        Cursor->offset = 0;
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_delay()
+*//**
+ *\b Description:
+ * This function is used to wait a number of CPU cycles on the DWT cycle 
+ * counter, for the chip select setup and hold gaps.
+ * 
+ * @param[in]   cycles is the number of CPU cycles, 0 returns at once.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_delay(uint32_t cycles)
+{
+    const uint32_t start = DWT->CYCCNT;
+
+    while((DWT->CYCCNT - start) < cycles)
+    {
+        asm("nop");
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_nssAssert()
+*//**
+ *\b Description:
+ * This function is used to enable a hardware NSS channel, which drives its
+ * NSS output low. Software NSS channels are left untouched.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_nssAssert(SpiChannel_t Channel)
+{
+    if(nssHardware[Channel])
+    {
+        *controlRegister1[Channel] |= SPI_CR1_SPE;
+        PROBE_MARK(selectStamp[Channel]);
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_nssRelease()
+*//**
+ *\b Description:
+ * This function is used to disable a hardware NSS channel once the last 
+ * frame has been clocked, which releases its NSS output. The caller waits
+ * for BSY to clear first, a fault releases the output at once. Software 
+ * NSS channels are left untouched.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_nssRelease(SpiChannel_t Channel)
+{
+    if(nssHardware[Channel])
+    {
+        *controlRegister1[Channel] &=~ SPI_CR1_SPE;
+        PROBE_RECORD(PROBE_SPI_CS, selectStamp[Channel]);
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_select()
+*//**
+ *\b Description:
+ * This function is used to assert the chip select of a transaction: the 
+ * NSS output on a hardware NSS channel, the chip select pin otherwise.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Transaction is the descriptor of the transaction.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_select(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction)
+{
+    if(nssHardware[Channel])
+    {
+        SPI_nssAssert(Channel);
+    }
+    else
+    {
+        const DioPinConfig_t CSLine =
+        {
+            .Port = Transaction->Port,
+            .Pin = Transaction->Pin
+        };
+        DIO_pinWrite(&CSLine, DIO_LOW);
+        PROBE_MARK(selectStamp[Channel]);
+    }
+}
+
+/*****************************************************************************
+ * Function: SPI_pclkGet()
+*//**
+ *\b Description:
+ * This function is used to get the clock of the APB bus of a channel. 
+ * SPI1 and SPI4 are on APB2, SPI2 and SPI3 are on APB1.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * 
+ * @return  The bus clock in Hz.
+ * 
+ ****************************************************************************/
+static uint32_t SPI_pclkGet(SpiChannel_t Channel)
+{
+    return ((Channel == SPI_CHANNEL2) || (Channel == SPI_CHANNEL3)) ?
+    CLOCK_pclk1Get() : CLOCK_pclk2Get();
+}
+
+/*****************************************************************************
+ * Function: SPI_deselect()
+*//**
+ *\b Description:
+ * This function is used to release the chip select of a transaction: the 
+ * NSS output on a hardware NSS channel, the chip select pin otherwise.
+ * 
+ * @param[in]   Channel is the SPI channel.
+ * @param[in]   Transaction is the descriptor of the transaction.
+ * 
+ * @return  void
+ * 
+ ****************************************************************************/
+static void SPI_deselect(SpiChannel_t Channel, 
+const SpiTransaction_t * const Transaction)
+{
+    if(nssHardware[Channel])
+    {
+        SPI_nssRelease(Channel);
+    }
+    else
+    {
+        const DioPinConfig_t CSLine =
+        {
+            .Port = Transaction->Port,
+            .Pin = Transaction->Pin
+        };
+        DIO_pinWrite(&CSLine, DIO_HIGH);
+        PROBE_RECORD(PROBE_SPI_CS, selectStamp[Channel]);
+    }
+}
+
+/*****************************************************************************
+* Interrupt Handlers
+*****************************************************************************/
+/** SPI1 receive stream*/
+void DMA2_Stream2_IRQHandler(void)
+{
+    SPI_dmaIrqHandler(SPI_CHANNEL1);
+}
+
+/** SPI2 receive stream*/
+void DMA1_Stream3_IRQHandler(void)
+{
+    SPI_dmaIrqHandler(SPI_CHANNEL2);
+}
+
+/** SPI3 receive stream*/
+void DMA1_Stream0_IRQHandler(void)
+{
+    SPI_dmaIrqHandler(SPI_CHANNEL3);
+}
+
+/** SPI4 receive stream*/
+void DMA2_Stream0_IRQHandler(void)
+{
+    SPI_dmaIrqHandler(SPI_CHANNEL4);
+}
+
+/** SPI1 global interrupt*/
+void SPI1_IRQHandler(void)
+{
+    SPI_queueIrqHandler(SPI_CHANNEL1);
+}
+
+/** SPI2 global interrupt*/
+void SPI2_IRQHandler(void)
+{
+    SPI_queueIrqHandler(SPI_CHANNEL2);
+}
+
+/** SPI3 global interrupt*/
+void SPI3_IRQHandler(void)
+{
+    SPI_queueIrqHandler(SPI_CHANNEL3);
+}
+
+/** SPI4 global interrupt*/
+void SPI4_IRQHandler(void)
+{
+    SPI_queueIrqHandler(SPI_CHANNEL4);
+}
@@ -15,26 +15,66 @@
 *****************************************************************************/
 #include "spi_cfg.h"
 
+/*****************************************************************************
+* Module Preprocessor Macros
+*****************************************************************************/
+/**
+ * The following list contains the configuration data for each Serial 
+ * Peripheral Interface. Each row represent a single SPI configuration.
+ * Each column is representing a member of the SpiConfig_t structure. The
+ * list is expanded into the SpiConfig table, with the CR1 and CR2 values 
+ * of each row reduced at compile time, and into build time checks. A non 
+ * zero max bit rate makes SPI_Init pick the fastest prescaler of the 
+ * channel bus clock within it, instead of the baud rate.
+*/
+#define SPI_CONFIG_TABLE(ROW)                                               \
+/*                                                                          \
+ *  Channel        Mode       Hierarchy   Baud rate   NSS pin,              \
+ *  Frame    Type             Size       Max bit rate (ADXL345 5 MHz)       \
+*/                                                                          \
+ROW(SPI_CHANNEL1, SPI_MODE3, SPI_MASTER, SPI_FPCLK4, SPI_HARDWARE_NSS_ENABLED,\
+    SPI_MSB, SPI_FULL_DUPLEX, SPI_8BITS, 5000000UL)
+
+/** Expands a row into a SpiConfig_t with its register images*/
+#define SPI_CONFIG_ROW(Channel, Mode, Hierarchy, BaudRate, SlaveSelect,     \
+FrameFormat, TypeTransfer, DataSize, MaxBitRate)                            \
+{Channel, Mode, Hierarchy, BaudRate, SlaveSelect, FrameFormat, TypeTransfer,\
+DataSize, MaxBitRate, SPI_CR1_IMAGE(Mode, Hierarchy, BaudRate, SlaveSelect, \
+FrameFormat, TypeTransfer, DataSize), SPI_CR2_IMAGE(SlaveSelect)},
+
+/** Expands a row into its build time check*/
+#define SPI_CONFIG_CHECK(Channel, Mode, Hierarchy, BaudRate, SlaveSelect,   \
+FrameFormat, TypeTransfer, DataSize, MaxBitRate)                            \
+_Static_assert(SPI_CONFIG_VALID(Channel, Mode, Hierarchy, BaudRate,         \
+SlaveSelect, FrameFormat, TypeTransfer, DataSize),                          \
+"SpiConfig row " #Channel " has an invalid setting");
+
+/** Expands a row into its channel bit, to find a channel set up twice*/
+#define SPI_CHANNEL_SUM(Channel, Mode, Hierarchy, BaudRate, SlaveSelect,    \
+FrameFormat, TypeTransfer, DataSize, MaxBitRate)                            \
++ (1UL << (Channel))
+#define SPI_CHANNEL_OR(Channel, Mode, Hierarchy, BaudRate, SlaveSelect,     \
+FrameFormat, TypeTransfer, DataSize, MaxBitRate)                            \
+| (1UL << (Channel))
+
 /*****************************************************************************
 * Module Variable Definitions
 *****************************************************************************/
 /**
  * The following array contains the configuration data for each Serial 
- * Peripheral Interface. Each row represent a single SPI configuration.
- * Each column is representing a member of the SpiConfig_t structure. This 
- * table is read in by SPI_Init, where each channel is then set up based on 
- * this table. 
+ * Peripheral Interface, generated from SPI_CONFIG_TABLE. This table is 
+ * read in by SPI_Init, where each channel is then set up based on this 
+ * table. 
 */
 const SpiConfig_t SpiConfig[] = 
 {
-/*                                                          
- * Channel        Mode       Hierarchy   Baud rate   NSS pin,                   
- * Frame    Type             Size               
-*/
-   {SPI_CHANNEL1, SPI_MODE3, SPI_MASTER, SPI_FPCLK4, SPI_HARDWARE_NSS_ENABLED, 
-   SPI_MSB, SPI_FULL_DUPLEX, SPI_8BITS},
+    SPI_CONFIG_TABLE(SPI_CONFIG_ROW)
 };
 
+SPI_CONFIG_TABLE(SPI_CONFIG_CHECK)
+_Static_assert((0UL SPI_CONFIG_TABLE(SPI_CHANNEL_SUM)) == 
+(0UL SPI_CONFIG_TABLE(SPI_CHANNEL_OR)), "SpiConfig sets a channel twice");
+
 /*****************************************************************************
 * Function Prototypes
 *****************************************************************************/
@@ -70,7 +110,7 @@ const SpiConfig_t SpiConfig[] =
  * @see SPI_Transfer
  * @see SPI_RegisterWrite
  * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
+ * @see SPI_callbackRegister
  * 
 *****************************************************************************/
 const SpiConfig_t * const SPI_ConfigGet(void)
@@ -110,7 +150,7 @@ const SpiConfig_t * const SPI_ConfigGet(void)
  * @see SPI_Transfer
  * @see SPI_RegisterWrite
  * @see SPI_RegisterRead
- * @see SPI_CallbackRegister
+ * @see SPI_callbackRegister
  * 
 *****************************************************************************/
 size_t SPI_configSizeGet(void)
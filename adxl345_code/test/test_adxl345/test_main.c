@@ -0,0 +1,404 @@
+/**
+ * @file test_main.c
+ * @author Jose Luis Figueroa
+ * @brief The unit tests of the ADXL345 driver against the device model of
+ * the simulator. The model sits on SPI1 behind the hardware NSS and counts
+ * its samples on X, so the tests check what reached the device registers
+ * and which samples the FIFO reads returned: the drain of ADXL345_readFifo,
+ * the decode of ADXL345_readSnapshot, the writes of the register shadow
+ * by ADXL345_registerUpdate and ADXL345_flush, and a DMA read that must
+ * survive a second read refused on the same channel.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <unity.h>
+#include "adxl345.h"
+#include "clock.h"
+#include "sensors.h"
+#include "sim.h"
+#include "sim_adxl345.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Period of the X axis counter, 10 bits values*/
+#define COUNTER_PERIOD      (512)
+/** LSB/g of the +-4 g range in 10 bits mode*/
+#define COUNTER_LSB_PER_G   (128)
+/** DUR register, inside the event burst of the shadow*/
+#define DUR_R               (0x21U)
+/** DATA_FORMAT range field*/
+#define RANGE_MASK          (0x03U)
+
+/*****************************************************************************
+* Module Variable Definitions
+*****************************************************************************/
+/** Device under test, the sensors table row at 100 Hz so the FIFO holds
+ * still while it is read*/
+static Adxl345Config_t Config;
+
+/** Output data rate period in cycles*/
+static uint64_t period;
+
+/** Completions of the DMA reads and the status of the last one*/
+static uint8_t dmaCompletions[2];
+static SpiStatus_t dmaStatus;
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static int32_t CounterWaveform(void *context, uint8_t axis, uint32_t sample);
+static void TEST_samplesProduce(uint8_t count);
+static int16_t TEST_axisGet(const uint16_t * const frames, uint8_t axis);
+static void TEST_firstDone(const Adxl345Config_t * const Config,
+SpiStatus_t Status);
+static void TEST_secondDone(const Adxl345Config_t * const Config,
+SpiStatus_t Status);
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+void setUp(void)
+{
+    /*Restart the measurement with an empty FIFO*/
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_init(&Config));
+    SIM_adxl345StatsReset(0U);
+}
+
+void tearDown(void)
+{
+}
+
+/*****************************************************************************
+ * Function: test_readFifoDrainsEverySample()
+*//**
+*\b Description:
+ * Every sample held is returned in order, the FIFO is left empty and no
+ * read starts before the previous pop completed.
+ *
+*****************************************************************************/
+static void test_readFifoDrainsEverySample(void)
+{
+    uint16_t data[FIFO_MAX_ENTRIES * AXIS_BYTES];
+
+    TEST_samplesProduce(5U);
+
+    TEST_ASSERT_EQUAL_UINT8(5U, ADXL345_readFifo(&Config, data,
+    FIFO_MAX_ENTRIES));
+    for(uint8_t i = 1; i < 5U; i++)
+    {
+        TEST_ASSERT_EQUAL_INT16(TEST_axisGet(&data[(i - 1U) * AXIS_BYTES], 0U) +
+        1, TEST_axisGet(&data[i * AXIS_BYTES], 0U));
+        TEST_ASSERT_EQUAL_INT16(COUNTER_LSB_PER_G,
+        TEST_axisGet(&data[i * AXIS_BYTES], 2U));
+    }
+    TEST_ASSERT_EQUAL_UINT8(0U, ADXL345_fifoEntriesGet(&Config));
+
+    const SimAdxl345Stats_t Stats = SIM_adxl345StatsGet(0U);
+    TEST_ASSERT_EQUAL_UINT32(5U, Stats.read);
+    TEST_ASSERT_EQUAL_UINT32(0U, Stats.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0U, Stats.earlyReads);
+}
+
+/*****************************************************************************
+ * Function: test_readFifoStopsAtBuffer()
+*//**
+*\b Description:
+ * The drain stops at the caller buffer and leaves the other samples in the
+ * FIFO.
+ *
+*****************************************************************************/
+static void test_readFifoStopsAtBuffer(void)
+{
+    uint16_t data[3U * AXIS_BYTES];
+
+    TEST_samplesProduce(5U);
+
+    TEST_ASSERT_EQUAL_UINT8(3U, ADXL345_readFifo(&Config, data, 3U));
+    TEST_ASSERT_EQUAL_UINT8(2U, ADXL345_fifoEntriesGet(&Config));
+    TEST_ASSERT_EQUAL_UINT32(3U, SIM_adxl345StatsGet(0U).read);
+}
+
+/*****************************************************************************
+ * Function: test_readSnapshotDecodesBurst()
+*//**
+*\b Description:
+ * One window decodes the interrupt sources, the data format, the oldest
+ * sample and the FIFO settings. Its entries count still includes the
+ * sample it popped, the count read after the pop does not.
+ *
+*****************************************************************************/
+static void test_readSnapshotDecodesBurst(void)
+{
+    uint16_t data[AXIS_BYTES];
+    Adxl345Snapshot_t Snapshot;
+
+    TEST_samplesProduce(3U);
+    const SimSpiStats_t Before = SIM_spiStatsGet(SPI_CHANNEL1);
+
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_readSnapshot(&Config, &Snapshot));
+
+    TEST_ASSERT_EQUAL_UINT32(Before.selects + 1U,
+    SIM_spiStatsGet(SPI_CHANNEL1).selects);
+    TEST_ASSERT_TRUE(Snapshot.intSource & INT_DATA_READY);
+    TEST_ASSERT_EQUAL_HEX8(SIM_adxl345RegisterGet(0U, DATA_FORMAT_R),
+    Snapshot.dataFormat);
+    TEST_ASSERT_EQUAL_INT16(0, Snapshot.y);
+    TEST_ASSERT_EQUAL_INT16(COUNTER_LSB_PER_G, Snapshot.z);
+    TEST_ASSERT_EQUAL(ADXL345_FIFO_STREAM, Snapshot.FifoMode);
+    TEST_ASSERT_EQUAL_UINT8(Config.Watermark, Snapshot.watermark);
+    TEST_ASSERT_EQUAL_UINT8(3U, Snapshot.fifoEntries);
+    TEST_ASSERT_EQUAL_UINT8(0U, Snapshot.fifoTriggered);
+    TEST_ASSERT_EQUAL_UINT8(2U, ADXL345_fifoEntriesGet(&Config));
+
+    /*The next sample follows the one of the snapshot*/
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_read(&Config, DATA_START_R, AXIS_BYTES,
+    data));
+    TEST_ASSERT_EQUAL_INT16(Snapshot.x + 1, TEST_axisGet(data, 0U));
+    TEST_ASSERT_EQUAL_UINT32(0U, SIM_adxl345StatsGet(0U).earlyReads);
+}
+
+/*****************************************************************************
+ * Function: test_registerUpdateWaitsForFlush()
+*//**
+*\b Description:
+ * An update changes the shadow only, the flush writes it and keeps the
+ * bits out of the mask.
+ *
+*****************************************************************************/
+static void test_registerUpdateWaitsForFlush(void)
+{
+    const uint8_t format = SIM_adxl345RegisterGet(0U, DATA_FORMAT_R);
+    const uint8_t updated = (uint8_t)((format & ~RANGE_MASK) | 0x02U);
+
+    ADXL345_registerUpdate(&Config, DATA_FORMAT_R, RANGE_MASK, 0x02U);
+
+    TEST_ASSERT_EQUAL_HEX8(updated, ADXL345_registerGet(&Config,
+    DATA_FORMAT_R));
+    TEST_ASSERT_EQUAL_HEX8(format, SIM_adxl345RegisterGet(0U,
+    DATA_FORMAT_R));
+
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_flush(&Config));
+
+    TEST_ASSERT_EQUAL_HEX8(updated, SIM_adxl345RegisterGet(0U,
+    DATA_FORMAT_R));
+}
+
+/*****************************************************************************
+ * Function: test_flushWritesEveryDirtyRegister()
+*//**
+*\b Description:
+ * Registers apart in the map are written by one flush, and a flush with
+ * nothing dirty does not select the device.
+ *
+*****************************************************************************/
+static void test_flushWritesEveryDirtyRegister(void)
+{
+    ADXL345_registerSet(&Config, THRESH_TAP_R, 0x30U);
+    ADXL345_registerSet(&Config, DUR_R, 0x10U);
+    ADXL345_registerSet(&Config, FIFO_CTL_R,
+    (uint8_t)((ADXL345_FIFO_STREAM << FIFO_MODE_POS) | 8U));
+
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_flush(&Config));
+
+    TEST_ASSERT_EQUAL_HEX8(0x30U, SIM_adxl345RegisterGet(0U, THRESH_TAP_R));
+    TEST_ASSERT_EQUAL_HEX8(0x10U, SIM_adxl345RegisterGet(0U, DUR_R));
+    TEST_ASSERT_EQUAL_HEX8((ADXL345_FIFO_STREAM << FIFO_MODE_POS) | 8U,
+    SIM_adxl345RegisterGet(0U, FIFO_CTL_R));
+
+    const uint32_t selects = SIM_spiStatsGet(SPI_CHANNEL1).selects;
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_flush(&Config));
+    TEST_ASSERT_EQUAL_UINT32(selects, SIM_spiStatsGet(SPI_CHANNEL1).selects);
+}
+
+/*****************************************************************************
+ * Function: test_readDmaBusyKeepsRunningRead()
+*//**
+*\b Description:
+ * A second DMA read on a channel that is still streaming is refused
+ * without touching the running read: the first read completes with its own
+ * sample, buffer and callback, and the refused one is never called back.
+ *
+*****************************************************************************/
+static void test_readDmaBusyKeepsRunningRead(void)
+{
+    uint16_t first[AXIS_BYTES] = {0};
+    uint16_t second[1] = {0xA5A5U};
+    uint16_t next[AXIS_BYTES];
+
+    TEST_samplesProduce(3U);
+    dmaCompletions[0] = 0U;
+    dmaCompletions[1] = 0U;
+    const SimSpiStats_t Before = SIM_spiStatsGet(SPI_CHANNEL1);
+
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_readDma(&Config, DATA_START_R,
+    AXIS_BYTES, first, TEST_firstDone));
+    TEST_ASSERT_EQUAL(SPI_BUSY, ADXL345_readDma(&Config, DEVID_R, 1U, second,
+    TEST_secondDone));
+
+    /*Let the streams finish, a 7 frames burst takes well under 1 ms*/
+    SIM_clockAdvance(CLOCK_hclkGet() / 1000U);
+
+    TEST_ASSERT_EQUAL_UINT8(1U, dmaCompletions[0]);
+    TEST_ASSERT_EQUAL_UINT8(0U, dmaCompletions[1]);
+    TEST_ASSERT_EQUAL(SPI_OK, dmaStatus);
+    TEST_ASSERT_EQUAL_HEX16(0xA5A5U, second[0]);
+    TEST_ASSERT_EQUAL_INT16(0, TEST_axisGet(first, 1U));
+    TEST_ASSERT_EQUAL_INT16(COUNTER_LSB_PER_G, TEST_axisGet(first, 2U));
+    TEST_ASSERT_EQUAL_UINT32(Before.selects + 1U,
+    SIM_spiStatsGet(SPI_CHANNEL1).selects);
+    TEST_ASSERT_EQUAL_UINT32(1U, SIM_adxl345StatsGet(0U).read);
+
+    /*The sample read is the oldest one, the next follows it*/
+    TEST_ASSERT_EQUAL(SPI_OK, ADXL345_read(&Config, DATA_START_R, AXIS_BYTES,
+    next));
+    TEST_ASSERT_EQUAL_INT16(TEST_axisGet(first, 0U) + 1,
+    TEST_axisGet(next, 0U));
+}
+
+/*****************************************************************************
+ * Function: CounterWaveform()
+*//**
+*\b Description:
+ * This function is the waveform source of the model. X counts the samples
+ * over the 10 bits range of +-4 g, Y is at rest and Z holds 1 g.
+ *
+ * @param[in]   context is not used.
+ * @param[in]   axis is 0 = X, 1 = Y or 2 = Z.
+ * @param[in]   sample is the sample number.
+ *
+ * @return  The acceleration in mg.
+ *
+*****************************************************************************/
+static int32_t CounterWaveform(void *context, uint8_t axis, uint32_t sample)
+{
+    (void)context;
+
+    if(axis == 0U)
+    {
+        const int32_t count = (int32_t)(sample % COUNTER_PERIOD) -
+        (COUNTER_PERIOD / 2);
+        return (count * 1000) / COUNTER_LSB_PER_G;
+    }
+
+    return (axis == 2U) ? 1000 : 0;
+}
+
+/*****************************************************************************
+ * Function: TEST_samplesProduce()
+*//**
+*\b Description:
+ * This function is used to let the model produce samples. The first sample
+ * comes one period after the measurement starts in setUp.
+ *
+ * @param[in]   count is the number of samples.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void TEST_samplesProduce(uint8_t count)
+{
+    SIM_clockAdvance((period * count) + (period / 2U));
+}
+
+/*****************************************************************************
+ * Function: TEST_axisGet()
+*//**
+*\b Description:
+ * This function is used to merge the two frames of an axis.
+ *
+ * @param[in]   frames are the six frames of a sample.
+ * @param[in]   axis is 0 = X, 1 = Y or 2 = Z.
+ *
+ * @return  The raw axis value.
+ *
+*****************************************************************************/
+static int16_t TEST_axisGet(const uint16_t * const frames, uint8_t axis)
+{
+    return (int16_t)(frames[axis * 2U] | (frames[(axis * 2U) + 1U] << 8));
+}
+
+/*****************************************************************************
+ * Function: TEST_firstDone()
+*//**
+*\b Description:
+ * This function is the completion of the DMA read that was started.
+ *
+ * @param[in]   Config is the device read.
+ * @param[in]   Status is the result of the read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void TEST_firstDone(const Adxl345Config_t * const Config,
+SpiStatus_t Status)
+{
+    (void)Config;
+    dmaCompletions[0]++;
+    dmaStatus = Status;
+}
+
+/*****************************************************************************
+ * Function: TEST_secondDone()
+*//**
+*\b Description:
+ * This function is the completion of the DMA read that was refused, it
+ * must never be called.
+ *
+ * @param[in]   Config is the device read.
+ * @param[in]   Status is the result of the read.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void TEST_secondDone(const Adxl345Config_t * const Config,
+SpiStatus_t Status)
+{
+    (void)Config;
+    dmaCompletions[1]++;
+    dmaStatus = Status;
+}
+
+int main(void)
+{
+    /*Bring the simulated MCU up as the firmware does*/
+    CLOCK_init();
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_DMA2EN;
+    RCC->APB2ENR |= RCC_APB2ENR_SPI1EN | RCC_APB2ENR_SYSCFGEN;
+    DIO_imageApply(DIO_imageGet(), DIO_imageSizeGet());
+    SPI_init(SPI_ConfigGet(), SPI_configSizeGet());
+
+    /*ADXL345 on SPI1 behind the hardware NSS, INT1 on PA0*/
+    const SimAdxl345Config_t Sensor =
+    {
+        .Channel = SPI_CHANNEL1,
+        .CsPort = SIM_NSS,
+        .CsPin = 0U,
+        .Int1Port = 0U,
+        .Int1Pin = 0U,
+        .Int2Port = SIM_ADXL345_NC,
+        .Int2Pin = 0U,
+        .Waveform = CounterWaveform,
+        .context = NULL
+    };
+    SIM_adxl345Attach(0U, &Sensor);
+
+    Config = *SENSORS_configGet();
+    Config.Odr = ADXL345_ODR_100HZ;
+    period = (uint64_t)CLOCK_hclkGet() * 1000U / ADXL345_odrGet(Config.Odr);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_readFifoDrainsEverySample);
+    RUN_TEST(test_readFifoStopsAtBuffer);
+    RUN_TEST(test_readSnapshotDecodesBurst);
+    RUN_TEST(test_registerUpdateWaitsForFlush);
+    RUN_TEST(test_flushWritesEveryDirtyRegister);
+    RUN_TEST(test_readDmaBusyKeepsRunningRead);
+    return UNITY_END();
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_main.c
+ * @author Jose Luis Figueroa
+ * @brief The unit tests of the DIO driver against the GPIO ports of the
+ * simulator. The pins 8 to 15 are muxed through AFRH, so the alternate
+ * functions written by DIO_init and DIO_imageApply are checked in both
+ * halves of AFR, with the pins around them kept. DIO_portWrite is checked
+ * on the pin levels of a port.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <unity.h>
+#include "dio.h"
+#include "sim.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Port slot of GPIOC in the simulator*/
+#define SIM_PORT_C          (2U)
+/** Value every AFR field of port B is set to before a test*/
+#define AFR_FILL            (0x77777777UL)
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static uint32_t TEST_fieldGet(uint32_t reg, uint8_t pin, uint8_t width);
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+void setUp(void)
+{
+    GPIOB->MODER = 0UL;
+    GPIOB->AFR[0] = AFR_FILL;
+    GPIOB->AFR[1] = AFR_FILL;
+    GPIOC->BSRR = 0xFFFFUL << 16U;
+}
+
+void tearDown(void)
+{
+}
+
+/*****************************************************************************
+ * Function: test_initMuxesHighPins()
+*//**
+*\b Description:
+ * The rows of pins 8 to 15 select their function in AFRH, at the field of
+ * the pin minus 8, and leave AFRL and the other pins of AFRH alone.
+ *
+*****************************************************************************/
+static void test_initMuxesHighPins(void)
+{
+    const DioConfig_t Config[] =
+    {
+        {DIO_PB, DIO_PB8, DIO_FUNCTION, DIO_PUSH_PULL, DIO_VERY_SPEED,
+         DIO_NO_RESISTOR, DIO_AF4},
+        {DIO_PB, DIO_PB13, DIO_FUNCTION, DIO_PUSH_PULL, DIO_VERY_SPEED,
+         DIO_NO_RESISTOR, DIO_AF5},
+        {DIO_PB, DIO_PB15, DIO_FUNCTION, DIO_PUSH_PULL, DIO_VERY_SPEED,
+         DIO_NO_RESISTOR, DIO_AF5}
+    };
+
+    DIO_init(Config, sizeof(Config) / sizeof(Config[0]));
+
+    TEST_ASSERT_EQUAL_HEX32(AFR_FILL, GPIOB->AFR[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x57577774UL, GPIOB->AFR[1]);
+    TEST_ASSERT_EQUAL_UINT32(DIO_FUNCTION, TEST_fieldGet(GPIOB->MODER, 8U, 2U));
+    TEST_ASSERT_EQUAL_UINT32(DIO_FUNCTION, TEST_fieldGet(GPIOB->MODER, 13U,
+    2U));
+    TEST_ASSERT_EQUAL_UINT32(DIO_FUNCTION, TEST_fieldGet(GPIOB->MODER, 15U,
+    2U));
+    TEST_ASSERT_EQUAL_UINT32(DIO_INPUT, TEST_fieldGet(GPIOB->MODER, 14U, 2U));
+}
+
+/*****************************************************************************
+ * Function: test_initMuxesLowPins()
+*//**
+*\b Description:
+ * The rows of pins 0 to 7 select their function in AFRL and leave AFRH
+ * alone.
+ *
+*****************************************************************************/
+static void test_initMuxesLowPins(void)
+{
+    const DioConfig_t Config[] =
+    {
+        {DIO_PB, DIO_PB0, DIO_FUNCTION, DIO_PUSH_PULL, DIO_VERY_SPEED,
+         DIO_NO_RESISTOR, DIO_AF1},
+        {DIO_PB, DIO_PB7, DIO_FUNCTION, DIO_PUSH_PULL, DIO_VERY_SPEED,
+         DIO_NO_RESISTOR, DIO_AF12}
+    };
+
+    DIO_init(Config, sizeof(Config) / sizeof(Config[0]));
+
+    TEST_ASSERT_EQUAL_HEX32(0xC7777771UL, GPIOB->AFR[0]);
+    TEST_ASSERT_EQUAL_HEX32(AFR_FILL, GPIOB->AFR[1]);
+}
+
+/*****************************************************************************
+ * Function: test_imageApplyMuxesHighPins()
+*//**
+*\b Description:
+ * A port image commits its AFRH fields through the AFRH register and keeps
+ * the fields out of its masks.
+ *
+*****************************************************************************/
+static void test_imageApplyMuxesHighPins(void)
+{
+    DioPortImage_t Images[DIO_MAX_PORT] = {0};
+
+    /*PB9 AF4 and PB14 AF5*/
+    Images[DIO_PB].Mask1 = (1UL << 9U) | (1UL << 14U);
+    Images[DIO_PB].Mask2 = (3UL << 18U) | (3UL << 28U);
+    Images[DIO_PB].AfrMask[1] = (0xFUL << 4U) | (0xFUL << 24U);
+    Images[DIO_PB].Afr[1] = (4UL << 4U) | (5UL << 24U);
+    Images[DIO_PB].Moder = (2UL << 18U) | (2UL << 28U);
+
+    DIO_imageApply(Images, DIO_MAX_PORT);
+
+    TEST_ASSERT_EQUAL_HEX32(AFR_FILL, GPIOB->AFR[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x75777747UL, GPIOB->AFR[1]);
+    TEST_ASSERT_EQUAL_UINT32(DIO_FUNCTION, TEST_fieldGet(GPIOB->MODER, 9U, 2U));
+    TEST_ASSERT_EQUAL_UINT32(DIO_FUNCTION, TEST_fieldGet(GPIOB->MODER, 14U,
+    2U));
+}
+
+/*****************************************************************************
+ * Function: test_portWriteSetsMaskedPins()
+*//**
+*\b Description:
+ * One write drives the pins of the mask high or low from the value and
+ * leaves the pins out of the mask at their level.
+ *
+*****************************************************************************/
+static void test_portWriteSetsMaskedPins(void)
+{
+    const DioConfig_t Config[] =
+    {
+        {DIO_PC, DIO_PC0, DIO_OUTPUT, DIO_PUSH_PULL, DIO_LOW_SPEED,
+         DIO_NO_RESISTOR, DIO_AF0},
+        {DIO_PC, DIO_PC1, DIO_OUTPUT, DIO_PUSH_PULL, DIO_LOW_SPEED,
+         DIO_NO_RESISTOR, DIO_AF0},
+        {DIO_PC, DIO_PC2, DIO_OUTPUT, DIO_PUSH_PULL, DIO_LOW_SPEED,
+         DIO_NO_RESISTOR, DIO_AF0},
+        {DIO_PC, DIO_PC3, DIO_OUTPUT, DIO_PUSH_PULL, DIO_LOW_SPEED,
+         DIO_NO_RESISTOR, DIO_AF0}
+    };
+
+    DIO_init(Config, sizeof(Config) / sizeof(Config[0]));
+
+    DIO_portWrite(DIO_PC, 0x000FU, 0x0005U);
+    TEST_ASSERT_EQUAL_UINT8(1U, SIM_pinGet(SIM_PORT_C, 0U));
+    TEST_ASSERT_EQUAL_UINT8(0U, SIM_pinGet(SIM_PORT_C, 1U));
+    TEST_ASSERT_EQUAL_UINT8(1U, SIM_pinGet(SIM_PORT_C, 2U));
+    TEST_ASSERT_EQUAL_UINT8(0U, SIM_pinGet(SIM_PORT_C, 3U));
+
+    DIO_portWrite(DIO_PC, 0x0003U, 0x0002U);
+    TEST_ASSERT_EQUAL_UINT8(0U, SIM_pinGet(SIM_PORT_C, 0U));
+    TEST_ASSERT_EQUAL_UINT8(1U, SIM_pinGet(SIM_PORT_C, 1U));
+    TEST_ASSERT_EQUAL_UINT8(1U, SIM_pinGet(SIM_PORT_C, 2U));
+    TEST_ASSERT_EQUAL_UINT8(0U, SIM_pinGet(SIM_PORT_C, 3U));
+    TEST_ASSERT_EQUAL_HEX32(0x0006UL, GPIOC->ODR & 0xFUL);
+}
+
+/*****************************************************************************
+ * Function: TEST_fieldGet()
+*//**
+*\b Description:
+ * This function is used to get the field of a pin in a register.
+ *
+ * @param[in]   reg is the register value.
+ * @param[in]   pin is the pin number.
+ * @param[in]   width is the field width in bits.
+ *
+ * @return  The field value.
+ *
+*****************************************************************************/
+static uint32_t TEST_fieldGet(uint32_t reg, uint8_t pin, uint8_t width)
+{
+    return (reg >> (pin * width)) & ((1UL << width) - 1UL);
+}
+
+int main(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN | RCC_AHB1ENR_GPIOCEN;
+
+    UNITY_BEGIN();
+    RUN_TEST(test_initMuxesHighPins);
+    RUN_TEST(test_initMuxesLowPins);
+    RUN_TEST(test_imageApplyMuxesHighPins);
+    RUN_TEST(test_portWriteSetsMaskedPins);
+    return UNITY_END();
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_main.c
+ * @author Jose Luis Figueroa
+ * @brief The unit tests of the acceleration scaling. The Q15 kernel shifts
+ * two axes per 32 bits word and masks the bits the low axis carries into
+ * the high one, so it is checked against a per-axis reference over the
+ * whole raw range of every range and resolution, with the two axes of a
+ * word of opposite signs, and on known vectors at the full scale limits
+ * and around zero. The Q31 and float kernels are checked on vectors.
+ * @version 1.0
+ * @date 2026-10-16
+ *
+ * @copyright Copyright (c) 2025 Jose Luis Figueroa. MIT License.
+ *
+ */
+/*****************************************************************************
+* Includes
+*****************************************************************************/
+#include <unity.h>
+#include "scale.h"
+
+/*****************************************************************************
+* Module Preprocessor Constants
+*****************************************************************************/
+/** Axes in one sample*/
+#define AXES                (3U)
+/** Axes of a FIFO block, odd so the last axis takes the scalar path*/
+#define BLOCK_AXES          (FIFO_MAX_ENTRIES * AXES)
+/** Fraction bits of a Q15 value of +-SCALE_FULL_SCALE_G*/
+#define Q15_ONE_G_SHIFT     (11U)
+
+/*****************************************************************************
+* Function Prototypes
+*****************************************************************************/
+static void TEST_q15Block(const int16_t * const raw, Adxl345Range_t Range,
+Adxl345Resolution_t Resolution);
+
+/*****************************************************************************
+* Function Definitions
+*****************************************************************************/
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+/*****************************************************************************
+ * Function: test_q15SweepsEveryRawValue()
+*//**
+*\b Description:
+ * Every raw value a range and resolution can produce is converted, the
+ * sweep taken from both ends at once so each word pairs a negative and a
+ * positive axis until the middle, where the signs cross.
+ *
+*****************************************************************************/
+static void test_q15SweepsEveryRawValue(void)
+{
+    for(uint8_t resolution = 0; resolution < ADXL345_MAX_RESOLUTION;
+    resolution++)
+    {
+        for(uint8_t range = 0; range < ADXL345_MAX_RANGE; range++)
+        {
+            /*10 bits mode, or 10 to 13 bits in full resolution*/
+            const uint8_t bits = (uint8_t)((resolution == ADXL345_FULL_RES) ?
+            (10U + range) : 10U);
+            const int32_t min = -(1L << (bits - 1U));
+            const int32_t max = (1L << (bits - 1U)) - 1L;
+            const uint32_t values = 1UL << bits;
+            int16_t raw[BLOCK_AXES];
+            uint32_t filled = 0;
+
+            for(uint32_t i = 0; i < values; i++)
+            {
+                raw[filled] = (int16_t)(((i % 2U) == 0U) ? (min + (i / 2U)) :
+                (max - (i / 2U)));
+                filled++;
+
+                if((filled == BLOCK_AXES) || ((i + 1U) == values))
+                {
+                    /*Pad the last block with zeros*/
+                    while(filled < BLOCK_AXES)
+                    {
+                        raw[filled] = 0;
+                        filled++;
+                    }
+                    TEST_q15Block(raw, (Adxl345Range_t)range,
+                    (Adxl345Resolution_t)resolution);
+                    filled = 0;
+                }
+            }
+        }
+    }
+}
+
+/*****************************************************************************
+ * Function: test_q15CarryMaskFullResolution()
+*//**
+*\b Description:
+ * At +-16 g full resolution the shift is 3: a negative low axis carries
+ * three ones into the high axis, which the mask must clear, and the 13
+ * bits limits reach the ends of the Q15 range.
+ *
+*****************************************************************************/
+static void test_q15CarryMaskFullResolution(void)
+{
+    const Adxl345Sample_t Samples[] =
+    {
+        {.x = -1, .y = 0, .z = -4096},
+        {.x = 4095, .y = -4096, .z = 1},
+        {.x = -2, .y = -1, .z = 0}
+    };
+    const int16_t expected[] =
+    {
+        -8, 0, -32768,
+        32760, -32768, 8,
+        -16, -8, 0
+    };
+    int16_t out[sizeof(expected) / sizeof(expected[0])];
+
+    SCALE_toQ15(Samples, out, sizeof(Samples) / sizeof(Samples[0]),
+    ADXL345_RANGE_16G, ADXL345_FULL_RES);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected, out,
+    sizeof(expected) / sizeof(expected[0]));
+}
+
+/*****************************************************************************
+ * Function: test_q15CarryMask10Bit()
+*//**
+*\b Description:
+ * At +-16 g in 10 bits mode the shift is 6, the widest carry. The 10 bits
+ * limits land on -16 g and one LSB below +16 g.
+ *
+*****************************************************************************/
+static void test_q15CarryMask10Bit(void)
+{
+    const Adxl345Sample_t Samples[] =
+    {
+        {.x = -512, .y = 511, .z = -1},
+        {.x = 1, .y = -2, .z = 0}
+    };
+    const int16_t expected[] =
+    {
+        -32768, 32704, -64,
+        64, -128, 0
+    };
+    int16_t out[sizeof(expected) / sizeof(expected[0])];
+
+    SCALE_toQ15(Samples, out, sizeof(Samples) / sizeof(Samples[0]),
+    ADXL345_RANGE_16G, ADXL345_10BIT);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected, out,
+    sizeof(expected) / sizeof(expected[0]));
+}
+
+/*****************************************************************************
+ * Function: test_q15SingleSampleTail()
+*//**
+*\b Description:
+ * One sample is one word and a tail axis, the tail takes the scalar path
+ * and must give the same result for a negative value.
+ *
+*****************************************************************************/
+static void test_q15SingleSampleTail(void)
+{
+    const Adxl345Sample_t Sample = {.x = 256, .y = -256, .z = -511};
+    int16_t out[AXES] = {0x5555, 0x5555, 0x5555};
+
+    SCALE_toQ15(&Sample, out, 1U, ADXL345_RANGE_2G, ADXL345_10BIT);
+
+    /*256 LSB/g: 1 g is 2048 in Q15 of +-16 g*/
+    TEST_ASSERT_EQUAL_INT16(2048, out[0]);
+    TEST_ASSERT_EQUAL_INT16(-2048, out[1]);
+    TEST_ASSERT_EQUAL_INT16(-4088, out[2]);
+}
+
+/*****************************************************************************
+ * Function: test_q31FullScale()
+*//**
+*\b Description:
+ * The Q31 kernel reaches INT32_MIN at -16 g and keeps the sign of small
+ * values.
+ *
+*****************************************************************************/
+static void test_q31FullScale(void)
+{
+    const Adxl345Sample_t Samples[] =
+    {
+        {.x = -4096, .y = 4095, .z = -1}
+    };
+    int32_t out[AXES];
+
+    SCALE_toQ31(Samples, out, 1U, ADXL345_RANGE_16G, ADXL345_FULL_RES);
+
+    TEST_ASSERT_EQUAL_INT32(INT32_MIN, out[0]);
+    TEST_ASSERT_EQUAL_INT32(4095L * (1L << 19), out[1]);
+    TEST_ASSERT_EQUAL_INT32(-(1L << 19), out[2]);
+}
+
+/*****************************************************************************
+ * Function: test_floatMatchesFactor()
+*//**
+*\b Description:
+ * The float kernel gives g with the exact power of two factor.
+ *
+*****************************************************************************/
+static void test_floatMatchesFactor(void)
+{
+    const Adxl345Sample_t Samples[] =
+    {
+        {.x = 128, .y = -512, .z = 0},
+        {.x = 511, .y = -1, .z = 64}
+    };
+    float out[2U * AXES];
+
+    SCALE_toFloat(Samples, out, 2U, ADXL345_RANGE_4G, ADXL345_10BIT);
+
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, out[0]);
+    TEST_ASSERT_EQUAL_FLOAT(-4.0f, out[1]);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, out[2]);
+    TEST_ASSERT_EQUAL_FLOAT(3.9921875f, out[3]);
+    TEST_ASSERT_EQUAL_FLOAT(-0.0078125f, out[4]);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, out[5]);
+}
+
+/*****************************************************************************
+ * Function: TEST_q15Block()
+*//**
+*\b Description:
+ * This function is used to convert a block of raw axes with the Q15 kernel
+ * and compare it with the per-axis reference raw * 2^shift.
+ *
+ * @param[in]   raw is the block of BLOCK_AXES raw axes.
+ * @param[in]   Range is the measurement range.
+ * @param[in]   Resolution is the output resolution.
+ *
+ * @return  void
+ *
+*****************************************************************************/
+static void TEST_q15Block(const int16_t * const raw, Adxl345Range_t Range,
+Adxl345Resolution_t Resolution)
+{
+    const int32_t gain =
+    1L << (Q15_ONE_G_SHIFT - SCALE_shiftGet(Range, Resolution));
+    Adxl345Sample_t Samples[FIFO_MAX_ENTRIES];
+    int16_t expected[BLOCK_AXES];
+    int16_t out[BLOCK_AXES];
+
+    for(uint32_t i = 0; i < FIFO_MAX_ENTRIES; i++)
+    {
+        Samples[i].x = raw[i * AXES];
+        Samples[i].y = raw[(i * AXES) + 1U];
+        Samples[i].z = raw[(i * AXES) + 2U];
+    }
+    for(uint32_t i = 0; i < BLOCK_AXES; i++)
+    {
+        expected[i] = (int16_t)(raw[i] * gain);
+    }
+
+    SCALE_toQ15(Samples, out, FIFO_MAX_ENTRIES, Range, Resolution);
+
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected, out, BLOCK_AXES);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_q15SweepsEveryRawValue);
+    RUN_TEST(test_q15CarryMaskFullResolution);
+    RUN_TEST(test_q15CarryMask10Bit);
+    RUN_TEST(test_q15SingleSampleTail);
+    RUN_TEST(test_q31FullScale);
+    RUN_TEST(test_floatMatchesFactor);
+    return UNITY_END();
+}